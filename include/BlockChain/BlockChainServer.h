@@ -10,6 +10,8 @@
 #include <P2P/SyncStatus.h>
 #include <Core/Models/DTOs/BlockWithOutputs.h>
 #include <BlockChain/ChainType.h>
+#include <BlockChain/PruningStats.h>
+#include <BlockChain/OrphanPoolStats.h>
 #include <Core/Models/BlockHeader.h>
 #include <Core/Models/FullBlock.h>
 #include <Core/Models/CompactBlock.h>
@@ -20,7 +22,9 @@
 #include <filesystem.h>
 
 #include <vector>
+#include <string>
 #include <memory>
+#include <chrono>
 
 // Forward Declarations
 class Config;
@@ -28,6 +32,7 @@ class IBlockDB;
 class TxHashSetManager;
 class ITransactionPool;
 class SyncStatus;
+class IBlockChainServer;
 
 #ifdef MW_BLOCK_CHAIN
 #define BLOCK_CHAIN_API EXPORT
@@ -35,6 +40,25 @@ class SyncStatus;
 #define BLOCK_CHAIN_API IMPORT
 #endif
 
+//
+// A batch of headers whose cuckoo cycles were checked by IBlockChainServer::VerifyHeaderCycles.
+// Only block chain implementations can create these, so the cycle check can't be skipped by callers.
+//
+class VerifiedHeaders
+{
+public:
+	const std::vector<BlockHeaderPtr>& GetHeaders() const noexcept { return m_headers; }
+
+private:
+	friend class IBlockChainServer;
+
+	VerifiedHeaders(const std::vector<BlockHeaderPtr>& headers) : m_headers(headers) { }
+
+	std::vector<BlockHeaderPtr> m_headers;
+};
+
+typedef std::shared_ptr<const VerifiedHeaders> VerifiedHeadersPtr;
+
 //
 // This interface acts as the single entry-point into the BlockChain shared library.
 // This handles validation and in-memory storage of all block headers, transactions, and UTXOs.
@@ -50,8 +74,15 @@ public:
 	virtual uint64_t GetHeight(const EChainType chainType) const = 0;
 	virtual uint64_t GetTotalDifficulty(const EChainType chainType) const = 0;
 
-	virtual EBlockChainStatus AddBlock(const FullBlock& block) = 0;
-	virtual EBlockChainStatus AddCompactBlock(const CompactBlock& compactBlock) = 0;
+	virtual EBlockChainStatus AddBlock(const FullBlock& block, const std::string& source = "") = 0;
+
+	//
+	// Validates everything in the block that can be checked without the chain state (signatures, rangeproofs, sums, etc).
+	// Blocks that pass are marked as validated, so AddBlock won't check them again.
+	// Safe to call from multiple threads at once, since no locks are taken.
+	//
+	virtual bool VerifyBlockSelfConsistent(const FullBlock& block) const = 0;
+	virtual EBlockChainStatus AddCompactBlock(const CompactBlock& compactBlock, const std::string& source = "") = 0;
 
 	virtual fs::path SnapshotTxHashSet(BlockHeaderPtr pBlockHeader) = 0;
 	virtual EBlockChainStatus ProcessTransactionHashSet(const Hash& blockHash, const fs::path& path, SyncStatus& syncStatus) = 0;
@@ -67,6 +98,19 @@ public:
 	//
 	virtual EBlockChainStatus AddBlockHeaders(const std::vector<BlockHeaderPtr>& blockHeaders) = 0;
 
+	//
+	// Same as AddBlockHeaders, but skips the cuckoo cycles, since VerifyHeaderCycles already checked them.
+	// Everything else, including the difficulty, is still validated.
+	//
+	virtual EBlockChainStatus AddVerifiedBlockHeaders(const VerifiedHeaders& verifiedHeaders) = 0;
+
+	//
+	// Checks the proof of work cycles of the given headers in parallel.
+	// This doesn't depend on the chain state, so it can be done for headers that can't be added yet, in any order.
+	// Returns nullptr if any of the cycles are invalid.
+	//
+	virtual VerifiedHeadersPtr VerifyHeaderCycles(const std::vector<BlockHeaderPtr>& blockHeaders) const = 0;
+
 	//
 	// Returns the block header at the given height.
 	// This will be null if no matching block header is found.
@@ -132,6 +176,29 @@ public:
 	virtual std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t maxNumBlocks) const = 0;
 
 	virtual bool ProcessNextOrphanBlock() = 0;
+
+	//
+	// Blocks until an orphan block may be ready to connect to the confirmed chain (ie. its parent was just applied,
+	// or its header just joined the candidate chain), or until the timeout passes.
+	// Returns true if ProcessNextOrphanBlock should be called.
+	//
+	virtual bool WaitForOrphanBlock(const std::chrono::milliseconds& timeout) = 0;
+
+	//
+	// Returns the progress of the background block pruner (see PruningConfig).
+	//
+	virtual PruningStats GetPruningStats() const = 0;
+
+	//
+	// Returns the size of the orphan block pool, and how often it has had to evict or reject blocks.
+	//
+	virtual OrphanPoolStats GetOrphanPoolStats() const = 0;
+
+protected:
+	static VerifiedHeadersPtr MarkCyclesVerified(const std::vector<BlockHeaderPtr>& blockHeaders)
+	{
+		return VerifiedHeadersPtr(new VerifiedHeaders(blockHeaders));
+	}
 };
 
 typedef std::shared_ptr<IBlockChainServer> IBlockChainServerPtr;
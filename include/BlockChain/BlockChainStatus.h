@@ -9,5 +9,6 @@ enum class EBlockChainStatus
 	ALREADY_EXISTS,
 	NOT_FOUND,
 	INVALID,
-	ORPHANED
+	ORPHANED,
+	ORPHAN_REJECTED // The block is an orphan, but the orphan pool had no room for it.
 };
\ No newline at end of file
@@ -43,6 +43,8 @@ public:
 	std::shared_ptr<const BlockIndex> AddBlock(const Hash& hash);
 	void Rewind(const uint64_t lastHeight);
 
+	void Journal(CommitJournal& journal) const;
+
 	virtual void Commit() override final;
 	virtual void Rollback() noexcept override final;
 	virtual void OnInitWrite() override final;
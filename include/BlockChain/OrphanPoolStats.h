@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+//
+// Size and activity of the pool of blocks that can't be connected to the chain yet.
+//
+struct OrphanPoolStats
+{
+	// Number of orphan blocks currently held.
+	uint64_t numOrphans;
+
+	// Serialized size of the orphan blocks currently held.
+	uint64_t numBytes;
+
+	// Memory budget for the pool (see ChainConfig).
+	uint64_t maxBytes;
+
+	// Number of orphans evicted to make room since the node started.
+	uint64_t numEvicted;
+
+	// Number of orphans turned away since the node started, because they were too large or their peer was over its quota.
+	uint64_t numRejected;
+};
\ No newline at end of file
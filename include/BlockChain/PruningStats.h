@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+//
+// Progress of the background block pruner. All values are zero when pruning is disabled.
+//
+struct PruningStats
+{
+	// Height at or below which full blocks and spent output records have been removed.
+	uint64_t prunedHeight;
+
+	// Number of blocks pruned since the node started.
+	uint64_t blocksPruned;
+
+	// Number of bytes reclaimed since the node started.
+	uint64_t bytesReclaimed;
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+
+//
+// Bounded, lock-free queue for any number of producers and a single consumer.
+// Each slot carries a sequence number that tells producers when it's free and the consumer when it's filled,
+// so pushing and popping never take a lock. Items are moved in and out, never copied.
+//
+// The consumer can block in wait_pop. Producers only touch the mutex to wake it when it's actually waiting.
+//
+template <typename T>
+class MpscQueue
+{
+public:
+	//
+	// Capacity is rounded up to the next power of 2.
+	//
+	explicit MpscQueue(const size_t capacity)
+		: m_mask(RoundUpPow2(capacity) - 1), m_cells(m_mask + 1), m_enqueuePos(0), m_dequeuePos(0), m_consumerWaiting(false), m_closed(false)
+	{
+		for (size_t i = 0; i < m_cells.size(); i++)
+		{
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MpscQueue(const MpscQueue&) = delete;
+	MpscQueue& operator=(const MpscQueue&) = delete;
+
+	size_t capacity() const noexcept { return m_cells.size(); }
+
+	//
+	// Returns false, leaving item untouched, if the queue is full or closed.
+	//
+	bool try_push(T&& item)
+	{
+		if (m_closed.load(std::memory_order_relaxed))
+		{
+			return false;
+		}
+
+		Cell* pCell = nullptr;
+		size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			pCell = &m_cells[pos & m_mask];
+			const size_t sequence = pCell->sequence.load(std::memory_order_acquire);
+			const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+			if (diff == 0)
+			{
+				if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		pCell->data.emplace(std::move(item));
+		pCell->sequence.store(pos + 1, std::memory_order_release);
+
+		// Pairs with the fence in wait_pop. Without it, the release store above can be reordered after
+		// the load below, so the producer sees no waiter while the consumer misses the item and sleeps.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_consumerWaiting.load(std::memory_order_relaxed))
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			lock.unlock();
+			m_itemAdded.notify_one();
+		}
+
+		return true;
+	}
+
+	//
+	// Consumer only. Moves the oldest item out, if there is one.
+	//
+	bool try_pop(T& item)
+	{
+		Cell& cell = m_cells[m_dequeuePos & m_mask];
+		if (cell.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+		{
+			return false;
+		}
+
+		item = std::move(*cell.data);
+		cell.data.reset();
+		cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+		m_dequeuePos++;
+
+		return true;
+	}
+
+	//
+	// Consumer only. Blocks until an item is available, the timeout passes, or the queue is closed.
+	//
+	template<class Rep, class Period>
+	bool wait_pop(T& item, const std::chrono::duration<Rep, Period>& timeout)
+	{
+		if (try_pop(item))
+		{
+			return true;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_consumerWaiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		// Checked again after announcing we're waiting, so a concurrent push either is seen here or wakes us.
+		bool popped = try_pop(item);
+		if (!popped)
+		{
+			m_itemAdded.wait_for(lock, timeout, [this, &item, &popped] {
+				popped = try_pop(item);
+				return popped || m_closed.load(std::memory_order_relaxed);
+			});
+		}
+
+		m_consumerWaiting.store(false, std::memory_order_relaxed);
+		return popped;
+	}
+
+	//
+	// Rejects further pushes and wakes the consumer. Items already queued can still be popped.
+	//
+	void close()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_closed = true;
+		}
+
+		m_itemAdded.notify_all();
+	}
+
+private:
+	static size_t RoundUpPow2(const size_t value)
+	{
+		size_t pow2 = 2;
+		while (pow2 < value)
+		{
+			pow2 <<= 1;
+		}
+
+		return pow2;
+	}
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		std::optional<T> data;
+	};
+
+	const size_t m_mask;
+	std::vector<Cell> m_cells;
+
+	// Kept on separate cache lines, since producers and the consumer update them concurrently.
+	alignas(64) std::atomic<size_t> m_enqueuePos;
+	alignas(64) size_t m_dequeuePos;
+
+	std::mutex m_mutex;
+	std::condition_variable m_itemAdded;
+	std::atomic_bool m_consumerWaiting;
+	std::atomic_bool m_closed;
+};
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <Windows.h>
 #else
 #include <unistd.h>
+#include <fcntl.h>
 #endif
 
 class FileUtil
@@ -193,6 +194,38 @@ public:
 #endif
 	}
 
+	//
+	// Forces the file's written data to disk (fsync).
+	//
+	static bool SyncFile(const fs::path& filePath)
+	{
+#if defined(WIN32)
+		HANDLE hFile = CreateFile(StringUtil::ToWide(filePath.u8string()).c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		const bool success = FlushFileBuffers(hFile);
+
+		CloseHandle(hFile);
+
+		return success;
+#else
+		const int fd = open(filePath.c_str(), O_RDWR);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		const bool success = fsync(fd) == 0;
+
+		close(fd);
+
+		return success;
+#endif
+	}
+
 	static std::vector<std::string> GetSubDirectories(const fs::path& filePath, const bool includeHidden)
 	{
 		std::vector<std::string> listOfFiles;
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <Infrastructure/Logger.h>
+#include <deque>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <exception>
+#include <condition_variable>
+
+//
+// A fixed set of long-lived worker threads, each with its own task deque.
+// Workers take their own newest tasks first, and steal the oldest tasks from other workers when they run out.
+// Tasks submitted from a worker thread go to that worker's deque; all others are distributed round-robin.
+// Tasks that haven't started when the pool is destroyed are discarded.
+// Exceptions thrown by submitted tasks are logged and dropped; ParallelFor rethrows them to the caller instead.
+//
+class WorkStealingPool
+{
+public:
+	using Task = std::function<void()>;
+
+	explicit WorkStealingPool(const size_t numThreads = DefaultNumThreads())
+		: m_numQueued(0), m_nextWorker(0), m_terminate(false)
+	{
+		const size_t numWorkers = (std::max)((size_t)1, numThreads);
+		for (size_t i = 0; i < numWorkers; i++)
+		{
+			m_workers.emplace_back(std::make_unique<Worker>());
+		}
+
+		for (size_t i = 0; i < numWorkers; i++)
+		{
+			m_workers[i]->thread = std::thread([this, i] { Thread_Work(i); });
+		}
+	}
+
+	~WorkStealingPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_terminate = true;
+		}
+
+		m_taskAdded.notify_all();
+
+		for (auto& pWorker : m_workers)
+		{
+			if (pWorker->thread.joinable())
+			{
+				pWorker->thread.join();
+			}
+		}
+	}
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	static size_t DefaultNumThreads()
+	{
+		return (std::max)(1u, std::thread::hardware_concurrency());
+	}
+
+	size_t GetNumThreads() const noexcept { return m_workers.size(); }
+
+	void Submit(Task&& task)
+	{
+		const size_t index = (tl_pPool == this) ? tl_workerIndex : (m_nextWorker++ % m_workers.size());
+		{
+			std::unique_lock<std::mutex> workerLock(m_workers[index]->mutex);
+			m_workers[index]->tasks.push_back(std::move(task));
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_numQueued++;
+		}
+
+		m_taskAdded.notify_one();
+	}
+
+	//
+	// Pool shared by short-lived parallel loops (ie. hashing and PoW verification), so they never spawn threads per call.
+	//
+	static WorkStealingPool& GetShared()
+	{
+		static WorkStealingPool s_pool;
+		return s_pool;
+	}
+
+	//
+	// Calls func(begin, end) over chunks covering [0, count), with each chunk at least minPerChunk long.
+	// Chunks are claimed by the calling thread and by idle workers, and the caller only ever waits on chunks that are
+	// already running, so it's safe to call from anywhere, including from within a task on this pool.
+	// The first exception thrown by func is rethrown once every chunk has finished.
+	//
+	void ParallelFor(const size_t count, const size_t minPerChunk, const std::function<void(const size_t, const size_t)>& func)
+	{
+		const size_t numChunks = (std::min)(GetNumThreads() + 1, count / (std::max)((size_t)1, minPerChunk));
+		if (numChunks <= 1)
+		{
+			func(0, count);
+			return;
+		}
+
+		struct LoopState
+		{
+			std::atomic<size_t> nextChunk{ 0 };
+			size_t numFinished{ 0 };
+			std::exception_ptr pException;
+			std::mutex mutex;
+			std::condition_variable finished;
+		};
+
+		auto pState = std::make_shared<LoopState>();
+		const size_t chunkSize = (count + numChunks - 1) / numChunks;
+
+		// Helpers that start after every chunk was claimed return without touching func, which may no longer exist.
+		auto runChunks = [pState, count, numChunks, chunkSize, &func] {
+			size_t chunk;
+			while ((chunk = pState->nextChunk++) < numChunks)
+			{
+				std::exception_ptr pException;
+				try
+				{
+					const size_t begin = chunk * chunkSize;
+					func(begin, (std::min)(begin + chunkSize, count));
+				}
+				catch (...)
+				{
+					pException = std::current_exception();
+				}
+
+				std::unique_lock<std::mutex> lock(pState->mutex);
+				if (pException != nullptr && pState->pException == nullptr)
+				{
+					pState->pException = pException;
+				}
+
+				if (++pState->numFinished == numChunks)
+				{
+					pState->finished.notify_all();
+				}
+			}
+		};
+
+		for (size_t i = 1; i < numChunks; i++)
+		{
+			Submit(runChunks);
+		}
+
+		runChunks();
+
+		std::unique_lock<std::mutex> lock(pState->mutex);
+		pState->finished.wait(lock, [&pState, numChunks] { return pState->numFinished == numChunks; });
+		if (pState->pException != nullptr)
+		{
+			std::rethrow_exception(pState->pException);
+		}
+	}
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+		std::thread thread;
+	};
+
+	bool TryPop(const size_t index, Task& task)
+	{
+		{
+			Worker& worker = *m_workers[index];
+			std::unique_lock<std::mutex> workerLock(worker.mutex);
+			if (!worker.tasks.empty())
+			{
+				task = std::move(worker.tasks.back());
+				worker.tasks.pop_back();
+				m_numQueued--;
+				return true;
+			}
+		}
+
+		for (size_t i = 1; i < m_workers.size(); i++)
+		{
+			Worker& victim = *m_workers[(index + i) % m_workers.size()];
+			std::unique_lock<std::mutex> victimLock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				m_numQueued--;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void Thread_Work(const size_t index)
+	{
+		tl_pPool = this;
+		tl_workerIndex = index;
+
+		while (true)
+		{
+			Task task;
+			if (TryPop(index, task))
+			{
+				try
+				{
+					task();
+				}
+				catch (std::exception& e)
+				{
+					LOG_ERROR_F("Exception ({}) caught while running task.", e.what());
+				}
+				catch (...)
+				{
+					LOG_ERROR("Unknown exception caught while running task.");
+				}
+
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_taskAdded.wait(lock, [this] { return m_terminate || m_numQueued > 0; });
+			if (m_terminate)
+			{
+				break;
+			}
+		}
+	}
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_taskAdded;
+	std::atomic<int64_t> m_numQueued; // May briefly go negative when a task is taken before it's counted.
+	std::atomic<size_t> m_nextWorker;
+	bool m_terminate;
+
+	static inline thread_local const WorkStealingPool* tl_pPool = nullptr;
+	static inline thread_local size_t tl_workerIndex = 0;
+};
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <json/json.h>
+#include <Config/ConfigProps.h>
+
+class ChainConfig
+{
+public:
+	// When enabled, candidate chain headers are kept in a dense, height-indexed in-memory store,
+	// backed by a compact header file, instead of being looked up through the database.
+	bool IsHeaderStoreEnabled() const { return m_headerStoreEnabled; }
+
+	// Maximum number of consecutive blocks applied in a single chain state commit. 1 disables group commits.
+	uint32_t GetGroupCommitBlocks() const { return m_groupCommitBlocks; }
+
+	// Maximum time a group of blocks may be applied in memory before it's committed.
+	uint32_t GetGroupCommitMillis() const { return m_groupCommitMillis; }
+
+	// Memory budget for blocks that can't be connected yet, in total and for blocks received from any single peer.
+	uint64_t GetMaxOrphanPoolBytes() const { return (uint64_t)m_maxOrphanPoolMB * 1024 * 1024; }
+	uint64_t GetMaxOrphanBytesPerPeer() const { return (uint64_t)m_maxOrphanMBPerPeer * 1024 * 1024; }
+
+	// When disabled, chain files are no longer fsynced around each commit. Commits still survive the node stopping
+	// unexpectedly, but not the OS crashing or losing power, which matches the database's own (unsynced) commits.
+	bool IsSyncCommitsEnabled() const { return m_syncCommits; }
+
+	//
+	// Constructor
+	//
+	ChainConfig(const Json::Value& json)
+	{
+		m_headerStoreEnabled = false;
+		m_groupCommitBlocks = 1;
+		m_groupCommitMillis = 500;
+		m_maxOrphanPoolMB = 256;
+		m_maxOrphanMBPerPeer = 64;
+		m_syncCommits = true;
+
+		if (json.isMember(ConfigProps::Chain::CHAIN))
+		{
+			const Json::Value& chainJSON = json[ConfigProps::Chain::CHAIN];
+
+			if (chainJSON.isMember(ConfigProps::Chain::HEADER_STORE))
+			{
+				m_headerStoreEnabled = chainJSON.get(ConfigProps::Chain::HEADER_STORE, false).asBool();
+			}
+
+			if (chainJSON.isMember(ConfigProps::Chain::GROUP_COMMIT_BLOCKS))
+			{
+				m_groupCommitBlocks = (std::max)(1u, chainJSON.get(ConfigProps::Chain::GROUP_COMMIT_BLOCKS, 1).asUInt());
+			}
+
+			if (chainJSON.isMember(ConfigProps::Chain::GROUP_COMMIT_MS))
+			{
+				m_groupCommitMillis = chainJSON.get(ConfigProps::Chain::GROUP_COMMIT_MS, 500).asUInt();
+			}
+
+			if (chainJSON.isMember(ConfigProps::Chain::MAX_ORPHAN_POOL_MB))
+			{
+				m_maxOrphanPoolMB = (std::max)(1u, chainJSON.get(ConfigProps::Chain::MAX_ORPHAN_POOL_MB, 256).asUInt());
+			}
+
+			if (chainJSON.isMember(ConfigProps::Chain::MAX_ORPHAN_MB_PER_PEER))
+			{
+				m_maxOrphanMBPerPeer = (std::max)(1u, chainJSON.get(ConfigProps::Chain::MAX_ORPHAN_MB_PER_PEER, 64).asUInt());
+			}
+
+			if (chainJSON.isMember(ConfigProps::Chain::SYNC_COMMITS))
+			{
+				m_syncCommits = chainJSON.get(ConfigProps::Chain::SYNC_COMMITS, true).asBool();
+			}
+		}
+	}
+
+private:
+	bool m_headerStoreEnabled;
+	uint32_t m_groupCommitBlocks;
+	uint32_t m_groupCommitMillis;
+	uint32_t m_maxOrphanPoolMB;
+	uint32_t m_maxOrphanMBPerPeer;
+	bool m_syncCommits;
+};
\ No newline at end of file
@@ -14,6 +14,9 @@ namespace ConfigProps
 
 		static const std::string MIN_PEERS = "MIN_PEERS";
 		static const std::string MAX_PEERS = "MAX_PEERS";
+		static const std::string MAX_UPLOAD_KBPS = "MAX_UPLOAD_KBPS";
+		static const std::string MAX_DOWNLOAD_KBPS = "MAX_DOWNLOAD_KBPS";
+		static const std::string MAX_MESSAGES_PER_MIN = "MAX_MESSAGES_PER_MIN";
 	}
 
 	namespace Dandelion
@@ -25,6 +28,28 @@ namespace ConfigProps
 		static const std::string PATIENCE_SECS = "PATIENCE_SECS";
 		static const std::string STEM_PROBABILITY = "STEM_PROBABILITY";
 	}
+
+	namespace Chain
+	{
+		static const std::string CHAIN = "CHAIN";
+
+		static const std::string HEADER_STORE = "HEADER_STORE";
+		static const std::string GROUP_COMMIT_BLOCKS = "GROUP_COMMIT_BLOCKS";
+		static const std::string GROUP_COMMIT_MS = "GROUP_COMMIT_MS";
+		static const std::string MAX_ORPHAN_POOL_MB = "MAX_ORPHAN_POOL_MB";
+		static const std::string MAX_ORPHAN_MB_PER_PEER = "MAX_ORPHAN_MB_PER_PEER";
+		static const std::string SYNC_COMMITS = "SYNC_COMMITS";
+	}
+
+	namespace Pruning
+	{
+		static const std::string PRUNING = "PRUNING";
+
+		static const std::string ENABLED = "ENABLED";
+		static const std::string MARGIN_BLOCKS = "MARGIN_BLOCKS";
+		static const std::string BATCH_SIZE = "BATCH_SIZE";
+		static const std::string INTERVAL_SECS = "INTERVAL_SECS";
+	}
 	
 	namespace Server
 	{
@@ -2,8 +2,10 @@
 
 #include <Common/Util/FileUtil.h>
 #include <Config/DandelionConfig.h>
+#include <Config/ChainConfig.h>
 #include <Config/ClientMode.h>
 #include <Config/P2PConfig.h>
+#include <Config/PruningConfig.h>
 
 #include <cstdint>
 #include <json/json.h>
@@ -16,6 +18,8 @@ public:
 	//
 	const P2PConfig& GetP2P() const { return m_p2pConfig; }
 	const DandelionConfig& GetDandelion() const { return m_dandelion; }
+	const PruningConfig& GetPruning() const { return m_pruning; }
+	const ChainConfig& GetChain() const { return m_chain; }
 	EClientMode GetClientMode() const { return EClientMode::FAST_SYNC; }
 	const fs::path& GetChainPath() const { return m_chainPath; }
 	const fs::path& GetDatabasePath() const { return m_databasePath; }
@@ -25,7 +29,7 @@ public:
 	// Constructor
 	//
 	NodeConfig(const Json::Value& json, const fs::path& dataPath)
-		: m_p2pConfig(json), m_dandelion(json)
+		: m_p2pConfig(json), m_dandelion(json), m_pruning(json), m_chain(json)
 	{
 		const fs::path nodePath = dataPath / "NODE";
 
@@ -50,4 +54,6 @@ private:
 
 	P2PConfig m_p2pConfig;
 	DandelionConfig m_dandelion;
+	PruningConfig m_pruning;
+	ChainConfig m_chain;
 };
\ No newline at end of file
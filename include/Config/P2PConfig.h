@@ -13,6 +13,13 @@ public:
 	int GetMaxConnections() const { return m_maxConnections; }
 	int GetMinConnections() const { return m_minConnections; }
 
+	// Per-peer upload and download limits in kilobytes per second (0 = unlimited).
+	uint32_t GetMaxUploadKBps() const { return m_maxUploadKBps; }
+	uint32_t GetMaxDownloadKBps() const { return m_maxDownloadKBps; }
+
+	// Messages a peer may send per minute before reads from it are throttled (0 = unlimited).
+	uint32_t GetMaxMessagesPerMinute() const { return m_maxMessagesPerMinute; }
+
 	//
 	// Constructor
 	//
@@ -20,6 +27,9 @@ public:
 	{
 		m_maxConnections = 50;
 		m_minConnections = 15;
+		m_maxUploadKBps = 0;
+		m_maxDownloadKBps = 0;
+		m_maxMessagesPerMinute = 500;
 
 		if (json.isMember(ConfigProps::P2P::P2P))
 		{
@@ -34,10 +44,28 @@ public:
 			{
 				m_minConnections = p2pJSON.get(ConfigProps::P2P::MIN_PEERS, 15).asInt();
 			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::MAX_UPLOAD_KBPS))
+			{
+				m_maxUploadKBps = p2pJSON.get(ConfigProps::P2P::MAX_UPLOAD_KBPS, 0).asUInt();
+			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::MAX_DOWNLOAD_KBPS))
+			{
+				m_maxDownloadKBps = p2pJSON.get(ConfigProps::P2P::MAX_DOWNLOAD_KBPS, 0).asUInt();
+			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::MAX_MESSAGES_PER_MIN))
+			{
+				m_maxMessagesPerMinute = p2pJSON.get(ConfigProps::P2P::MAX_MESSAGES_PER_MIN, 500).asUInt();
+			}
 		}
 	}
 
 private:
 	int m_maxConnections;
 	int m_minConnections;
+	uint32_t m_maxUploadKBps;
+	uint32_t m_maxDownloadKBps;
+	uint32_t m_maxMessagesPerMinute;
 };
\ No newline at end of file
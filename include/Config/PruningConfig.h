@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <json/json.h>
+#include <Config/ConfigProps.h>
+
+class PruningConfig
+{
+public:
+	// When enabled, full blocks and spent output records beyond the cut-through horizon are deleted in the background.
+	bool IsEnabled() const { return m_enabled; }
+
+	// Number of blocks beyond the cut-through horizon to keep, as a safety margin for deep reorgs.
+	uint32_t GetMarginBlocks() const { return m_marginBlocks; }
+
+	// Maximum number of blocks to prune in a single batch, to keep the chain state lock short.
+	uint32_t GetBatchSize() const { return m_batchSize; }
+
+	// Prune runs every n secs.
+	uint32_t GetIntervalSeconds() const { return m_intervalSeconds; }
+
+	//
+	// Constructor
+	//
+	PruningConfig(const Json::Value& json)
+	{
+		m_enabled = false;
+		m_marginBlocks = 1440;
+		m_batchSize = 250;
+		m_intervalSeconds = 60;
+
+		if (json.isMember(ConfigProps::Pruning::PRUNING))
+		{
+			const Json::Value& pruningJSON = json[ConfigProps::Pruning::PRUNING];
+
+			if (pruningJSON.isMember(ConfigProps::Pruning::ENABLED))
+			{
+				m_enabled = pruningJSON.get(ConfigProps::Pruning::ENABLED, false).asBool();
+			}
+
+			if (pruningJSON.isMember(ConfigProps::Pruning::MARGIN_BLOCKS))
+			{
+				m_marginBlocks = pruningJSON.get(ConfigProps::Pruning::MARGIN_BLOCKS, 1440).asUInt();
+			}
+
+			if (pruningJSON.isMember(ConfigProps::Pruning::BATCH_SIZE))
+			{
+				m_batchSize = (std::max)(1u, pruningJSON.get(ConfigProps::Pruning::BATCH_SIZE, 250).asUInt());
+			}
+
+			if (pruningJSON.isMember(ConfigProps::Pruning::INTERVAL_SECS))
+			{
+				m_intervalSeconds = pruningJSON.get(ConfigProps::Pruning::INTERVAL_SECS, 60).asUInt();
+			}
+		}
+	}
+
+private:
+	bool m_enabled;
+	uint32_t m_marginBlocks;
+	uint32_t m_batchSize;
+	uint32_t m_intervalSeconds;
+};
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <Core/Exceptions/GrinException.h>
+#include <Common/Util/StringUtil.h>
 
 #define TXHASHSET_EXCEPTION(msg) TxHashSetException(msg, __func__)
+#define TXHASHSET_EXCEPTION_F(msg, ...) TxHashSetException(StringUtil::Format(msg, __VA_ARGS__), __func__)
 
 class TxHashSetException : public GrinException
 {
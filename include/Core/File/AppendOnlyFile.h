@@ -8,12 +8,14 @@
 #include <mio/mmap.hpp>
 #pragma warning(pop)
 
+#include <Core/File/CommitJournal.h>
 #include <Core/Exceptions/FileException.h>
 #include <Infrastructure/Logger.h>
 #include <Common/Util/FileUtil.h>
 #include <stdint.h>
 #include <string>
 #include <vector>
+#include <algorithm>
 
 #ifdef _WIN32
 #define MPATH_STR m_path.wstring()
@@ -91,12 +93,16 @@ public:
 
 		m_mmap.unmap();
 
-		if (m_fileSize > m_bufferIndex)
+		// A CommitJournal may have already written (and synced) the pending appends.
+		const uint64_t diskSize = FileUtil::GetFileSize(m_path);
+		const bool writtenAhead = m_fileSize == m_bufferIndex && !m_buffer.empty() && diskSize == GetSize();
+
+		if (!writtenAhead && diskSize > m_bufferIndex)
 		{
 			FileUtil::TruncateFile(m_path, m_bufferIndex);
 		}
 
-		if (!m_buffer.empty())
+		if (!writtenAhead && !m_buffer.empty())
 		{
 			std::ofstream file(m_path, std::ios::out | std::ios::binary | std::ios::app);
 			if (!file.is_open())
@@ -133,6 +139,25 @@ public:
 		return true;
 	}
 
+	//
+	// Records the writes Flush() would perform, without performing them.
+	// Plain appends can be written ahead of the commit. Appends following a Rewind can't, since they overwrite committed bytes.
+	//
+	void Journal(CommitJournal& journal) const
+	{
+		if (m_fileSize == m_bufferIndex)
+		{
+			if (!m_buffer.empty())
+			{
+				journal.AddWriteAhead(m_path, m_bufferIndex, m_buffer);
+			}
+		}
+		else
+		{
+			journal.AddAppend(m_path, m_bufferIndex, m_buffer);
+		}
+	}
+
 	void Append(const std::vector<unsigned char>& data)
 	{
 		m_buffer.insert(m_buffer.end(), data.cbegin(), data.cend());
@@ -191,6 +216,47 @@ public:
 		return true;
 	}
 
+	//
+	// Returns a pointer into the mapped file for the given range, or nullptr if any of it is still pending.
+	// The pointer is only valid until the next Flush.
+	//
+	const unsigned char* GetView(const uint64_t position, const uint64_t numBytes) const noexcept
+	{
+		if (position + numBytes > m_bufferIndex)
+		{
+			return nullptr;
+		}
+
+		return (const unsigned char*)m_mmap.data() + position;
+	}
+
+	//
+	// Copies numBytes starting at position directly into pData, which must have room for numBytes.
+	// The range may span both the mapped file and the pending buffer.
+	//
+	bool Read(const uint64_t position, const uint64_t numBytes, unsigned char* pData) const
+	{
+		if (position + numBytes > GetSize())
+		{
+			return false;
+		}
+
+		uint64_t bytesRead = 0;
+		if (position < m_bufferIndex)
+		{
+			bytesRead = (std::min)(numBytes, m_bufferIndex - position);
+			std::copy(m_mmap.cbegin() + position, m_mmap.cbegin() + position + bytesRead, pData);
+		}
+
+		if (bytesRead < numBytes)
+		{
+			const uint64_t firstBufferIndex = position + bytesRead - m_bufferIndex;
+			std::copy(m_buffer.cbegin() + firstBufferIndex, m_buffer.cbegin() + firstBufferIndex + (numBytes - bytesRead), pData + bytesRead);
+		}
+
+		return true;
+	}
+
 private:
 	fs::path m_path;
 	uint64_t m_bufferIndex;
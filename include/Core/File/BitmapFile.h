@@ -1,13 +1,15 @@
 #pragma once
 
+#include <Core/File/CommitJournal.h>
 #include <Core/Traits/Batchable.h>
 #include <Roaring.h>
 #include <Common/Util/BitUtil.h>
 #include <fstream>
 #include <functional>
 #include <algorithm>
-#include <map>
+#include <vector>
 #include <memory>
+#include <mutex>
 
 #ifdef _WIN32
 #define MPATH_STR m_path.wstring()
@@ -40,38 +42,57 @@ public:
 
 	void Commit() final
 	{
-		if (!m_modifiedBytes.empty())
+		if (HasModifiedBytes())
 		{
 			m_mmap.unmap();
 
 			std::ofstream file(m_path.c_str(), std::ios_base::binary | std::ios_base::out | std::ios_base::in);
 
-			for (auto iter : m_modifiedBytes)
-			{
-				file.seekp(iter.first);
-				file.write((const char*)&iter.second, 1);
-			}
+			// Contiguous modified bytes are written as a single run, instead of 1 write per byte.
+			ForEachModifiedRun([&file](const uint64_t position, const uint8_t* pBytes, const size_t numBytes) {
+				file.seekp(position);
+				file.write((const char*)pBytes, numBytes);
+			});
 
 			file.close();
+			if (file.fail())
+			{
+				LOG_ERROR_F("Failed to write to {}", m_path);
+				throw FILE_EXCEPTION_F("Failed to write to {}", m_path);
+			}
 
 			std::error_code error;
 			m_mmap = mio::make_mmap_source(MPATH_STR, error);
 			if (error.value() != 0)
 			{
-				// TODO: Handle this
+				LOG_ERROR_F("Failed to mmap file: {}", error.value());
+				throw FILE_EXCEPTION_F("Failed to mmap file: {}", m_path);
 			}
 
-			m_modifiedBytes.clear();
-			SetDirty(false);
+			ClearModifiedBytes();
 		}
+
+		SetDirty(false);
 	}
 
 	void Rollback() noexcept final
 	{
-		m_modifiedBytes.clear();
+		if (HasModifiedBytes())
+		{
+			InvalidateRank(m_modifiedBegin);
+		}
+
+		ClearModifiedBytes();
 		SetDirty(false);
 	}
 
+	void Journal(CommitJournal& journal) const
+	{
+		ForEachModifiedRun([this, &journal](const uint64_t position, const uint8_t* pBytes, const size_t numBytes) {
+			journal.AddWrite(m_path, position, std::vector<unsigned char>(pBytes, pBytes + numBytes));
+		});
+	}
+
 	bool IsSet(const uint64_t leafIndex) const
 	{
 		return GetByte(leafIndex / 8) & BitToByte(leafIndex % 8);
@@ -82,7 +103,7 @@ public:
 		SetDirty(true);
 		uint8_t byte = GetByte(leafIndex / 8);
 		byte |= BitToByte(leafIndex % 8);
-		m_modifiedBytes[leafIndex / 8] = byte;
+		SetModifiedByte(leafIndex / 8, byte);
 	}
 
 	void Set(const Roaring& positionsToSet)
@@ -98,7 +119,7 @@ public:
 		SetDirty(true);
 		uint8_t byte = GetByte(leafIndex / 8);
 		byte &= (0xff ^ BitToByte(leafIndex % 8));
-		m_modifiedBytes[leafIndex / 8] = byte;
+		SetModifiedByte(leafIndex / 8, byte);
 	}
 
 	void Unset(const Roaring& positionsToUnset)
@@ -128,17 +149,25 @@ public:
 		}
 	}
 
-	Roaring ToRoaring() const
+	//
+	// Converts the set leaves below maxLeaves to a Roaring bitmap of (1-based) PMMR positions.
+	//
+	Roaring ToRoaring(const uint64_t maxLeaves = UINT64_MAX) const
 	{
 		Roaring bitmap;
 
-		const uint64_t numBytes = GetNumBytes();
+		const uint64_t numBytes = (std::min)(GetNumBytes(), maxLeaves / 8 + 1);
 		for (uint32_t i = 0; i < (uint32_t)numBytes; i++)
 		{
 			const uint8_t byte = GetByte(i);
+			if (byte == 0)
+			{
+				continue;
+			}
+
 			for (uint8_t j = 0; j < 8; j++)
 			{
-				if ((byte & BitToByte(j)) > 0)
+				if ((byte & BitToByte(j)) > 0 && ((uint64_t)i * 8) + j < maxLeaves)
 				{
 					bitmap.add((uint32_t)(MMRUtil::GetPMMRIndex((i * 8) + j) + 1));
 				}
@@ -148,12 +177,121 @@ public:
 		return bitmap;
 	}
 
+	//
+	// Returns the number of set leaves below leafIndex.
+	//
+	uint64_t Rank(const uint64_t leafIndex) const
+	{
+		const uint64_t byteIndex = leafIndex / 8;
+		const uint64_t block = byteIndex / RANK_BLOCK_BYTES;
+
+		std::unique_lock<std::mutex> lock(m_rankMutex);
+		if (block >= BuildRankIndex())
+		{
+			return m_rankIndex.back();
+		}
+
+		uint64_t rank = m_rankIndex[block];
+		for (uint64_t i = block * RANK_BLOCK_BYTES; i < byteIndex; i++)
+		{
+			rank += BitUtil::CountBitsSet(GetByte(i));
+		}
+
+		// Bits are numbered from the left, so the leaves below leafIndex are the high bits of the byte.
+		const uint8_t bit = leafIndex % 8;
+		if (bit > 0)
+		{
+			rank += BitUtil::CountBitsSet(GetByte(byteIndex) >> (8 - bit));
+		}
+
+		return rank;
+	}
+
+	//
+	// Returns the index of the set leaf with the given rank (ie. the (rank + 1)th set leaf), or UINT64_MAX if there are fewer set leaves.
+	//
+	uint64_t Select(const uint64_t rank) const
+	{
+		std::unique_lock<std::mutex> lock(m_rankMutex);
+		BuildRankIndex();
+
+		if (rank >= m_rankIndex.back())
+		{
+			return UINT64_MAX;
+		}
+
+		// Find the last block with fewer than (rank + 1) set leaves before it.
+		const auto iter = std::upper_bound(m_rankIndex.cbegin(), m_rankIndex.cend(), rank);
+		const uint64_t block = (uint64_t)std::distance(m_rankIndex.cbegin(), iter) - 1;
+
+		uint64_t remaining = rank - m_rankIndex[block];
+		for (uint64_t byteIndex = block * RANK_BLOCK_BYTES; ; byteIndex++)
+		{
+			const uint8_t byte = GetByte(byteIndex);
+			const uint8_t count = BitUtil::CountBitsSet(byte);
+			if (remaining < count)
+			{
+				for (uint8_t j = 0; j < 8; j++)
+				{
+					if ((byte & BitToByte(j)) > 0 && remaining-- == 0)
+					{
+						return (byteIndex * 8) + j;
+					}
+				}
+			}
+
+			remaining -= count;
+		}
+	}
+
+	//
+	// Returns up to maxLeaves set leaves, in order, starting at startIndex and below endIndex.
+	// Blocks with no set leaves are skipped using the rank index, so the cost is proportional to the number of leaves returned,
+	// rather than the number of unset leaves in the range.
+	//
+	std::vector<uint64_t> GetSetLeaves(const uint64_t startIndex, const uint64_t endIndex, const uint64_t maxLeaves) const
+	{
+		std::vector<uint64_t> leaves;
+
+		std::unique_lock<std::mutex> lock(m_rankMutex);
+		const uint64_t numBlocks = BuildRankIndex();
+
+		uint64_t byteIndex = startIndex / 8;
+		while (leaves.size() < maxLeaves && byteIndex * 8 < endIndex)
+		{
+			const uint64_t block = byteIndex / RANK_BLOCK_BYTES;
+			if (block >= numBlocks)
+			{
+				break;
+			}
+
+			if (m_rankIndex[block + 1] == m_rankIndex[block])
+			{
+				byteIndex = (block + 1) * RANK_BLOCK_BYTES;
+				continue;
+			}
+
+			const uint8_t byte = GetByte(byteIndex);
+			for (uint8_t j = 0; j < 8 && byte != 0; j++)
+			{
+				const uint64_t leafIndex = (byteIndex * 8) + j;
+				if ((byte & BitToByte(j)) > 0 && leafIndex >= startIndex && leafIndex < endIndex && leaves.size() < maxLeaves)
+				{
+					leaves.push_back(leafIndex);
+				}
+			}
+
+			++byteIndex;
+		}
+
+		return leaves;
+	}
+
 	uint8_t GetByte(const uint64_t byteIndex) const
 	{
-		auto iter = m_modifiedBytes.find(byteIndex);
-		if (iter != m_modifiedBytes.cend())
+		if (IsModified(byteIndex))
 		{
-			return iter->second;
+			return m_modifiedBytes[byteIndex];
 		}
 		else if (byteIndex < m_mmap.size())
 		{
@@ -164,7 +302,130 @@ public:
 	}
 
 private:
-	BitmapFile(const fs::path& path) : m_path(path), m_size(0) { }
+	BitmapFile(const fs::path& path) : m_path(path), m_modifiedBegin(0), m_modifiedEnd(0), m_size(0), m_rankIndex(1, 0) { }
+
+	//
+	// Rank index: m_rankIndex[b] is the number of set bits in the bytes before block b (RANK_BLOCK_BYTES bytes per block),
+	// and the last entry is the total number of set bits.
+	// Entries are rebuilt lazily, starting from the lowest block modified since they were last built.
+	// Caller must hold m_rankMutex. Returns the number of blocks covered by the index.
+	//
+	static constexpr uint64_t RANK_BLOCK_BYTES = 64;
+
+	uint64_t BuildRankIndex() const
+	{
+		const uint64_t numBlocks = (GetNumBytes() + RANK_BLOCK_BYTES - 1) / RANK_BLOCK_BYTES;
+		if (m_rankValidBlocks > numBlocks || m_rankIndex.size() != numBlocks + 1)
+		{
+			m_rankValidBlocks = (std::min)(m_rankValidBlocks, numBlocks);
+			m_rankIndex.resize(numBlocks + 1);
+		}
+
+		for (uint64_t block = m_rankValidBlocks; block < numBlocks; block++)
+		{
+			uint64_t count = 0;
+			for (uint64_t i = block * RANK_BLOCK_BYTES; i < (block + 1) * RANK_BLOCK_BYTES; i++)
+			{
+				const uint8_t byte = GetByte(i);
+				if (byte != 0)
+				{
+					count += BitUtil::CountBitsSet(byte);
+				}
+			}
+
+			m_rankIndex[block + 1] = m_rankIndex[block] + count;
+		}
+
+		m_rankValidBlocks = numBlocks;
+		return numBlocks;
+	}
+
+	//
+	// Invalidates the rank index entries that count bytes at or after byteIndex.
+	//
+	void InvalidateRank(const uint64_t byteIndex)
+	{
+		std::unique_lock<std::mutex> lock(m_rankMutex);
+		m_rankValidBlocks = (std::min)(m_rankValidBlocks, byteIndex / RANK_BLOCK_BYTES);
+	}
+
+	//
+	// Modified bytes are tracked with a flat bitset (1 bit per byte of the bitmap) over a flat buffer of their new values.
+	// Both are sized to the highest modified byte and only grow, so they're reused across commits.
+	// [m_modifiedBegin, m_modifiedEnd) bounds the bytes modified since the last commit.
+	//
+	bool HasModifiedBytes() const noexcept { return m_modifiedBegin < m_modifiedEnd; }
+
+	bool IsModified(const uint64_t byteIndex) const noexcept
+	{
+		return byteIndex >= m_modifiedBegin && byteIndex < m_modifiedEnd
+			&& (m_modifiedFlags[byteIndex / 64] >> (byteIndex % 64)) & 1;
+	}
+
+	void SetModifiedByte(const uint64_t byteIndex, const uint8_t byte)
+	{
+		if (byteIndex >= m_modifiedBytes.size())
+		{
+			m_modifiedBytes.resize((std::max)(byteIndex + 1, (uint64_t)m_modifiedBytes.size() * 2));
+			m_modifiedFlags.resize((m_modifiedBytes.size() + 63) / 64);
+		}
+
+		m_modifiedBytes[byteIndex] = byte;
+		m_modifiedFlags[byteIndex / 64] |= (uint64_t)1 << (byteIndex % 64);
+		InvalidateRank(byteIndex);
+
+		if (HasModifiedBytes())
+		{
+			m_modifiedBegin = (std::min)(m_modifiedBegin, byteIndex);
+			m_modifiedEnd = (std::max)(m_modifiedEnd, byteIndex + 1);
+		}
+		else
+		{
+			m_modifiedBegin = byteIndex;
+			m_modifiedEnd = byteIndex + 1;
+		}
+	}
+
+	void ClearModifiedBytes() noexcept
+	{
+		if (HasModifiedBytes())
+		{
+			std::fill(
+				m_modifiedFlags.begin() + (m_modifiedBegin / 64),
+				m_modifiedFlags.begin() + ((m_modifiedEnd + 63) / 64),
+				0
+			);
+		}
+
+		m_modifiedBegin = 0;
+		m_modifiedEnd = 0;
+	}
+
+	//
+	// Calls func(position, pBytes, numBytes) for each run of contiguous modified bytes, in order.
+	//
+	void ForEachModifiedRun(const std::function<void(const uint64_t, const uint8_t*, const size_t)>& func) const
+	{
+		uint64_t byteIndex = m_modifiedBegin;
+		while (byteIndex < m_modifiedEnd)
+		{
+			if (!IsModified(byteIndex))
+			{
+				// Skip whole words with no modified bytes.
+				const uint64_t word = m_modifiedFlags[byteIndex / 64] >> (byteIndex % 64);
+				byteIndex = (word == 0) ? (byteIndex / 64 + 1) * 64 : byteIndex + 1;
+				continue;
+			}
+
+			const uint64_t runStart = byteIndex;
+			while (byteIndex < m_modifiedEnd && IsModified(byteIndex))
+			{
+				++byteIndex;
+			}
+
+			func(runStart, m_modifiedBytes.data() + runStart, (size_t)(byteIndex - runStart));
+		}
+	}
 
 	void Load()
 	{
@@ -253,9 +514,9 @@ private:
 	uint64_t GetNumBytes() const
 	{
 		size_t size = 0;
-		if (!m_modifiedBytes.empty())
+		if (HasModifiedBytes())
 		{
-			size = m_modifiedBytes.crbegin()->first + 1;
+			size = m_modifiedEnd;
 		}
 
 		if (!m_mmap.empty())
@@ -281,10 +542,17 @@ private:
 	}
 
 	fs::path m_path;
-	std::map<uint64_t, uint8_t> m_modifiedBytes;
+	std::vector<uint8_t> m_modifiedBytes;
+	std::vector<uint64_t> m_modifiedFlags;
+	uint64_t m_modifiedBegin;
+	uint64_t m_modifiedEnd;
 	mio::mmap_source m_mmap;
 	uint64_t m_size;
 
+	mutable std::mutex m_rankMutex;
+	mutable std::vector<uint64_t> m_rankIndex;
+	mutable uint64_t m_rankValidBlocks{ 0 };
+
 	static const bool s_true{ false };
 	static const bool s_false{ false };
 };
\ No newline at end of file
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <Core/Exceptions/FileException.h>
+#include <Core/Serialization/Serializer.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Traits/Serializable.h>
+#include <Common/Util/FileUtil.h>
+#include <Infrastructure/Logger.h>
+#include <filesystem.h>
+#include <fstream>
+#include <cstdint>
+#include <vector>
+#include <set>
+#include <algorithm>
+
+//
+// Journal describing every file write of a single ChainState commit.
+//
+// Appends to the end of a file are written (and synced) ahead of the commit, so only the file's old and new sizes
+// are journaled for them. Everything else (bitmap bytes written in place, appends following a rewind) can't be
+// written until the commit succeeds, so those writes are journaled in full. They're small and rare in comparison.
+//
+// The journal is stored twice: durably, before anything is written ahead ("pending"), and again in the same database
+// transaction as the commit's database changes. After an unclean shutdown:
+//  - If only the pending journal is present, the commit never happened, and Revert() truncates the written-ahead appends.
+//  - If the committed journal is present, Apply() rolls the files forward to the committed state.
+// Every write is positional, so applying or reverting a journal more than once has no additional effect.
+//
+class CommitJournal : public Traits::ISerializable
+{
+	enum class EWriteType : uint8_t
+	{
+		// Bytes overwritten in place.
+		WRITE = 0,
+		// Bytes written starting at 'position', with the file truncated to 'position' first.
+		APPEND = 1,
+		// Bytes appended at 'position' before the commit. Only their size is serialized.
+		WRITTEN_AHEAD = 2
+	};
+
+	struct FileWrite
+	{
+		std::string path;
+		EWriteType type;
+		uint64_t position;
+		uint64_t size;
+		std::vector<unsigned char> bytes;
+	};
+
+public:
+	CommitJournal() = default;
+	virtual ~CommitJournal() = default;
+
+	bool IsEmpty() const noexcept { return m_writes.empty(); }
+	size_t GetNumWrites() const noexcept { return m_writes.size(); }
+
+	// True if any appends are written ahead of the commit, so there's something to revert if it never happens.
+	bool HasWritesAhead() const noexcept
+	{
+		return std::any_of(
+			m_writes.cbegin(), m_writes.cend(),
+			[](const FileWrite& write) { return write.type == EWriteType::WRITTEN_AHEAD; }
+		);
+	}
+
+	// True if any writes are only performed after the commit, so there's something to replay if they're interrupted.
+	bool HasPostCommitWrites() const noexcept
+	{
+		return std::any_of(
+			m_writes.cbegin(), m_writes.cend(),
+			[](const FileWrite& write) { return write.type != EWriteType::WRITTEN_AHEAD; }
+		);
+	}
+
+	//
+	// Records bytes appended to the end of a file that's already 'position' bytes long.
+	// The bytes are written by WriteAhead(), so they're never serialized.
+	//
+	void AddWriteAhead(const fs::path& path, const uint64_t position, const std::vector<unsigned char>& bytes)
+	{
+		m_writes.push_back(FileWrite{ path.u8string(), EWriteType::WRITTEN_AHEAD, position, bytes.size(), bytes });
+	}
+
+	//
+	// Records the pending contents of an append-only file: everything from 'position' onwards is replaced by 'bytes'.
+	//
+	void AddAppend(const fs::path& path, const uint64_t position, const std::vector<unsigned char>& bytes)
+	{
+		m_writes.push_back(FileWrite{ path.u8string(), EWriteType::APPEND, position, bytes.size(), bytes });
+	}
+
+	//
+	// Records bytes overwritten in place (eg. a run of modified bitmap bytes).
+	//
+	void AddWrite(const fs::path& path, const uint64_t position, std::vector<unsigned char>&& bytes)
+	{
+		const uint64_t size = bytes.size();
+		m_writes.push_back(FileWrite{ path.u8string(), EWriteType::WRITE, position, size, std::move(bytes) });
+	}
+
+	//
+	// Appends the bytes recorded by AddWriteAhead, syncing them unless sync is false.
+	// Must only be called once the pending journal is stored, and before the commit.
+	//
+	void WriteAhead(const bool sync = true) const
+	{
+		for (const FileWrite& write : m_writes)
+		{
+			if (write.type != EWriteType::WRITTEN_AHEAD)
+			{
+				continue;
+			}
+
+			const fs::path path = FileUtil::ToPath(write.path);
+			CreateIfMissing(path);
+			TruncateTo(path, write.position);
+
+			WriteBytes(path, write.position, write.bytes);
+
+			if (sync && !FileUtil::SyncFile(path))
+			{
+				throw FILE_EXCEPTION_F("Failed to sync {}", path);
+			}
+		}
+	}
+
+	//
+	// Rolls every recorded file forward to the state described by the journal.
+	//
+	void Apply() const
+	{
+		for (const FileWrite& write : m_writes)
+		{
+			const fs::path path = FileUtil::ToPath(write.path);
+			CreateIfMissing(path);
+
+			if (write.type == EWriteType::WRITTEN_AHEAD)
+			{
+				// The bytes were synced before the commit, so the file can only ever be too long.
+				TruncateTo(path, write.position + write.size);
+				continue;
+			}
+
+			if (write.type == EWriteType::APPEND)
+			{
+				TruncateTo(path, write.position);
+			}
+
+			WriteBytes(path, write.position, write.bytes);
+		}
+	}
+
+	//
+	// Undoes the writes performed by WriteAhead(), for a commit that never happened.
+	//
+	void Revert() const
+	{
+		for (const FileWrite& write : m_writes)
+		{
+			const fs::path path = FileUtil::ToPath(write.path);
+			if (write.type == EWriteType::WRITTEN_AHEAD && FileUtil::Exists(path) && FileUtil::GetFileSize(path) > write.position)
+			{
+				if (!FileUtil::TruncateFile(path, write.position))
+				{
+					throw FILE_EXCEPTION_F("Failed to truncate {}", path);
+				}
+			}
+		}
+	}
+
+	//
+	// Syncs every file written after the commit, so the journal can safely be discarded.
+	//
+	void Sync() const
+	{
+		std::set<std::string> synced;
+		for (const FileWrite& write : m_writes)
+		{
+			if (write.type != EWriteType::WRITTEN_AHEAD && synced.insert(write.path).second)
+			{
+				const fs::path path = FileUtil::ToPath(write.path);
+				if (!FileUtil::SyncFile(path))
+				{
+					throw FILE_EXCEPTION_F("Failed to sync {}", path);
+				}
+			}
+		}
+	}
+
+	//
+	// Serialization/Deserialization
+	//
+	void Serialize(Serializer& serializer) const noexcept final
+	{
+		serializer.Append<uint64_t>(m_writes.size());
+		for (const FileWrite& write : m_writes)
+		{
+			serializer.AppendVarStr(write.path);
+			serializer.Append<uint8_t>((uint8_t)write.type);
+			serializer.Append<uint64_t>(write.position);
+			serializer.Append<uint64_t>(write.size);
+			if (write.type != EWriteType::WRITTEN_AHEAD)
+			{
+				serializer.AppendByteVector(write.bytes);
+			}
+		}
+	}
+
+	static CommitJournal Deserialize(ByteBuffer& byteBuffer)
+	{
+		CommitJournal journal;
+
+		const uint64_t numWrites = byteBuffer.ReadU64();
+		for (uint64_t i = 0; i < numWrites; i++)
+		{
+			FileWrite write;
+			write.path = byteBuffer.ReadVarStr();
+
+			const uint8_t type = byteBuffer.ReadU8();
+			if (type > (uint8_t)EWriteType::WRITTEN_AHEAD)
+			{
+				throw DeserializationException(StringUtil::Format("Unknown journal write type {}", type), __func__);
+			}
+
+			write.type = (EWriteType)type;
+			write.position = byteBuffer.ReadU64();
+			write.size = byteBuffer.ReadU64();
+			if (write.type != EWriteType::WRITTEN_AHEAD)
+			{
+				write.bytes = byteBuffer.ReadVector(write.size);
+			}
+
+			journal.m_writes.emplace_back(std::move(write));
+		}
+
+		return journal;
+	}
+
+private:
+	static void CreateIfMissing(const fs::path& path)
+	{
+		if (!FileUtil::Exists(path))
+		{
+			std::ofstream outFile(path, std::ios::out | std::ios::binary | std::ios::app);
+			if (!outFile.is_open())
+			{
+				LOG_ERROR_F("Failed to create file: {}", path);
+				throw FILE_EXCEPTION_F("Failed to create file: {}", path);
+			}
+		}
+	}
+
+	// Truncates the file to 'size' bytes, which it must already be at least as long as.
+	static void TruncateTo(const fs::path& path, const uint64_t size)
+	{
+		const uint64_t fileSize = FileUtil::GetFileSize(path);
+		if (fileSize < size)
+		{
+			LOG_ERROR_F("File {} is {} bytes, but journal expects at least {}", path, fileSize, size);
+			throw FILE_EXCEPTION_F("Unable to apply journal to {}", path);
+		}
+
+		if (fileSize > size && !FileUtil::TruncateFile(path, size))
+		{
+			throw FILE_EXCEPTION_F("Failed to truncate {}", path);
+		}
+	}
+
+	static void WriteBytes(const fs::path& path, const uint64_t position, const std::vector<unsigned char>& bytes)
+	{
+		if (bytes.empty())
+		{
+			return;
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::out | std::ios::in);
+		if (!file.is_open())
+		{
+			throw FILE_EXCEPTION_F("Failed to open {}", path);
+		}
+
+		file.seekp(position, std::ios::beg);
+		file.write((const char*)bytes.data(), bytes.size());
+		file.close();
+
+		if (file.fail())
+		{
+			throw FILE_EXCEPTION_F("Failed to write to {}", path);
+		}
+	}
+
+	std::vector<FileWrite> m_writes;
+};
\ No newline at end of file
@@ -44,6 +44,14 @@ public:
 		SetDirty(false);
 	}
 
+	void Journal(CommitJournal& journal) const
+	{
+		if (IsDirty())
+		{
+			m_pFile->Journal(journal);
+		}
+	}
+
 	void Rewind(const uint64_t size)
 	{
 		SetDirty(true);
@@ -69,6 +77,18 @@ public:
 		return data;
 	}
 
+	//
+	// Reads count consecutive entries starting at position into data, reusing its capacity.
+	//
+	void GetDataRange(const uint64_t position, const uint64_t count, std::vector<unsigned char>& data) const
+	{
+		data.resize(count * NUM_BYTES);
+		if (!m_pFile->Read(position * NUM_BYTES, count * NUM_BYTES, data.data()))
+		{
+			throw FILE_EXCEPTION(StringUtil::Format("Failed to read {} entries at position {}", count, position));
+		}
+	}
+
 	void AddData(const std::vector<unsigned char>& data)
 	{
 		SetDirty(true);
@@ -83,6 +83,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const final;
+	size_t GetSerializedSize() const final;
 	static BlockHeader Deserialize(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 	std::vector<unsigned char> GetPreProofOfWork() const;
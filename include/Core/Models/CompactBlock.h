@@ -59,6 +59,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const;
+	size_t GetSerializedSize() const;
 	static CompactBlock Deserialize(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 
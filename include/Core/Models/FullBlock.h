@@ -99,6 +99,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const final;
+	size_t GetSerializedSize() const final;
 	static FullBlock Deserialize(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 
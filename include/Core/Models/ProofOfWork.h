@@ -41,6 +41,7 @@ public:
 	////////////////////////////////////////
 
 	void Serialize(Serializer& serializer) const;
+	size_t GetSerializedSize() const;
 	static ProofOfWork Deserialize(ByteBuffer& byteBuffer);
 
 	////////////////////////////////////////
@@ -42,6 +42,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const;
+	size_t GetSerializedSize() const;
 	static ShortId Deserialize(ByteBuffer& byteBuffer);
 
 	//
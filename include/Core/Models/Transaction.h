@@ -56,6 +56,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const;
+	size_t GetSerializedSize() const;
 	static Transaction Deserialize(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 	static Transaction FromJSON(const Json::Value& transactionJSON);
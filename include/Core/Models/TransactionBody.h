@@ -49,6 +49,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const;
+	size_t GetSerializedSize() const;
 	static TransactionBody Deserialize(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 	static TransactionBody FromJSON(const Json::Value& transactionBodyJSON);
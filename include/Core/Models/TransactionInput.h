@@ -54,6 +54,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const;
+	size_t GetSerializedSize() const;
 	static TransactionInput Deserialize(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 	static TransactionInput FromJSON(const Json::Value& transactionInputJSON);
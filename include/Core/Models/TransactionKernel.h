@@ -58,6 +58,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const final;
+	size_t GetSerializedSize() const final;
 	static TransactionKernel Deserialize(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 	static TransactionKernel FromJSON(const Json::Value& transactionKernelJSON);
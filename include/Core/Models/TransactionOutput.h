@@ -55,6 +55,7 @@ public:
 	// Serialization/Deserialization
 	//
 	void Serialize(Serializer& serializer) const;
+	size_t GetSerializedSize() const;
 	static TransactionOutput Deserialize(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 	static TransactionOutput FromJSON(const Json::Value& transactionOutputJSON);
@@ -16,39 +16,52 @@
 
 #include <Crypto/BigInteger.h>
 
+//
+// Reads serialized data from a borrowed view of bytes, which must outlive the ByteBuffer.
+// Nothing is copied until a value is read, so messages can be deserialized straight from the buffer they were received into.
+//
 class ByteBuffer
 {
 public:
 	ByteBuffer(const std::vector<unsigned char>& bytes)
-		: m_index(0), m_bytes(bytes)
+		: m_index(0), m_pBytes(bytes.data()), m_size(bytes.size())
 	{
 
 	}
 
+	ByteBuffer(const unsigned char* pBytes, const size_t numBytes)
+		: m_index(0), m_pBytes(pBytes), m_size(numBytes)
+	{
+
+	}
+
+	// Takes ownership of the bytes, since an rvalue can't be borrowed.
 	ByteBuffer(std::vector<unsigned char>&& bytes)
-		: m_index(0), m_bytes(std::move(bytes))
+		: m_index(0), m_owned(std::move(bytes)), m_pBytes(m_owned.data()), m_size(m_owned.size())
 	{
 
 	}
 
+	ByteBuffer(const ByteBuffer&) = delete;
+	ByteBuffer& operator=(const ByteBuffer&) = delete;
+
 	template<class T>
 	void ReadBigEndian(T& t)
 	{
-		if (m_index + sizeof(T) > m_bytes.size())
+		if (m_index + sizeof(T) > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION();
 		}
 
 		if (EndianHelper::IsBigEndian())
 		{
-			memcpy(&t, &m_bytes[m_index], sizeof(T));
+			memcpy(&t, m_pBytes + m_index, sizeof(T));
 		}
 		else
 		{
-			std::vector<unsigned char> temp;
-			temp.resize(sizeof(T));
-			std::reverse_copy(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + sizeof(T), temp.begin());
-			memcpy(&t, &temp[0], sizeof(T));
+			unsigned char temp[sizeof(T)];
+			std::reverse_copy(m_pBytes + m_index, m_pBytes + m_index + sizeof(T), temp);
+			memcpy(&t, temp, sizeof(T));
 		}
 
 		m_index += sizeof(T);
@@ -57,21 +70,20 @@ public:
 	template<class T>
 	void ReadLittleEndian(T& t)
 	{
-		if (m_index + sizeof(T) > m_bytes.size())
+		if (m_index + sizeof(T) > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION();
 		}
 
 		if (EndianHelper::IsBigEndian())
 		{
-			std::vector<unsigned char> temp;
-			temp.resize(sizeof(T));
-			std::reverse_copy(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + sizeof(T), temp.begin());
-			memcpy(&t, &temp[0], sizeof(T));
+			unsigned char temp[sizeof(T)];
+			std::reverse_copy(m_pBytes + m_index, m_pBytes + m_index + sizeof(T), temp);
+			memcpy(&t, temp, sizeof(T));
 		}
 		else
 		{
-			memcpy(&t, &m_bytes[m_index], sizeof(T));
+			memcpy(&t, m_pBytes + m_index, sizeof(T));
 		}
 
 		m_index += sizeof(T);
@@ -157,26 +169,26 @@ public:
 			return "";
 		}
 
-		if (m_index + stringLength > m_bytes.size())
+		if (m_index + stringLength > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION();
 		}
 
-		std::vector<unsigned char> temp(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + stringLength);
+		const size_t index = m_index;
 		m_index += stringLength;
 
-		return std::string((char*)&temp[0], stringLength);
+		return std::string((const char*)m_pBytes + index, stringLength);
 	}
 
 	template<size_t NUM_BYTES>
 	CBigInteger<NUM_BYTES> ReadBigInteger()
 	{
-		if (m_index + NUM_BYTES > m_bytes.size())
+		if (m_index + NUM_BYTES > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION();
 		}
 
-		std::vector<unsigned char> data(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + NUM_BYTES);
+		std::vector<unsigned char> data(m_pBytes + m_index, m_pBytes + m_index + NUM_BYTES);
 
 		m_index += NUM_BYTES;
 
@@ -185,7 +197,7 @@ public:
 
 	std::vector<unsigned char> ReadVector(const uint64_t numBytes)
 	{
-		if (m_index + numBytes > m_bytes.size())
+		if (m_index + numBytes > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION();
 		}
@@ -193,13 +205,13 @@ public:
 		const size_t index = m_index;
 		m_index += numBytes;
 
-		return std::vector<unsigned char>(m_bytes.cbegin() + index, m_bytes.cbegin() + index + numBytes);
+		return std::vector<unsigned char>(m_pBytes + index, m_pBytes + index + numBytes);
 	}
 
 	template<size_t T>
 	std::array<uint8_t, T> ReadArray()
 	{
-		if (m_index + T > m_bytes.size())
+		if (m_index + T > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION();
 		}
@@ -208,16 +220,18 @@ public:
 		m_index += T;
 
 		std::array<uint8_t, T> arr;
-		std::copy(m_bytes.begin() + index, m_bytes.begin() + index + T, arr.begin());
+		std::copy(m_pBytes + index, m_pBytes + index + T, arr.begin());
 		return arr;
 	}
 
 	size_t GetRemainingSize() const
 	{
-		return m_bytes.size() - m_index;
+		return m_size - m_index;
 	}
 
 private:
 	size_t m_index;
-	const std::vector<unsigned char>& m_bytes;
-};
+	std::vector<unsigned char> m_owned;
+	const unsigned char* m_pBytes;
+	size_t m_size;
+};
\ No newline at end of file
@@ -8,7 +8,13 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstring>
 
+//
+// Appends big-endian (unless otherwise specified) serialized data to a byte buffer.
+// Integers are written in place, so when the buffer is reserved up front (eg. using a model's GetSerializedSize()),
+// serializing allocates nothing beyond that one buffer.
+//
 class Serializer
 {
 public:
@@ -18,34 +24,38 @@ public:
 		m_serialized.reserve(expectedSize);
 	}
 
+	//
+	// Appends to a caller-provided buffer, eg. one that's reused or already holds a record header.
+	// Use Release() to take the buffer back.
+	//
+	Serializer(std::vector<unsigned char>&& buffer)
+		: m_serialized(std::move(buffer))
+	{
+
+	}
+
 	template <class T>
 	void Append(const T& t)
 	{
-		std::vector<unsigned char> temp(sizeof(T));
-		memcpy(&temp[0], &t, sizeof(T));
+		const size_t offset = m_serialized.size();
+		m_serialized.resize(offset + sizeof(T));
+		memcpy(&m_serialized[offset], &t, sizeof(T));
 
-		if (EndianHelper::IsBigEndian())
-		{
-			m_serialized.insert(m_serialized.end(), temp.cbegin(), temp.cend());
-		}
-		else
+		if (!EndianHelper::IsBigEndian())
 		{
-			m_serialized.insert(m_serialized.end(), temp.crbegin(), temp.crend());
+			std::reverse(m_serialized.begin() + offset, m_serialized.end());
 		}
 	}
 	template <class T>
 	void AppendLittleEndian(const T& t)
 	{
-		std::vector<unsigned char> temp(sizeof(T));
-		memcpy(&temp[0], &t, sizeof(T));
+		const size_t offset = m_serialized.size();
+		m_serialized.resize(offset + sizeof(T));
+		memcpy(&m_serialized[offset], &t, sizeof(T));
 
 		if (EndianHelper::IsBigEndian())
 		{
-			m_serialized.insert(m_serialized.end(), temp.crbegin(), temp.crend());
-		}
-		else
-		{
-			m_serialized.insert(m_serialized.end(), temp.cbegin(), temp.cend());
+			std::reverse(m_serialized.begin() + offset, m_serialized.end());
 		}
 	}
 
@@ -76,6 +86,15 @@ public:
 
 	const std::vector<unsigned char>& GetBytes() const { return m_serialized; }
 
+	// Moves the serialized bytes out of the Serializer, leaving it empty.
+	// The buffer is cleared explicitly, since the state of a moved-from vector is unspecified.
+	std::vector<unsigned char> Release()
+	{
+		std::vector<unsigned char> serialized = std::move(m_serialized);
+		m_serialized.clear();
+		return serialized;
+	}
+
 	const unsigned char* data() const { return m_serialized.data(); }
 	size_t size() const { return m_serialized.size(); }
 
@@ -14,11 +14,22 @@ namespace Traits
 		//
 		virtual void Serialize(Serializer& serializer) const = 0;
 
+		//
+		// Number of bytes Serialize will append.
+		// Models that are serialized often calculate this directly, so buffers can be allocated once, up front.
+		//
+		virtual size_t GetSerializedSize() const
+		{
+			Serializer serializer;
+			Serialize(serializer);
+			return serializer.size();
+		}
+
 		std::vector<unsigned char> Serialized() const
 		{
 			Serializer serializer;
 			Serialize(serializer);
-			return serializer.GetBytes();
+			return serializer.Release();
 		}
 
 		virtual std::vector<unsigned char> SerializeWithIndex(const uint64_t index) const
@@ -26,7 +37,7 @@ namespace Traits
 			Serializer serializer;
 			serializer.Append<uint64_t>(index);
 			Serialize(serializer);
-			return serializer.GetBytes();
+			return serializer.Release();
 		}
 	};
 }
\ No newline at end of file
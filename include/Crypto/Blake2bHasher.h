@@ -0,0 +1,45 @@
+#pragma once
+
+// Copyright (c) 2018-2019 David Burkett
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#include <Common/ImportExport.h>
+#include <Crypto/BigInteger.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef MW_CRYPTO
+#define CRYPTO_API EXPORT
+#else
+#define CRYPTO_API IMPORT
+#endif
+
+//
+// Incremental, unkeyed Blake2b hasher producing 32 byte hashes.
+// Data is written directly from raw pointers, and the state lives inside the object,
+// so hashing allocates nothing on the heap. Use this in hot loops instead of building a Serializer for Crypto::Blake2b.
+//
+class CRYPTO_API Blake2bHasher
+{
+public:
+	static const size_t OUTPUT_SIZE = 32;
+
+	Blake2bHasher();
+
+	Blake2bHasher& Write(const unsigned char* data, const size_t len);
+
+	//
+	// Writes the value in big-endian byte order, matching Serializer::Append<uint64_t>.
+	//
+	Blake2bHasher& WriteU64(const uint64_t value);
+
+	void Finalize(unsigned char hash[OUTPUT_SIZE]);
+	CBigInteger<32> Finalize();
+
+	Blake2bHasher& Reset();
+
+private:
+	// Storage for the third-party blake2b_state, which isn't exposed outside of the Crypto module.
+	alignas(8) unsigned char m_state[256];
+};
\ No newline at end of file
@@ -46,6 +46,22 @@ public:
 		const std::vector<unsigned char>& input
 	);
 
+	//
+	// Uses Blake2b to hash each of the given inputs into a 32 byte hash.
+	// Short inputs (<= 128 bytes) are hashed several at a time using SIMD when the CPU supports it.
+	//
+	static std::vector<CBigInteger<32>> Blake2bMulti(const std::vector<std::vector<unsigned char>>& inputs);
+
+	//
+	// Same as above, but reading the inputs from, and writing each 32 byte hash to, raw pointers.
+	//
+	static void Blake2bMulti(
+		const unsigned char* const* pInputs,
+		const size_t* pInputLengths,
+		unsigned char* const* pOutputs,
+		const size_t count
+	);
+
 	//
 	// Uses SHA256 to hash the given input into a 32 byte hash.
 	//
@@ -52,6 +52,8 @@ public:
 		serializer.AppendByteVector(m_proofBytes);
 	}
 
+	size_t GetSerializedSize() const final { return 8 + m_proofBytes.size(); }
+
 	static RangeProof Deserialize(ByteBuffer& byteBuffer)
 	{
 		const uint64_t proofSize = byteBuffer.ReadU64();
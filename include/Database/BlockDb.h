@@ -8,7 +8,9 @@
 #include <Core/Models/OutputLocation.h>
 #include <Core/Models/SpentOutput.h>
 #include <Core/Traits/Batchable.h>
+#include <Core/File/CommitJournal.h>
 #include <unordered_map>
+#include <map>
 #include <memory>
 
 class IBlockDB : public Traits::IBatchable
@@ -36,4 +38,41 @@ public:
 	virtual void AddSpentPositions(const Hash& blockHash, const std::vector<SpentOutput>& outputPositions) = 0;
 	virtual std::unordered_map<Commitment, OutputLocation> GetSpentPositions(const Hash& blockHash) const = 0;
 	virtual void ClearSpentPositions() = 0;
+
+	//
+	// Returns every block file containing only blocks below prunedHeight, mapped to the hashes of all blocks stored in it.
+	// Walking the files is the expensive part of pruning, so this only reads, and can be called without a write lock.
+	//
+	virtual std::map<uint32_t, std::vector<Hash>> GetPrunableBlockFiles(const uint64_t prunedHeight) const = 0;
+
+	//
+	// Deletes the full blocks and spent output records for the given block hashes,
+	// along with the given block files (and the index rows of every block in them) that are still prunable at prunedHeight.
+	// The files are deleted when the batch commits. Returns the (approximate) number of bytes reclaimed.
+	//
+	virtual uint64_t PruneBlocks(
+		const std::vector<Hash>& blockHashes,
+		const std::map<uint32_t, std::vector<Hash>>& blockFiles,
+		const uint64_t prunedHeight
+	) = 0;
+
+	//
+	// Stores the journal outside of the current batch, before any of its appends are written ahead.
+	// If it's still present (without a committed journal) when the database is next opened, the appends are reverted.
+	// When sync is false, the journal only survives the process stopping, not the OS crashing.
+	//
+	virtual void SavePendingJournal(const CommitJournal& journal, const bool sync) = 0;
+
+	//
+	// Stores the journal of file writes belonging to the current batch, so it's committed atomically with it.
+	// Any journal still present when the database is next opened is replayed before the files are loaded.
+	// Journals without post-commit writes have nothing to replay, so only the pending journal is removed for them.
+	//
+	virtual void SaveCommitJournal(const CommitJournal& journal) = 0;
+
+	//
+	// Deletes the committed journal once its writes are synced.
+	// The delete is written straight away, outside of the batch, which has already committed.
+	//
+	virtual void ClearCommitJournal() = 0;
 };
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//
+// A pool of receive buffers, grouped into power-of-two size classes.
+// Buffers are returned to the pool when released, so reading a stream of similarly sized messages doesn't allocate.
+// Buffers larger than the largest size class, or released once the pool already holds maxPooledBytes, are simply freed.
+//
+class BufferPool : public std::enable_shared_from_this<BufferPool>
+{
+	struct Releaser
+	{
+		std::weak_ptr<BufferPool> m_pPool;
+
+		void operator()(std::vector<unsigned char>* pBuffer) const
+		{
+			std::shared_ptr<BufferPool> pPool = m_pPool.lock();
+			if (pPool != nullptr)
+			{
+				pPool->Release(pBuffer);
+			}
+			else
+			{
+				delete pBuffer;
+			}
+		}
+	};
+
+public:
+	typedef std::unique_ptr<std::vector<unsigned char>, Releaser> Buffer;
+
+	static constexpr size_t MIN_CLASS_SIZE = 4 * 1024;
+	static constexpr size_t NUM_CLASSES = 12; // 4KB - 8MB
+
+	static std::shared_ptr<BufferPool> Create(const size_t maxPooledBytes)
+	{
+		return std::shared_ptr<BufferPool>(new BufferPool(maxPooledBytes));
+	}
+
+	//
+	// Returns a buffer resized to exactly numBytes. Its capacity is the size class, so contents are undefined.
+	//
+	Buffer Acquire(const size_t numBytes)
+	{
+		const size_t sizeClass = GetSizeClass(numBytes);
+
+		std::vector<unsigned char>* pBuffer = nullptr;
+		if (sizeClass < NUM_CLASSES)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			std::vector<std::vector<unsigned char>*>& freeBuffers = m_freeBuffers[sizeClass];
+			if (!freeBuffers.empty())
+			{
+				pBuffer = freeBuffers.back();
+				freeBuffers.pop_back();
+				m_pooledBytes -= pBuffer->capacity();
+			}
+		}
+
+		if (pBuffer == nullptr)
+		{
+			pBuffer = new std::vector<unsigned char>();
+			pBuffer->reserve(sizeClass < NUM_CLASSES ? (MIN_CLASS_SIZE << sizeClass) : numBytes);
+		}
+
+		pBuffer->resize(numBytes);
+		return Buffer(pBuffer, Releaser{ weak_from_this() });
+	}
+
+	//
+	// Wraps a buffer that didn't come from a pool. It will be freed normally when released.
+	//
+	static Buffer Wrap(std::vector<unsigned char>&& bytes)
+	{
+		return Buffer(new std::vector<unsigned char>(std::move(bytes)), Releaser{});
+	}
+
+	size_t GetPooledBytes() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_pooledBytes;
+	}
+
+	~BufferPool()
+	{
+		for (auto& freeBuffers : m_freeBuffers)
+		{
+			for (std::vector<unsigned char>* pBuffer : freeBuffers)
+			{
+				delete pBuffer;
+			}
+		}
+	}
+
+private:
+	BufferPool(const size_t maxPooledBytes)
+		: m_maxPooledBytes(maxPooledBytes), m_pooledBytes(0)
+	{
+
+	}
+
+	// Returns NUM_CLASSES if the buffer is too large to be pooled.
+	static size_t GetSizeClass(const size_t numBytes)
+	{
+		size_t sizeClass = 0;
+		while (sizeClass < NUM_CLASSES && (MIN_CLASS_SIZE << sizeClass) < numBytes)
+		{
+			sizeClass++;
+		}
+
+		return sizeClass;
+	}
+
+	void Release(std::vector<unsigned char>* pBuffer)
+	{
+		const size_t sizeClass = GetSizeClass(pBuffer->capacity());
+		if (sizeClass < NUM_CLASSES && pBuffer->capacity() == (MIN_CLASS_SIZE << sizeClass))
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			std::vector<std::vector<unsigned char>*>& freeBuffers = m_freeBuffers[sizeClass];
+			if (m_pooledBytes + pBuffer->capacity() <= m_maxPooledBytes)
+			{
+				freeBuffers.push_back(pBuffer);
+				m_pooledBytes += pBuffer->capacity();
+				return;
+			}
+		}
+
+		delete pBuffer;
+	}
+
+	const size_t m_maxPooledBytes;
+
+	mutable std::mutex m_mutex;
+	size_t m_pooledBytes;
+	std::vector<std::vector<unsigned char>*> m_freeBuffers[NUM_CLASSES];
+};
+
+typedef std::shared_ptr<BufferPool> BufferPoolPtr;
\ No newline at end of file
@@ -1,71 +1,118 @@
 #pragma once
 
-#include <Common/Util/TimeUtil.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
-#include <queue>
 
+//
+// Counts messages and bytes sent and received, in total and over the last minute.
+// The last minute is tracked in a ring of one-second buckets, so recording traffic never allocates.
+//
 class RateCounter
 {
 public:
+	struct Totals
+	{
+		uint64_t messages;
+		uint64_t bytes;
+	};
+
 	RateCounter() = default;
 	~RateCounter() = default;
 
 	RateCounter(const RateCounter& other)
 	{
-		m_received = other.m_received;
-		m_sent = other.m_sent;
+		std::unique_lock<std::mutex> lock(other.m_mutex);
+		m_buckets = other.m_buckets;
+		m_sentTotals = other.m_sentTotals;
+		m_receivedTotals = other.m_receivedTotals;
 	}
 
-	void AddMessageReceived()
+	void AddSent(const uint64_t numBytes, const uint64_t numMessages)
 	{
-		std::unique_lock<std::mutex> lock(m_receivedMutex);
-		m_received.push(TimeUtil::Now());
+		std::unique_lock<std::mutex> lock(m_mutex);
+		Bucket& bucket = GetCurrentBucket();
+		bucket.sent.messages += numMessages;
+		bucket.sent.bytes += numBytes;
+		m_sentTotals.messages += numMessages;
+		m_sentTotals.bytes += numBytes;
 	}
 
-	void AddMessageSent()
+	void AddReceived(const uint64_t numBytes, const uint64_t numMessages)
 	{
-		std::unique_lock<std::mutex> lock(m_sentMutex);
-		m_sent.push(TimeUtil::Now());
+		std::unique_lock<std::mutex> lock(m_mutex);
+		Bucket& bucket = GetCurrentBucket();
+		bucket.received.messages += numMessages;
+		bucket.received.bytes += numBytes;
+		m_receivedTotals.messages += numMessages;
+		m_receivedTotals.bytes += numBytes;
 	}
 
-	size_t GetReceivedInLastMinute()
+	Totals GetSentInLastMinute() const { return SumLastMinute(&Bucket::sent); }
+	Totals GetReceivedInLastMinute() const { return SumLastMinute(&Bucket::received); }
+
+	Totals GetTotalSent() const
 	{
-		std::unique_lock<std::mutex> lock(m_receivedMutex);
-		std::time_t minuteAgo = time(nullptr) - 60;
-		while (!m_received.empty())
-		{
-			if (minuteAgo <= m_received.front())
-			{
-				break;
-			}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_sentTotals;
+	}
+
+	Totals GetTotalReceived() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_receivedTotals;
+	}
+
+private:
+	static constexpr size_t NUM_BUCKETS = 60;
 
-			m_received.pop();
+	struct Bucket
+	{
+		int64_t second;
+		Totals sent;
+		Totals received;
+	};
+
+	static int64_t GetCurrentSecond()
+	{
+		return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Caller must hold m_mutex.
+	Bucket& GetCurrentBucket()
+	{
+		const int64_t second = GetCurrentSecond();
+		Bucket& bucket = m_buckets[second % NUM_BUCKETS];
+		if (bucket.second != second)
+		{
+			bucket = Bucket{ second, Totals{ 0, 0 }, Totals{ 0, 0 } };
 		}
 
-		return m_received.size();
+		return bucket;
 	}
 
-	size_t GetSentInLastMinute()
+	Totals SumLastMinute(Totals Bucket::* pDirection) const
 	{
-		std::unique_lock<std::mutex> lock(m_sentMutex);
-		std::time_t minuteAgo = time(nullptr) - 60;
-		while (!m_sent.empty())
+		const int64_t second = GetCurrentSecond();
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		Totals totals{ 0, 0 };
+		for (const Bucket& bucket : m_buckets)
 		{
-			if (minuteAgo <= m_sent.front())
+			if (bucket.second > second - (int64_t)NUM_BUCKETS)
 			{
-				break;
+				totals.messages += (bucket.*pDirection).messages;
+				totals.bytes += (bucket.*pDirection).bytes;
 			}
-
-			m_sent.pop();
 		}
 
-		return m_sent.size();
+		return totals;
 	}
 
-private:
-	std::mutex m_receivedMutex;
-	std::queue<std::time_t> m_received;
-
-	std::mutex m_sentMutex;
-	std::queue<std::time_t> m_sent;
+	mutable std::mutex m_mutex;
+	std::array<Bucket, NUM_BUCKETS> m_buckets = {};
+	Totals m_sentTotals = { 0, 0 };
+	Totals m_receivedTotals = { 0, 0 };
 };
\ No newline at end of file
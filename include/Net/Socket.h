@@ -8,17 +8,37 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <functional>
 #include <shared_mutex>
 #include <asio.hpp>
 
-class Socket : public Traits::IPrintable
+//
+// Sockets must be owned by a std::shared_ptr, since pending asynchronous operations keep the socket alive.
+//
+class Socket : public Traits::IPrintable, public std::enable_shared_from_this<Socket>
 {
 public:
+	typedef std::function<void(const asio::error_code&, const size_t)> IOHandler;
+	typedef asio::strand<asio::io_context::executor_type> Strand;
+
 	Socket(const SocketAddress& address);
 	virtual ~Socket();
 
+	//
+	// Connects to the socket's address on the given context, which must already be running on another thread.
+	//
 	bool Connect(std::shared_ptr<asio::io_context> pContext);
-	bool Accept(std::shared_ptr<asio::io_context> pContext, asio::ip::tcp::acceptor& acceptor, const std::atomic_bool& terminate);
+
+	//
+	// Accepts the next connection on the acceptor, running acceptorContext until a connection is accepted or terminate is set.
+	// The accepted socket lives on pContext.
+	//
+	bool Accept(
+		std::shared_ptr<asio::io_context> pContext,
+		asio::io_context& acceptorContext,
+		asio::ip::tcp::acceptor& acceptor,
+		const std::atomic_bool& terminate
+	);
 
 	bool CloseSocket();
 	bool IsSocketOpen() const;
@@ -29,7 +49,7 @@ public:
 	inline const SocketAddress& GetSocketAddress() const { return m_address; }
 	inline const IPAddress& GetIPAddress() const { return m_address.GetIPAddress(); }
 	inline uint16_t GetPort() const { return m_address.GetPortNumber(); }
-	inline RateCounter& GetRateCounter() { return m_rateCounter; }
+	inline const std::shared_ptr<RateCounter>& GetRateCounter() const { return m_pRateCounter; }
 
 	bool SetReceiveTimeout(const unsigned long milliseconds);
 	inline unsigned long GetReceiveTimeout() const { return m_receiveTimeout; }
@@ -48,6 +68,14 @@ public:
 	bool HasReceivedData();
 	bool Receive(const size_t numBytes, const bool incrementCount, std::vector<unsigned char>& data);
 
+	//
+	// Asynchronous versions of Send and Receive. The handler is called on the given strand once all bytes
+	// have been transferred, or an error occurs. The caller must not start a second read (or write) until the first completes,
+	// and must only call these (and CloseSocket, once they're in use) from that same strand.
+	//
+	void AsyncSend(const Strand& strand, std::shared_ptr<const std::vector<unsigned char>> pMessage, const bool incrementCount, const IOHandler& handler);
+	void AsyncReceive(const Strand& strand, unsigned char* pBuffer, const size_t numBytes, const bool incrementCount, const IOHandler& handler);
+
 private:
 	std::shared_ptr<asio::ip::tcp::socket> m_pSocket;
 	std::shared_ptr<asio::io_context> m_pContext;
@@ -57,7 +85,7 @@ private:
 	unsigned long m_receiveTimeout;
 	unsigned long m_sendTimeout;
 	int m_receiveBufferSize;
-	RateCounter m_rateCounter;
+	std::shared_ptr<RateCounter> m_pRateCounter;
 
 	mutable std::shared_mutex m_mutex;
 	asio::error_code m_errorCode;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+//
+// A token bucket for throttling a stream of messages or bytes.
+// Tokens refill at a fixed rate up to the bucket's capacity. Consuming more tokens than are available is allowed,
+// so a single large message is never rejected, but the caller should then wait the returned delay before continuing.
+// A rate of 0 means unlimited. Not thread-safe.
+//
+class TokenBucket
+{
+public:
+	TokenBucket(const double tokensPerSecond, const double capacity)
+		: m_tokensPerSecond(tokensPerSecond),
+		m_capacity(capacity),
+		m_tokens(capacity),
+		m_lastRefill(std::chrono::steady_clock::now())
+	{
+
+	}
+
+	bool IsLimited() const { return m_tokensPerSecond > 0; }
+
+	//
+	// Removes the tokens from the bucket, and returns how long to wait until the bucket is no longer in debt.
+	//
+	std::chrono::milliseconds Consume(const double numTokens)
+	{
+		if (!IsLimited())
+		{
+			return std::chrono::milliseconds(0);
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		const double elapsedSeconds = std::chrono::duration<double>(now - m_lastRefill).count();
+		m_tokens = (std::min)(m_capacity, m_tokens + (elapsedSeconds * m_tokensPerSecond));
+		m_lastRefill = now;
+
+		m_tokens -= numTokens;
+		if (m_tokens >= 0)
+		{
+			return std::chrono::milliseconds(0);
+		}
+
+		return std::chrono::milliseconds((int64_t)std::ceil((-m_tokens * 1000.0) / m_tokensPerSecond));
+	}
+
+private:
+	double m_tokensPerSecond;
+	double m_capacity;
+	double m_tokens;
+	std::chrono::steady_clock::time_point m_lastRefill;
+};
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <P2P/Peer.h>
 #include <P2P/Direction.h>
+#include <P2P/ConnectionStats.h>
 #include <Core/Traits/Printable.h>
 
 class ConnectedPeer : public Traits::IPrintable
@@ -13,7 +14,7 @@ public:
 
 	}
 	ConnectedPeer(const ConnectedPeer& peer)
-		: m_pPeer(peer.m_pPeer), m_direction(peer.m_direction), m_portNumber(peer.m_portNumber), m_totalDifficulty(peer.m_totalDifficulty.load()), m_height(peer.m_height.load())
+		: m_pPeer(peer.m_pPeer), m_direction(peer.m_direction), m_portNumber(peer.m_portNumber), m_totalDifficulty(peer.m_totalDifficulty.load()), m_height(peer.m_height.load()), m_pStats(peer.m_pStats)
 	{
 
 	}
@@ -32,6 +33,8 @@ public:
 	uint16_t GetPort() const noexcept { return m_portNumber; }
 	uint64_t GetTotalDifficulty() const noexcept { return m_totalDifficulty.load(); }
 	uint64_t GetHeight() const noexcept { return m_height.load(); }
+	const ConnectionStatsPtr& GetStats() const noexcept { return m_pStats; }
+	void SetStats(const ConnectionStatsPtr& pStats) { m_pStats = pStats; }
 
 	void UpdateVersion(const uint32_t version) { m_pPeer->UpdateVersion(version); }
 	void UpdateCapabilities(const Capabilities& capabilities) { m_pPeer->UpdateCapabilities(capabilities); }
@@ -44,6 +47,11 @@ public:
 		json["direction"] = GetDirection() == EDirection::OUTBOUND ? "Outbound" : "Inbound";
 		json["total_difficulty"] = GetTotalDifficulty();
 		json["height"] = GetHeight();
+		if (m_pStats != nullptr)
+		{
+			json["stats"] = m_pStats->ToJSON();
+		}
+
 		return json;
 	}
 
@@ -55,5 +63,5 @@ private:
 	uint16_t m_portNumber;
 	std::atomic<uint64_t> m_totalDifficulty;
 	std::atomic<uint64_t> m_height;
-	// TODO: Add Connection Stats
+	ConnectionStatsPtr m_pStats;
 };
\ No newline at end of file
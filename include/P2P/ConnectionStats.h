@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Net/RateCounter.h>
+#include <json/json.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+//
+// Traffic statistics for a single peer connection.
+// Bytes and messages are counted by the connection's socket, and broken down here by message type.
+// Time spent throttled by the upload and download limits is also tracked.
+//
+class ConnectionStats
+{
+public:
+	ConnectionStats(std::shared_ptr<const RateCounter> pRateCounter)
+		: m_pRateCounter(pRateCounter), m_uploadThrottledMs(0), m_downloadThrottledMs(0)
+	{
+
+	}
+
+	void AddSent(const uint8_t messageType, const uint64_t numBytes, const uint64_t numMessages)
+	{
+		Counters& counters = m_sent[(std::min)((size_t)messageType, NUM_TYPES - 1)];
+		counters.bytes += numBytes;
+		counters.messages += numMessages;
+	}
+
+	void AddReceived(const uint8_t messageType, const uint64_t numBytes)
+	{
+		Counters& counters = m_received[(std::min)((size_t)messageType, NUM_TYPES - 1)];
+		counters.bytes += numBytes;
+		counters.messages++;
+	}
+
+	void AddUploadThrottled(const uint64_t milliseconds) { m_uploadThrottledMs += milliseconds; }
+	void AddDownloadThrottled(const uint64_t milliseconds) { m_downloadThrottledMs += milliseconds; }
+
+	Json::Value ToJSON() const
+	{
+		Json::Value json;
+		json["sent"] = ToJSON(m_pRateCounter->GetTotalSent(), m_pRateCounter->GetSentInLastMinute());
+		json["received"] = ToJSON(m_pRateCounter->GetTotalReceived(), m_pRateCounter->GetReceivedInLastMinute());
+		json["upload_throttled_ms"] = (Json::UInt64)m_uploadThrottledMs.load();
+		json["download_throttled_ms"] = (Json::UInt64)m_downloadThrottledMs.load();
+
+		// Only message types that were actually sent or received, keyed by message type id.
+		Json::Value byTypeJSON(Json::objectValue);
+		for (size_t i = 0; i < NUM_TYPES; i++)
+		{
+			if (m_sent[i].messages == 0 && m_received[i].messages == 0 && m_sent[i].bytes == 0)
+			{
+				continue;
+			}
+
+			Json::Value typeJSON;
+			typeJSON["sent_messages"] = (Json::UInt64)m_sent[i].messages.load();
+			typeJSON["sent_bytes"] = (Json::UInt64)m_sent[i].bytes.load();
+			typeJSON["received_messages"] = (Json::UInt64)m_received[i].messages.load();
+			typeJSON["received_bytes"] = (Json::UInt64)m_received[i].bytes.load();
+			byTypeJSON[std::to_string(i)] = typeJSON;
+		}
+
+		json["by_message_type"] = byTypeJSON;
+		return json;
+	}
+
+private:
+	// Message types are a single byte, but only the first few are used by the protocol.
+	static constexpr size_t NUM_TYPES = 32;
+
+	struct Counters
+	{
+		std::atomic<uint64_t> messages = 0;
+		std::atomic<uint64_t> bytes = 0;
+	};
+
+	static Json::Value ToJSON(const RateCounter::Totals& total, const RateCounter::Totals& lastMinute)
+	{
+		Json::Value json;
+		json["messages"] = (Json::UInt64)total.messages;
+		json["bytes"] = (Json::UInt64)total.bytes;
+		json["messages_last_minute"] = (Json::UInt64)lastMinute.messages;
+		json["bytes_last_minute"] = (Json::UInt64)lastMinute.bytes;
+		return json;
+	}
+
+	std::shared_ptr<const RateCounter> m_pRateCounter;
+	std::array<Counters, NUM_TYPES> m_sent;
+	std::array<Counters, NUM_TYPES> m_received;
+	std::atomic<uint64_t> m_uploadThrottledMs;
+	std::atomic<uint64_t> m_downloadThrottledMs;
+};
+
+typedef std::shared_ptr<ConnectionStats> ConnectionStatsPtr;
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <Core/Traits/Batchable.h>
 #include <Core/Traits/Lockable.h>
 #include <vector>
+#include <memory>
 
 #ifdef MW_PMMR
 #define PMMR_API EXPORT
@@ -19,6 +20,7 @@
 // Forward Declarations
 class Config;
 class BlockHeader;
+class CommitJournal;
 
 class IHeaderMMR : public Traits::IBatchable
 {
@@ -26,8 +28,14 @@ public:
 	virtual ~IHeaderMMR() = default;
 
 	virtual void AddHeader(const BlockHeader& header) = 0;
+
+	// Adds consecutive headers in a single batch. Produces the same MMR as calling AddHeader for each header in order.
+	virtual void AddHeaders(const std::vector<std::shared_ptr<const BlockHeader>>& headers) = 0;
 	virtual Hash Root(const uint64_t nextHeight) const = 0;
 	virtual void Rewind(const uint64_t nextHeight) = 0;
+
+	// Records the file writes the next Commit() will perform.
+	virtual void Journal(CommitJournal& journal) const = 0;
 };
 
 namespace HeaderMMRAPI
@@ -20,6 +20,7 @@ class IBlockDB;
 class Transaction;
 class TransactionBody;
 class SyncStatus;
+class CommitJournal;
 
 class ITxHashSet : public Traits::IBatchable
 {
@@ -129,6 +130,11 @@ public:
 		const BlockHeader& header
 	) = 0;
 
+	//
+	// Records the file writes the next Commit() will perform, so they can be replayed after a crash.
+	//
+	virtual void Journal(CommitJournal& journal) const = 0;
+
 	//
 	// Flushes all changes to disk.
 	//
@@ -29,6 +29,14 @@ public:
 	static ITxHashSetPtr LoadFromZip(const Config& config, const fs::path& zipFilePath, BlockHeaderPtr pHeader);
 	fs::path SaveSnapshot(std::shared_ptr<IBlockDB> pBlockDB, BlockHeaderPtr pHeader) const;
 
+	void Journal(CommitJournal& journal) const
+	{
+		if (m_pTxHashSet != nullptr)
+		{
+			m_pTxHashSet->Journal(journal);
+		}
+	}
+
 	virtual void Commit() override final
 	{
 		if (m_pTxHashSet != nullptr)
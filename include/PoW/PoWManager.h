@@ -33,6 +33,22 @@ public:
 		const BlockHeader& previousHeader
 	) const;
 
+	//
+	// Validates only the difficulty and scaling of the header's proof of work, which depend on the previous headers.
+	// Returns true if valid.
+	//
+	bool IsDifficultyValid(
+		const BlockHeader& header,
+		const BlockHeader& previousHeader
+	) const;
+
+	//
+	// Validates only the header's cuckoo cycle. This is the expensive part of PoW validation,
+	// and doesn't depend on any other header, so headers can be checked in any order or in parallel.
+	// Returns true if valid.
+	//
+	bool IsCycleValid(const BlockHeader& header) const;
+
 private:
 	const Config& m_config;
 	std::shared_ptr<const IBlockDB> m_pBlockDB;
@@ -30,9 +30,14 @@ BlockChainServer::BlockChainServer(
 	m_pTxHashSetManager(pTxHashSetManager),
 	m_pTransactionPool(pTransactionPool),
 	m_pChainState(pChainState),
-	m_pHeaderMMR(pHeaderMMR)
+	m_pHeaderMMR(pHeaderMMR),
+	m_groupCommitResumeHeight(0),
+	m_orphanReady(true)
 {
-
+	if (config.GetNodeConfig().GetPruning().IsEnabled())
+	{
+		m_pBlockPruner = BlockPruner::Create(config, pChainState);
+	}
 }
 
 std::shared_ptr<BlockChainServer> BlockChainServer::Create(
@@ -128,11 +133,14 @@ uint64_t BlockChainServer::GetTotalDifficulty(const EChainType chainType) const
 	return m_pChainState->Read()->GetTotalDifficulty(chainType);
 }
 
-EBlockChainStatus BlockChainServer::AddBlock(const FullBlock& block)
+EBlockChainStatus BlockChainServer::AddBlock(const FullBlock& block, const std::string& source)
 {
 	try
 	{
-		return BlockProcessor(m_config, m_pChainState).ProcessBlock(block);
+		const EBlockChainStatus status = BlockProcessor(m_config, m_pChainState).ProcessBlock(block, source);
+		NotifyIfOrphanReady();
+
+		return status;
 	}
 	catch (std::exception& e)
 	{
@@ -141,7 +149,21 @@ EBlockChainStatus BlockChainServer::AddBlock(const FullBlock& block)
 	}
 }
 
-EBlockChainStatus BlockChainServer::AddCompactBlock(const CompactBlock& compactBlock)
+bool BlockChainServer::VerifyBlockSelfConsistent(const FullBlock& block) const
+{
+	try
+	{
+		BlockValidator::VerifySelfConsistent(block);
+		return true;
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Invalid block {}: {}", block, e.what());
+		return false;
+	}
+}
+
+EBlockChainStatus BlockChainServer::AddCompactBlock(const CompactBlock& compactBlock, const std::string& source)
 {
 	const Hash& hash = compactBlock.GetHash();
 	const uint64_t height = compactBlock.GetHeight();
@@ -160,7 +182,7 @@ EBlockChainStatus BlockChainServer::AddCompactBlock(const CompactBlock& compactB
 		std::unique_ptr<FullBlock> pHydratedBlock = BlockHydrator(m_pTransactionPool).Hydrate(compactBlock);
 		if (pHydratedBlock != nullptr)
 		{
-			const EBlockChainStatus added = AddBlock(*pHydratedBlock);
+			const EBlockChainStatus added = AddBlock(*pHydratedBlock, source);
 			if (added == EBlockChainStatus::INVALID)
 			{
 				return EBlockChainStatus::TRANSACTIONS_MISSING;
@@ -197,6 +219,7 @@ EBlockChainStatus BlockChainServer::ProcessTransactionHashSet(const Hash& blockH
 		const bool success = TxHashSetProcessor(m_config, *this, m_pChainState).ProcessTxHashSet(blockHash, path, syncStatus);
 		if (success)
 		{
+			NotifyIfOrphanReady();
 			return EBlockChainStatus::SUCCESS;
 		}
 	}
@@ -254,7 +277,13 @@ EBlockChainStatus BlockChainServer::AddBlockHeader(BlockHeaderPtr pBlockHeader)
 {
 	try
 	{
-		return BlockHeaderProcessor(m_config, m_pChainState).ProcessSingleHeader(pBlockHeader);
+		const EBlockChainStatus status = BlockHeaderProcessor(m_config, m_pChainState).ProcessSingleHeader(pBlockHeader);
+		if (status == EBlockChainStatus::SUCCESS)
+		{
+			NotifyIfOrphanReady();
+		}
+
+		return status;
 	}
 	catch (std::exception&)
 	{
@@ -263,10 +292,26 @@ EBlockChainStatus BlockChainServer::AddBlockHeader(BlockHeaderPtr pBlockHeader)
 }
 
 EBlockChainStatus BlockChainServer::AddBlockHeaders(const std::vector<BlockHeaderPtr>& blockHeaders)
+{
+	return AddSyncHeaders(blockHeaders, false);
+}
+
+EBlockChainStatus BlockChainServer::AddVerifiedBlockHeaders(const VerifiedHeaders& verifiedHeaders)
+{
+	return AddSyncHeaders(verifiedHeaders.GetHeaders(), true);
+}
+
+EBlockChainStatus BlockChainServer::AddSyncHeaders(const std::vector<BlockHeaderPtr>& blockHeaders, const bool cyclesVerified)
 {
 	try
 	{
-		return BlockHeaderProcessor(m_config, m_pChainState).ProcessSyncHeaders(blockHeaders);
+		const EBlockChainStatus status = BlockHeaderProcessor(m_config, m_pChainState).ProcessSyncHeaders(blockHeaders, cyclesVerified);
+		if (status == EBlockChainStatus::SUCCESS)
+		{
+			NotifyIfOrphanReady();
+		}
+
+		return status;
 	}
 	catch (BadDataException&)
 	{
@@ -278,6 +323,16 @@ EBlockChainStatus BlockChainServer::AddBlockHeaders(const std::vector<BlockHeade
 	}
 }
 
+VerifiedHeadersPtr BlockChainServer::VerifyHeaderCycles(const std::vector<BlockHeaderPtr>& blockHeaders) const
+{
+	if (!BlockHeaderProcessor(m_config, m_pChainState).VerifyCycles(blockHeaders))
+	{
+		return nullptr;
+	}
+
+	return MarkCyclesVerified(blockHeaders);
+}
+
 std::vector<BlockHeaderPtr> BlockChainServer::GetBlockHeadersByHash(const std::vector<CBigInteger<32>>& hashes) const
 {
 	auto pReader = m_pChainState->Read();
@@ -386,6 +441,34 @@ std::vector<std::pair<uint64_t, Hash>> BlockChainServer::GetBlocksNeeded(const u
 
 bool BlockChainServer::ProcessNextOrphanBlock()
 {
+	const ChainConfig& chainConfig = m_config.GetNodeConfig().GetChain();
+	if (chainConfig.GetGroupCommitBlocks() > 1)
+	{
+		const uint64_t confirmedHeight = m_pChainState->Read()->GetHeight(EChainType::CONFIRMED);
+		if (confirmedHeight >= m_groupCommitResumeHeight)
+		{
+			try
+			{
+				const size_t numCommitted = BlockProcessor(m_config, m_pChainState).ProcessOrphanGroup(
+					chainConfig.GetGroupCommitBlocks(),
+					std::chrono::milliseconds(chainConfig.GetGroupCommitMillis())
+				);
+				if (numCommitted > 0)
+				{
+					return true;
+				}
+			}
+			catch (std::exception&)
+			{
+				// Process the failed group one block at a time, so the valid blocks are kept and the invalid one is dropped.
+				m_groupCommitResumeHeight = confirmedHeight + chainConfig.GetGroupCommitBlocks();
+
+				// The group's blocks were put back in the orphan pool, so wake the processor to retry them.
+				NotifyIfOrphanReady();
+			}
+		}
+	}
+
 	BlockHeaderPtr pNextHeader = nullptr;
 	std::shared_ptr<const FullBlock> pOrphanBlock = nullptr;
 
@@ -416,6 +499,69 @@ bool BlockChainServer::ProcessNextOrphanBlock()
 	}
 }
 
+bool BlockChainServer::WaitForOrphanBlock(const std::chrono::milliseconds& timeout)
+{
+	std::unique_lock<std::mutex> lock(m_orphanMutex);
+	const bool ready = m_orphanReadyCondition.wait_for(lock, timeout, [this] { return m_orphanReady; });
+	m_orphanReady = false;
+
+	return ready;
+}
+
+void BlockChainServer::NotifyIfOrphanReady()
+{
+	{
+		auto pReader = m_pChainState->Read();
+		auto pOrphanPool = pReader->GetOrphanPool();
+		if (pOrphanPool->IsEmpty())
+		{
+			return;
+		}
+
+		// The next block is ready once it's both an orphan and on the candidate chain.
+		const uint64_t nextHeight = pReader->GetHeight(EChainType::CONFIRMED) + 1;
+		BlockHeaderPtr pConfirmedTip = pReader->GetTipBlockHeader(EChainType::CONFIRMED);
+		BlockHeaderPtr pNextHeader = pReader->GetBlockHeaderByHeight(nextHeight, EChainType::CANDIDATE);
+		if (pConfirmedTip == nullptr || pNextHeader == nullptr)
+		{
+			return;
+		}
+
+		const std::vector<std::shared_ptr<const FullBlock>> children = pOrphanPool->GetChildren(pConfirmedTip->GetHash());
+		const bool ready = std::any_of(
+			children.cbegin(),
+			children.cend(),
+			[&pNextHeader](const std::shared_ptr<const FullBlock>& pChild) { return pChild->GetHash() == pNextHeader->GetHash(); }
+		);
+		if (!ready)
+		{
+			return;
+		}
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_orphanMutex);
+		m_orphanReady = true;
+	}
+
+	m_orphanReadyCondition.notify_one();
+}
+
+PruningStats BlockChainServer::GetPruningStats() const
+{
+	if (m_pBlockPruner != nullptr)
+	{
+		return m_pBlockPruner->GetStats();
+	}
+
+	return PruningStats{ 0, 0, 0 };
+}
+
+OrphanPoolStats BlockChainServer::GetOrphanPoolStats() const
+{
+	return m_pChainState->Read()->GetOrphanPool()->GetStats();
+}
+
 namespace BlockChainAPI
 {
 	BLOCK_CHAIN_API std::shared_ptr<IBlockChainServer> StartBlockChainServer(
@@ -427,4 +573,4 @@ namespace BlockChainAPI
 	{
 		return BlockChainServer::Create(config, pDatabase, pTxHashSetManager, pTransactionPool, pHeaderMMR);
 	}
-}
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "ChainState.h"
 #include "ChainStore.h"
+#include "BlockPruner.h"
 
 #include <TxPool/TransactionPool.h>
 #include <BlockChain/BlockChainServer.h>
@@ -11,6 +12,8 @@
 #include <P2P/SyncStatus.h>
 #include <stdint.h>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 class BlockChainServer : public IBlockChainServer
 {
@@ -33,11 +36,14 @@ public:
 	uint64_t GetHeight(const EChainType chainType) const final;
 	uint64_t GetTotalDifficulty(const EChainType chainType) const final;
 
-	EBlockChainStatus AddBlock(const FullBlock& block) final;
-	EBlockChainStatus AddCompactBlock(const CompactBlock& block) final;
+	EBlockChainStatus AddBlock(const FullBlock& block, const std::string& source) final;
+	bool VerifyBlockSelfConsistent(const FullBlock& block) const final;
+	EBlockChainStatus AddCompactBlock(const CompactBlock& block, const std::string& source) final;
 
 	EBlockChainStatus AddBlockHeader(BlockHeaderPtr pBlockHeader) final;
 	EBlockChainStatus AddBlockHeaders(const std::vector<BlockHeaderPtr>& blockHeaders) final;
+	EBlockChainStatus AddVerifiedBlockHeaders(const VerifiedHeaders& verifiedHeaders) final;
+	VerifiedHeadersPtr VerifyHeaderCycles(const std::vector<BlockHeaderPtr>& blockHeaders) const final;
 
 	fs::path SnapshotTxHashSet(BlockHeaderPtr pBlockHeader) final;
 	EBlockChainStatus ProcessTransactionHashSet(const Hash& blockHash, const fs::path& path, SyncStatus& syncStatus) final;
@@ -60,6 +66,10 @@ public:
 	std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t maxNumBlocks) const final;
 
 	bool ProcessNextOrphanBlock() final;
+	bool WaitForOrphanBlock(const std::chrono::milliseconds& timeout) final;
+
+	PruningStats GetPruningStats() const final;
+	OrphanPoolStats GetOrphanPoolStats() const final;
 
 private:
 	BlockChainServer(
@@ -71,10 +81,22 @@ private:
 		std::shared_ptr<Locked<IHeaderMMR>> pHeaderMMR
 	);
 
+	EBlockChainStatus AddSyncHeaders(const std::vector<BlockHeaderPtr>& blockHeaders, const bool cyclesVerified);
+
 	const Config& m_config;
 	std::shared_ptr<Locked<IBlockDB>> m_pDatabase;
 	std::shared_ptr<Locked<TxHashSetManager>> m_pTxHashSetManager;
 	std::shared_ptr<ITransactionPool> m_pTransactionPool;
 	std::shared_ptr<Locked<ChainState>> m_pChainState;
 	std::shared_ptr<Locked<IHeaderMMR>> m_pHeaderMMR;
+	std::shared_ptr<BlockPruner> m_pBlockPruner;
+
+	// Blocks are committed one at a time until the confirmed chain reaches this height, after a group commit fails.
+	std::atomic<uint64_t> m_groupCommitResumeHeight;
+
+	// Signaled when the chain changes in a way that lets an orphan connect, so the orphan processor doesn't need to poll.
+	void NotifyIfOrphanReady();
+	std::mutex m_orphanMutex;
+	std::condition_variable m_orphanReadyCondition;
+	bool m_orphanReady;
 };
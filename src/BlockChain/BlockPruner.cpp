@@ -0,0 +1,210 @@
+#include "BlockPruner.h"
+
+#include <Consensus/BlockTime.h>
+#include <Common/Util/FileUtil.h>
+#include <Common/Util/ThreadUtil.h>
+#include <Infrastructure/ThreadManager.h>
+#include <Infrastructure/Logger.h>
+#include <string>
+#include <map>
+
+BlockPruner::BlockPruner(const Config& config, const std::shared_ptr<Locked<ChainState>>& pChainState, const uint64_t prunedHeight)
+	: m_config(config),
+	m_pChainState(pChainState),
+	m_prunedHeight(prunedHeight),
+	m_blocksPruned(0),
+	m_bytesReclaimed(0),
+	m_terminate(false)
+{
+
+}
+
+BlockPruner::~BlockPruner()
+{
+	m_terminate = true;
+	ThreadUtil::Join(m_pruneThread);
+}
+
+std::shared_ptr<BlockPruner> BlockPruner::Create(const Config& config, const std::shared_ptr<Locked<ChainState>>& pChainState)
+{
+	auto pPruner = std::shared_ptr<BlockPruner>(new BlockPruner(config, pChainState, LoadPrunedHeight(config)));
+	pPruner->m_pruneThread = std::thread(Thread_Prune, std::ref(*pPruner));
+
+	return pPruner;
+}
+
+PruningStats BlockPruner::GetStats() const
+{
+	return PruningStats{ m_prunedHeight, m_blocksPruned, m_bytesReclaimed };
+}
+
+std::optional<std::pair<uint64_t, uint64_t>> BlockPruner::GetNextBatch(
+	const PruningConfig& config,
+	const uint64_t confirmedHeight,
+	const uint64_t prunedHeight)
+{
+	const uint64_t horizonHeight = Consensus::GetHorizonHeight(confirmedHeight);
+	if (horizonHeight <= config.GetMarginBlocks())
+	{
+		return std::nullopt;
+	}
+
+	const uint64_t pruneHeight = horizonHeight - config.GetMarginBlocks();
+	const uint64_t startHeight = prunedHeight + 1;
+	if (startHeight > pruneHeight)
+	{
+		return std::nullopt;
+	}
+
+	const uint64_t endHeight = (std::min)(pruneHeight, prunedHeight + config.GetBatchSize());
+	return std::make_pair(startHeight, endHeight);
+}
+
+void BlockPruner::Thread_Prune(BlockPruner& pruner)
+{
+	ThreadManagerAPI::SetCurrentThreadName("BLOCK_PRUNER");
+	LOG_DEBUG("BEGIN");
+
+	const PruningConfig& config = pruner.m_config.GetNodeConfig().GetPruning();
+
+	try
+	{
+		pruner.SweepBlockFiles();
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+	}
+
+	while (!pruner.m_terminate)
+	{
+		try
+		{
+			// Keep pruning in small batches until caught up, releasing the chain state lock in between.
+			while (!pruner.m_terminate && pruner.PruneNextBatch())
+			{
+				ThreadUtil::SleepFor(std::chrono::milliseconds(10), pruner.m_terminate);
+			}
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_F("Exception thrown: {}", e.what());
+		}
+
+		ThreadUtil::SleepFor(std::chrono::seconds(config.GetIntervalSeconds()), pruner.m_terminate);
+	}
+
+	LOG_DEBUG("END");
+}
+
+bool BlockPruner::PruneNextBatch()
+{
+	const PruningConfig& config = m_config.GetNodeConfig().GetPruning();
+
+	uint64_t confirmedHeight = 0;
+	uint64_t startHeight = 0;
+	uint64_t endHeight = 0;
+	std::vector<Hash> blockHashes;
+	std::map<uint32_t, std::vector<Hash>> blockFiles;
+
+	// Finding the blocks and walking the files to remove only needs a read lock.
+	// Blocks this far below the horizon can't be reorged, so they're still prunable once the write lock is taken.
+	{
+		auto pReader = m_pChainState->Read();
+
+		auto pConfirmedChain = pReader->GetChainStore()->GetConfirmedChain();
+		confirmedHeight = pConfirmedChain->GetHeight();
+
+		const auto batch = GetNextBatch(config, confirmedHeight, m_prunedHeight);
+		if (!batch.has_value())
+		{
+			return false;
+		}
+
+		startHeight = batch.value().first;
+		endHeight = batch.value().second;
+
+		blockHashes.reserve(endHeight - startHeight + 1);
+		for (uint64_t height = startHeight; height <= endHeight; height++)
+		{
+			auto pIndex = pConfirmedChain->GetByHeight(height);
+			if (pIndex != nullptr)
+			{
+				blockHashes.push_back(pIndex->GetHash());
+			}
+		}
+
+		blockFiles = pReader->GetBlockDB()->GetPrunableBlockFiles(endHeight + 1);
+	}
+
+	auto pBatch = m_pChainState->BatchWrite();
+	const uint64_t bytesReclaimed = pBatch->GetBlockDB()->PruneBlocks(blockHashes, blockFiles, endHeight + 1);
+	pBatch->Commit();
+
+	SavePrunedHeight(endHeight);
+	m_prunedHeight = endHeight;
+	m_blocksPruned += blockHashes.size();
+	m_bytesReclaimed += bytesReclaimed;
+
+	LOG_INFO_F(
+		"Pruned blocks {}-{}, reclaiming {} bytes ({} bytes total)",
+		startHeight,
+		endHeight,
+		bytesReclaimed,
+		m_bytesReclaimed.load()
+	);
+
+	return GetNextBatch(config, confirmedHeight, endHeight).has_value();
+}
+
+void BlockPruner::SweepBlockFiles()
+{
+	if (m_prunedHeight == 0)
+	{
+		return;
+	}
+
+	const auto blockFiles = m_pChainState->Read()->GetBlockDB()->GetPrunableBlockFiles(m_prunedHeight + 1);
+	if (blockFiles.empty())
+	{
+		return;
+	}
+
+	auto pBatch = m_pChainState->BatchWrite();
+	const uint64_t bytesReclaimed = pBatch->GetBlockDB()->PruneBlocks({}, blockFiles, m_prunedHeight + 1);
+	pBatch->Commit();
+
+	if (bytesReclaimed > 0)
+	{
+		LOG_INFO_F("Swept leftover block files, reclaiming {} bytes", bytesReclaimed);
+		m_bytesReclaimed += bytesReclaimed;
+	}
+}
+
+fs::path BlockPruner::GetPrunedHeightPath(const Config& config)
+{
+	return config.GetNodeConfig().GetChainPath() / "pruned_height.txt";
+}
+
+uint64_t BlockPruner::LoadPrunedHeight(const Config& config)
+{
+	std::vector<unsigned char> data;
+	if (FileUtil::ReadFile(GetPrunedHeightPath(config), data) && !data.empty())
+	{
+		try
+		{
+			return std::stoull(std::string(data.cbegin(), data.cend()));
+		}
+		catch (std::exception&)
+		{
+			LOG_WARNING("Pruned height file is invalid. Pruning will restart from genesis.");
+		}
+	}
+
+	return 0;
+}
+
+void BlockPruner::SavePrunedHeight(const uint64_t prunedHeight) const
+{
+	FileUtil::WriteTextToFile(GetPrunedHeightPath(m_config), std::to_string(prunedHeight));
+}
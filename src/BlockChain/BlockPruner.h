@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ChainState.h"
+
+#include <BlockChain/PruningStats.h>
+#include <Config/Config.h>
+#include <Core/Traits/Lockable.h>
+#include <thread>
+#include <atomic>
+#include <optional>
+#include <utility>
+
+//
+// Background task that deletes full blocks and spent output records that are older than the cut-through horizon
+// (plus a configurable safety margin). Work is done in bounded batches, so block processing is never blocked for long.
+//
+class BlockPruner
+{
+public:
+	static std::shared_ptr<BlockPruner> Create(const Config& config, const std::shared_ptr<Locked<ChainState>>& pChainState);
+	~BlockPruner();
+
+	PruningStats GetStats() const;
+
+	//
+	// Returns the first and last height of the next batch to prune, given the confirmed chain height and the height
+	// pruned so far. Returns std::nullopt once everything up to the horizon (minus the safety margin) has been pruned.
+	//
+	static std::optional<std::pair<uint64_t, uint64_t>> GetNextBatch(
+		const PruningConfig& config,
+		const uint64_t confirmedHeight,
+		const uint64_t prunedHeight
+	);
+
+private:
+	BlockPruner(const Config& config, const std::shared_ptr<Locked<ChainState>>& pChainState, const uint64_t prunedHeight);
+
+	static void Thread_Prune(BlockPruner& pruner);
+
+	// Returns true if there are more blocks waiting to be pruned.
+	bool PruneNextBatch();
+
+	// Removes block files left behind when the node stopped between committing a batch and deleting its files.
+	void SweepBlockFiles();
+
+	static fs::path GetPrunedHeightPath(const Config& config);
+	static uint64_t LoadPrunedHeight(const Config& config);
+	void SavePrunedHeight(const uint64_t prunedHeight) const;
+
+	const Config& m_config;
+	std::shared_ptr<Locked<ChainState>> m_pChainState;
+
+	std::atomic<uint64_t> m_prunedHeight;
+	std::atomic<uint64_t> m_blocksPruned;
+	std::atomic<uint64_t> m_bytesReclaimed;
+
+	std::atomic_bool m_terminate;
+	std::thread m_pruneThread;
+};
@@ -87,6 +87,14 @@ void Chain::Rewind(const uint64_t lastHeight)
 	}
 }
 
+void Chain::Journal(CommitJournal& journal) const
+{
+	if (IsDirty())
+	{
+		m_dataFileWriter->Journal(journal);
+	}
+}
+
 void Chain::Commit()
 {
 	if (IsDirty())
@@ -17,11 +17,14 @@ void ChainResyncer::ResyncChain()
 	auto pConfirmedChain = pLockedState->GetChainStore()->GetConfirmedChain();
 	auto pCandidateChain = pLockedState->GetChainStore()->GetCandidateChain();
 
+	// The derived tables are cleared directly rather than through the batch, so this must happen before anything is written to them.
 	CleanDatabase(pBlockDB);
 
 	pConfirmedChain->Rewind(0);
 
 	pHeaderMMR->Rewind(1);
+
+	std::vector<BlockHeaderPtr> headers;
 	for (uint64_t i = 1; i <= pCandidateChain->GetHeight(); i++)
 	{
 		auto pIndex = pCandidateChain->GetByHeight(i);
@@ -32,9 +35,11 @@ void ChainResyncer::ResyncChain()
 			break;
 		}
 
-		pHeaderMMR->AddHeader(*pHeader);
+		headers.push_back(pHeader);
 	}
 
+	pHeaderMMR->AddHeaders(headers);
+
 	pSyncChain->Rewind(pCandidateChain->GetTip()->GetHeight());
 
 	pLockedState->Commit();
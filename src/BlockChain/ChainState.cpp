@@ -4,6 +4,7 @@
 #include <Database/BlockDb.h>
 #include <PMMR/TxHashSetManager.h>
 #include <TxPool/TransactionPool.h>
+#include <Infrastructure/Logger.h>
 #include <PMMR/TxHashSetManager.h>
 
 ChainState::ChainState(
@@ -12,14 +13,19 @@ ChainState::ChainState(
 	std::shared_ptr<Locked<IBlockDB>> pDatabase,
 	std::shared_ptr<Locked<IHeaderMMR>> pHeaderMMR,
 	std::shared_ptr<ITransactionPool> pTransactionPool,
-	std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager)
+	std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager,
+	std::shared_ptr<HeaderStore> pHeaderStore)
 	: m_config(config),
 	m_pChainStore(pChainStore),
 	m_pBlockDB(pDatabase),
 	m_pHeaderMMR(pHeaderMMR),
 	m_pTransactionPool(pTransactionPool),
 	m_pTxHashSetManager(pTxHashSetManager),
-	m_pOrphanPool(std::make_shared<OrphanPool>())
+	m_pOrphanPool(std::make_shared<OrphanPool>(
+		config.GetNodeConfig().GetChain().GetMaxOrphanPoolBytes(),
+		config.GetNodeConfig().GetChain().GetMaxOrphanBytesPerPeer()
+	)),
+	m_pHeaderStore(pHeaderStore)
 {
 
 }
@@ -53,7 +59,13 @@ std::shared_ptr<Locked<ChainState>> ChainState::Create(
 	auto pConfirmedHeader = pDatabase->Read()->GetBlockHeader(pConfirmedIndex->GetHash());
 	pTxHashSetManager->Write()->Open(pConfirmedHeader, genesisBlock);
 
-	std::shared_ptr<ChainState> pChainState(new ChainState(config, pChainStore, pDatabase, pHeaderMMR, pTransactionPool, pTxHashSetManager));
+	std::shared_ptr<HeaderStore> pHeaderStore = nullptr;
+	if (config.GetNodeConfig().GetChain().IsHeaderStoreEnabled())
+	{
+		pHeaderStore = HeaderStore::Load(config.GetNodeConfig().GetChainPath() / "headers.dat");
+	}
+
+	std::shared_ptr<ChainState> pChainState(new ChainState(config, pChainStore, pDatabase, pHeaderMMR, pTransactionPool, pTxHashSetManager, pHeaderStore));
 	return std::make_shared<Locked<ChainState>>(Locked<ChainState>(pChainState));
 }
 
@@ -92,13 +104,22 @@ uint64_t ChainState::GetTotalDifficulty(const EChainType chainType) const
 
 BlockHeaderPtr ChainState::GetTipBlockHeader(const EChainType chainType) const
 {
-	const Hash& headHash = GetChainStore()->GetChain(chainType)->GetTipHash();
+	auto pChain = GetChainStore()->GetChain(chainType);
 
-	return GetBlockDB()->GetBlockHeader(headHash);
+	return GetBlockHeaderByHeight(pChain->GetHeight(), chainType);
 }
 
 BlockHeaderPtr ChainState::GetBlockHeaderByHash(const Hash& hash) const
 {
+	if (m_pHeaderStore != nullptr)
+	{
+		BlockHeaderPtr pHeader = m_pHeaderStore->GetByHash(hash);
+		if (pHeader != nullptr)
+		{
+			return pHeader;
+		}
+	}
+
 	return GetBlockDB()->GetBlockHeader(hash);
 }
 
@@ -107,6 +128,16 @@ BlockHeaderPtr ChainState::GetBlockHeaderByHeight(const uint64_t height, const E
 	auto pBlockIndex = GetChainStore()->GetChain(chainType)->GetByHeight(height);
 	if (pBlockIndex != nullptr)
 	{
+		if (m_pHeaderStore != nullptr)
+		{
+			// The store only tracks the committed candidate chain, so the hash must still be checked.
+			BlockHeaderPtr pHeader = m_pHeaderStore->GetByHeight(height);
+			if (pHeader != nullptr && pHeader->GetHash() == pBlockIndex->GetHash())
+			{
+				return pHeader;
+			}
+		}
+
 		return GetBlockDB()->GetBlockHeader(pBlockIndex->GetHash());
 	}
 
@@ -209,16 +240,61 @@ std::vector<std::pair<uint64_t, Hash>> ChainState::GetBlocksNeeded(const uint64_
 
 void ChainState::Commit()
 {
+	// Journal every pending file write, and store the journal in the same database transaction as the batch.
+	// Plain appends are written and synced ahead of that transaction, so only their sizes are journaled.
+	// Once the transaction commits, the batch is durable: if the node stops before the remaining writes are done,
+	// the journal is replayed the next time the database is opened. If it stops before the transaction commits,
+	// the pending journal is used to truncate the appends that were written ahead.
+	// Each step is skipped when there's nothing for it to protect, so a batch of plain appends never stores a
+	// committed journal, and a batch without appends never stores a pending one.
+	const bool sync = m_config.GetNodeConfig().GetChain().IsSyncCommitsEnabled();
+
+	CommitJournal journal;
 	if (!m_chainStoreWriter.IsNull())
 	{
-		m_chainStoreWriter->Commit();
+		m_chainStoreWriter->Journal(journal);
 	}
 
-	if (!m_blockDBWriter.IsNull())
+	if (!m_headerMMRWriter.IsNull())
+	{
+		m_headerMMRWriter->Journal(journal);
+	}
+
+	if (!m_txHashSetWriter.IsNull())
+	{
+		m_txHashSetWriter->Journal(journal);
+	}
+
+	const bool journaled = !journal.IsEmpty() && !m_blockDBWriter.IsNull();
+	if (journaled)
+	{
+		if (journal.HasWritesAhead())
+		{
+			m_blockDBWriter->SavePendingJournal(journal, sync);
+		}
+
+		try
+		{
+			journal.WriteAhead(sync);
+			m_blockDBWriter->SaveCommitJournal(journal);
+			m_blockDBWriter->Commit();
+		}
+		catch (std::exception&)
+		{
+			journal.Revert();
+			throw;
+		}
+	}
+	else if (!m_blockDBWriter.IsNull())
 	{
 		m_blockDBWriter->Commit();
 	}
 
+	if (!m_chainStoreWriter.IsNull())
+	{
+		m_chainStoreWriter->Commit();
+	}
+
 	if (!m_headerMMRWriter.IsNull())
 	{
 		m_headerMMRWriter->Commit();
@@ -228,6 +304,29 @@ void ChainState::Commit()
 	{
 		m_txHashSetWriter->Commit();
 	}
+
+	if (journaled && journal.HasPostCommitWrites())
+	{
+		if (sync)
+		{
+			journal.Sync();
+		}
+
+		m_blockDBWriter->ClearCommitJournal();
+	}
+
+	if (m_pHeaderStore != nullptr && !m_chainStoreWriter.IsNull() && !m_blockDBWriter.IsNull())
+	{
+		try
+		{
+			m_pHeaderStore->Sync(*m_chainStoreWriter->GetCandidateChain(), *m_blockDBWriter);
+		}
+		catch (std::exception& e)
+		{
+			// The header store is only a cache, so failing to sync it must not fail the commit.
+			LOG_ERROR_F("Failed to sync header store: {}", e.what());
+		}
+	}
 }
 
 void ChainState::Rollback() noexcept
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ChainStore.h"
+#include "HeaderStore.h"
 #include "OrphanPool/OrphanPool.h"
 
 #include <P2P/SyncStatus.h>
@@ -152,6 +153,7 @@ public:
 	}
 
 	std::shared_ptr<OrphanPool> GetOrphanPool() { return m_pOrphanPool; }
+	std::shared_ptr<const OrphanPool> GetOrphanPool() const { return m_pOrphanPool; }
 	ITransactionPoolPtr GetTransactionPool() { return m_pTransactionPool; }
 
 private:
@@ -161,7 +163,8 @@ private:
 		std::shared_ptr<Locked<IBlockDB>> pDatabase,
 		std::shared_ptr<Locked<IHeaderMMR>> pHeaderMMR,
 		std::shared_ptr<ITransactionPool> pTransactionPool,
-		std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager
+		std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager,
+		std::shared_ptr<HeaderStore> pHeaderStore
 	);
 
 	const Config& m_config;
@@ -171,6 +174,7 @@ private:
 	std::shared_ptr<ITransactionPool> m_pTransactionPool;
 	std::shared_ptr<Locked<TxHashSetManager>> m_pTxHashSetManager;
 	std::shared_ptr<OrphanPool> m_pOrphanPool;
+	std::shared_ptr<HeaderStore> m_pHeaderStore;
 
 	// Writers
 	Writer<ChainStore> m_chainStoreWriter;
@@ -46,6 +46,13 @@ std::shared_ptr<Locked<ChainStore>> ChainStore::Load(const Config& config, std::
 	return std::make_shared<Locked<ChainStore>>(Locked<ChainStore>(pChainStore));
 }
 
+void ChainStore::Journal(CommitJournal& journal) const
+{
+	m_pSyncChain->Journal(journal);
+	m_pCandidateChain->Journal(journal);
+	m_pConfirmedChain->Journal(journal);
+}
+
 void ChainStore::Commit()
 {
 	m_pSyncChain->Commit();
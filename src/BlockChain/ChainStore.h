@@ -9,6 +9,8 @@ class ChainStore : public Traits::IBatchable
 public:
 	static std::shared_ptr<Locked<ChainStore>> Load(const Config& config, std::shared_ptr<BlockIndex>);
 
+	void Journal(CommitJournal& journal) const;
+
 	virtual void Commit() override final;
 	virtual void Rollback() noexcept override final;
 	virtual void OnInitWrite() override final;
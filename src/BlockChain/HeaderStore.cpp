@@ -0,0 +1,163 @@
+#include "HeaderStore.h"
+
+#include <Core/Serialization/Serializer.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Exceptions/BlockChainException.h>
+#include <Infrastructure/Logger.h>
+
+std::shared_ptr<HeaderStore> HeaderStore::Load(const fs::path& path)
+{
+	auto pFile = std::make_shared<AppendOnlyFile>(path);
+	pFile->Load();
+
+	return std::shared_ptr<HeaderStore>(new HeaderStore(pFile));
+}
+
+BlockHeaderPtr HeaderStore::GetByHeight(const uint64_t height) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	EnsureLoaded();
+
+	return GetHeader(height);
+}
+
+BlockHeaderPtr HeaderStore::GetByHash(const Hash& hash) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	EnsureLoaded();
+
+	auto iter = m_heightsByHash.find(hash);
+	if (iter != m_heightsByHash.cend())
+	{
+		return GetHeader(iter->second);
+	}
+
+	return nullptr;
+}
+
+void HeaderStore::Sync(const Chain& candidateChain, const IBlockDB& blockDB)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	EnsureLoaded();
+
+	// Find the highest height at which the store still matches the candidate chain.
+	uint64_t numMatching = (std::min)((uint64_t)m_hashes.size(), candidateChain.GetHeight() + 1);
+	while (numMatching > 0 && m_hashes[numMatching - 1] != candidateChain.GetHash(numMatching - 1))
+	{
+		--numMatching;
+	}
+
+	if (numMatching < m_hashes.size())
+	{
+		LOG_DEBUG_F("Rewinding header store to height {}", numMatching);
+		Rewind(numMatching);
+	}
+
+	const uint64_t lastHeight = (std::min)(candidateChain.GetHeight(), numMatching + MAX_HEADERS_PER_SYNC - 1);
+	for (uint64_t height = m_hashes.size(); height <= lastHeight; height++)
+	{
+		BlockHeaderPtr pHeader = blockDB.GetBlockHeader(candidateChain.GetHash(height));
+		if (pHeader == nullptr)
+		{
+			LOG_WARNING_F("Header at height {} not found", height);
+			break;
+		}
+
+		Append(*pHeader);
+		m_headers.back() = pHeader;
+	}
+
+	if (!m_pFile->Flush())
+	{
+		LOG_ERROR("Failed to flush header store");
+		throw BLOCK_CHAIN_EXCEPTION("Failed to flush header store");
+	}
+}
+
+void HeaderStore::EnsureLoaded() const
+{
+	if (m_loaded)
+	{
+		return;
+	}
+
+	uint64_t position = 0;
+	while (position + RECORD_HEADER_SIZE <= m_pFile->GetSize())
+	{
+		std::vector<unsigned char> recordHeader;
+		m_pFile->Read(position, RECORD_HEADER_SIZE, recordHeader);
+
+		ByteBuffer byteBuffer(std::move(recordHeader));
+		Hash hash = byteBuffer.ReadBigInteger<32>();
+		const uint32_t size = byteBuffer.ReadU32();
+		if (position + RECORD_HEADER_SIZE + size > m_pFile->GetSize())
+		{
+			// Partially written record, which will be overwritten by the next Sync.
+			break;
+		}
+
+		m_heightsByHash[hash] = m_hashes.size();
+		m_offsets.push_back(position);
+		m_hashes.emplace_back(std::move(hash));
+
+		position += RECORD_HEADER_SIZE + size;
+	}
+
+	m_headers.resize(m_hashes.size());
+	m_pFile->Rewind(position);
+	m_loaded = true;
+
+	LOG_INFO_F("Loaded {} headers from header store", m_hashes.size());
+}
+
+BlockHeaderPtr HeaderStore::GetHeader(const uint64_t height) const
+{
+	if (height >= m_headers.size())
+	{
+		return nullptr;
+	}
+
+	if (m_headers[height] == nullptr)
+	{
+		const uint64_t nextOffset = (height + 1 < m_offsets.size()) ? m_offsets[height + 1] : m_pFile->GetSize();
+		const uint64_t headerOffset = m_offsets[height] + RECORD_HEADER_SIZE;
+
+		std::vector<unsigned char> serialized;
+		m_pFile->Read(headerOffset, nextOffset - headerOffset, serialized);
+
+		ByteBuffer byteBuffer(std::move(serialized));
+		m_headers[height] = std::make_shared<const BlockHeader>(BlockHeader::Deserialize(byteBuffer));
+	}
+
+	return m_headers[height];
+}
+
+void HeaderStore::Rewind(const uint64_t nextHeight)
+{
+	for (uint64_t height = nextHeight; height < m_hashes.size(); height++)
+	{
+		m_heightsByHash.erase(m_hashes[height]);
+	}
+
+	m_pFile->Rewind(m_offsets[nextHeight]);
+	m_offsets.resize(nextHeight);
+	m_hashes.resize(nextHeight);
+	m_headers.resize(nextHeight);
+}
+
+void HeaderStore::Append(const BlockHeader& header)
+{
+	const std::vector<unsigned char> serialized = header.Serialized();
+
+	Serializer record(RECORD_HEADER_SIZE + serialized.size());
+	record.AppendBigInteger(header.GetHash());
+	record.Append<uint32_t>((uint32_t)serialized.size());
+	record.AppendByteVector(serialized);
+
+	m_heightsByHash[header.GetHash()] = m_hashes.size();
+	m_offsets.push_back(m_pFile->GetSize());
+	m_hashes.push_back(header.GetHash());
+	m_headers.push_back(nullptr);
+
+	m_pFile->Append(record.GetBytes());
+}
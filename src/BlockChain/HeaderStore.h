@@ -0,0 +1,65 @@
+#pragma once
+
+#include <BlockChain/Chain.h>
+#include <Core/File/AppendOnlyFile.h>
+#include <Core/Models/BlockHeader.h>
+#include <Database/BlockDb.h>
+#include <Crypto/Hash.h>
+#include <filesystem.h>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+
+//
+// Dense, height-indexed store of the candidate chain's headers.
+//
+// Headers are persisted contiguously by height in a compact header file, where each record is laid out as:
+// hash (32 bytes) | size (4 bytes) | serialized BlockHeader (size bytes).
+// The file is scanned the first time the store is used, building the hash->height map,
+// and individual headers are only deserialized (and then kept in memory) the first time they're requested.
+//
+// The store is brought in line with the candidate chain by calling Sync after every commit.
+// Lookups never return headers that don't match the requested hash, so callers can always fall back to the database.
+//
+class HeaderStore
+{
+public:
+	static std::shared_ptr<HeaderStore> Load(const fs::path& path);
+
+	//
+	// Returns the stored header at the given height, or nullptr if the store doesn't (yet) reach that height.
+	//
+	BlockHeaderPtr GetByHeight(const uint64_t height) const;
+
+	//
+	// Returns the stored header matching the given hash, or nullptr if not found.
+	//
+	BlockHeaderPtr GetByHash(const Hash& hash) const;
+
+	//
+	// Rewinds any stored headers that are no longer on the candidate chain, then appends missing candidate headers.
+	// To avoid stalling the chain on first use, at most MAX_HEADERS_PER_SYNC headers are appended per call.
+	//
+	void Sync(const Chain& candidateChain, const IBlockDB& blockDB);
+
+private:
+	static constexpr uint64_t RECORD_HEADER_SIZE = 36;
+	static constexpr uint64_t MAX_HEADERS_PER_SYNC = 8192;
+
+	HeaderStore(const std::shared_ptr<AppendOnlyFile>& pFile)
+		: m_pFile(pFile), m_loaded(false) { }
+
+	void EnsureLoaded() const;
+	BlockHeaderPtr GetHeader(const uint64_t height) const;
+	void Rewind(const uint64_t nextHeight);
+	void Append(const BlockHeader& header);
+
+	mutable std::mutex m_mutex;
+	std::shared_ptr<AppendOnlyFile> m_pFile;
+
+	mutable bool m_loaded;
+	mutable std::vector<uint64_t> m_offsets;
+	mutable std::vector<Hash> m_hashes;
+	mutable std::vector<BlockHeaderPtr> m_headers;
+	mutable std::unordered_map<Hash, uint64_t> m_heightsByHash;
+};
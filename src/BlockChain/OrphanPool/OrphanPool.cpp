@@ -1,106 +1,296 @@
 #include "OrphanPool.h"
 
-OrphanPool::OrphanPool() : m_orphanHeadersByHash(64)
+#include <Infrastructure/Logger.h>
+#include <algorithm>
+#include <optional>
+
+OrphanPool::OrphanPool(const uint64_t maxBytes, const uint64_t maxBytesPerSource)
+	: m_maxBytes(maxBytes),
+	m_maxBytesPerSource(maxBytesPerSource),
+	m_numBytes(0),
+	m_confirmedHeight(0),
+	m_nextSequence(0),
+	m_numEvicted(0),
+	m_numRejected(0),
+	m_orphanHeadersByHash(64)
 {
 
 }
 
 bool OrphanPool::IsOrphan(const uint64_t height, const Hash& hash) const
 {
-	auto heightIter = m_orphansByHeight.find(height);
-	if (heightIter != m_orphansByHeight.cend())
+	auto iter = m_orphansByHash.find(hash);
+	return iter != m_orphansByHash.cend() && iter->second.orphan.GetHeight() == height;
+}
+
+bool OrphanPool::AddOrphanBlock(const FullBlock& block, const uint64_t confirmedHeight, const std::string& source)
+{
+	if (!m_orphanHeadersByHash.Cached(block.GetHash()))
 	{
-		for (auto orphanIter = heightIter->second.cbegin(); orphanIter != heightIter->second.cend(); orphanIter++)
-		{
-			if (orphanIter->GetHash() == hash)
-			{
-				return true;
-			}
-		}
+		m_orphanHeadersByHash.Put(block.GetHash(), block.GetBlockHeader());
+	}
+
+	if (m_orphansByHash.find(block.GetHash()) != m_orphansByHash.cend())
+	{
+		return true;
 	}
 
-	return false;
+	UpdateConfirmedHeight(confirmedHeight);
+
+	const uint64_t height = block.GetHeight();
+	const uint64_t numBytes = block.GetSerializedSize();
+
+	std::vector<Hash> evictions;
+	const bool fits = numBytes <= m_maxBytes && (source.empty() || numBytes <= m_maxBytesPerSource);
+	if (!fits || !FindEvictions(height, numBytes, source, evictions))
+	{
+		LOG_DEBUG_F("Orphan pool full. Rejecting {} from {}", block, source);
+		m_numRejected++;
+		return false;
+	}
+
+	for (const Hash& hash : evictions)
+	{
+		const Entry& entry = m_orphansByHash.at(hash);
+		LOG_DEBUG_F("Evicting orphan {} from {}", *entry.orphan.GetBlock(), entry.source);
+		RemoveEntry(hash);
+		m_numEvicted++;
+	}
+
+	auto inserted = m_orphansByHash.emplace(block.GetHash(), Entry{ Orphan(block), source, numBytes, m_nextSequence++ });
+	AddToEvictionIndex(block.GetHash(), inserted.first->second);
+	m_orphansByPreviousHash[block.GetPreviousHash()].push_back(block.GetHash());
+	m_orphansByHeight.emplace(height, block.GetHash());
+	m_numBytes += numBytes;
+	if (!source.empty())
+	{
+		m_bytesBySource[source] += numBytes;
+	}
+
+	return true;
 }
 
-void OrphanPool::AddOrphanBlock(const FullBlock& block)
+std::shared_ptr<const FullBlock> OrphanPool::GetOrphanBlock(const uint64_t height, const Hash& hash) const
 {
-	if (!m_orphanHeadersByHash.Cached(block.GetHash()))
+	auto iter = m_orphansByHash.find(hash);
+	if (iter != m_orphansByHash.cend() && iter->second.orphan.GetHeight() == height)
 	{
-		m_orphanHeadersByHash.Put(block.GetHash(), block.GetBlockHeader());
+		return iter->second.orphan.GetBlock();
 	}
 
-	auto heightIter = m_orphansByHeight.find(block.GetHeight());
-	if (heightIter != m_orphansByHeight.cend())
+	return std::shared_ptr<const FullBlock>(nullptr);
+}
+
+void OrphanPool::RemoveOrphan(const uint64_t height, const Hash& hash)
+{
+	if (IsOrphan(height, hash))
 	{
-		for (auto orphanIter = heightIter->second.cbegin(); orphanIter != heightIter->second.cend(); orphanIter++)
+		RemoveEntry(hash);
+	}
+}
+
+std::vector<std::shared_ptr<const FullBlock>> OrphanPool::GetChildren(const Hash& previousHash) const
+{
+	std::vector<std::shared_ptr<const FullBlock>> children;
+
+	auto iter = m_orphansByPreviousHash.find(previousHash);
+	if (iter != m_orphansByPreviousHash.cend())
+	{
+		for (const Hash& hash : iter->second)
 		{
-			if (orphanIter->GetHash() == block.GetHash())
-			{
-				return;
-			}
+			children.push_back(m_orphansByHash.at(hash).orphan.GetBlock());
 		}
+	}
+
+	return children;
+}
+
+OrphanPoolStats OrphanPool::GetStats() const
+{
+	return OrphanPoolStats{ m_orphansByHash.size(), m_numBytes, m_maxBytes, m_numEvicted, m_numRejected };
+}
+
+OrphanPool::EvictionKey OrphanPool::GetEvictionKey(const uint64_t height, const uint64_t sequence) const noexcept
+{
+	if (height <= m_confirmedHeight)
+	{
+		return EvictionKey{ false, height, sequence };
+	}
+
+	return EvictionKey{ true, UINT64_MAX - height, sequence };
+}
 
-		heightIter->second.emplace_back(Orphan(block));
+void OrphanPool::UpdateConfirmedHeight(const uint64_t confirmedHeight)
+{
+	if (confirmedHeight == m_confirmedHeight)
+	{
+		return;
 	}
-	else
+
+	auto begin = m_orphansByHeight.upper_bound((std::min)(confirmedHeight, m_confirmedHeight));
+	auto end = m_orphansByHeight.upper_bound((std::max)(confirmedHeight, m_confirmedHeight));
+	for (auto iter = begin; iter != end; iter++)
+	{
+		RemoveFromEvictionIndex(m_orphansByHash.at(iter->second));
+	}
+
+	m_confirmedHeight = confirmedHeight;
+
+	for (auto iter = begin; iter != end; iter++)
 	{
-		m_orphansByHeight[block.GetHeight()] = std::vector<Orphan>({ Orphan(block) });
+		AddToEvictionIndex(iter->second, m_orphansByHash.at(iter->second));
 	}
 }
 
-std::shared_ptr<const FullBlock> OrphanPool::GetOrphanBlock(const uint64_t height, const Hash& hash) const
+bool OrphanPool::FindEvictions(
+	const uint64_t height,
+	const uint64_t numBytes,
+	const std::string& source,
+	std::vector<Hash>& evictions) const
 {
-	auto heightIter = m_orphansByHeight.find(height);
-	if (heightIter != m_orphansByHeight.cend())
+	auto sourceIter = source.empty() ? m_bytesBySource.cend() : m_bytesBySource.find(source);
+	uint64_t sourceBytes = sourceIter != m_bytesBySource.cend() ? sourceIter->second : 0;
+	uint64_t totalBytes = m_numBytes;
+
+	const bool overSourceBudget = !source.empty() && sourceBytes + numBytes > m_maxBytesPerSource;
+	if (!overSourceBudget && totalBytes + numBytes <= m_maxBytes)
+	{
+		return true;
+	}
+
+	// Don't evict anything that's closer to being connected than the new block.
+	const EvictionKey key = GetEvictionKey(height, m_nextSequence);
+
+	// The source's orphans are evicted in the same order as the whole pool's,
+	// so the ones evicted for its quota are exactly those up to the last one.
+	std::optional<EvictionKey> lastSourceEviction = std::nullopt;
+	if (overSourceBudget)
 	{
-		for (auto orphanIter = heightIter->second.cbegin(); orphanIter != heightIter->second.cend(); orphanIter++)
+		auto sourceIndexIter = m_evictionIndexBySource.find(source);
+		if (sourceIndexIter != m_evictionIndexBySource.cend())
 		{
-			if (orphanIter->GetHash() == hash)
+			for (const auto& indexed : sourceIndexIter->second)
 			{
-				return orphanIter->GetBlock();
+				if (sourceBytes + numBytes <= m_maxBytesPerSource)
+				{
+					break;
+				}
+
+				if (indexed.first.IsCloserThan(key))
+				{
+					return false;
+				}
+
+				const uint64_t entryBytes = m_orphansByHash.at(indexed.second).numBytes;
+				evictions.push_back(indexed.second);
+				lastSourceEviction = indexed.first;
+				sourceBytes -= entryBytes;
+				totalBytes -= entryBytes;
 			}
 		}
+
+		if (sourceBytes + numBytes > m_maxBytesPerSource)
+		{
+			return false;
+		}
 	}
 
-	return std::shared_ptr<const FullBlock>(nullptr);
+	for (auto iter = m_evictionIndex.cbegin(); iter != m_evictionIndex.cend() && totalBytes + numBytes > m_maxBytes; iter++)
+	{
+		const Entry& entry = m_orphansByHash.at(iter->second);
+		if (lastSourceEviction.has_value() && entry.source == source && !(lastSourceEviction.value() < iter->first))
+		{
+			continue;
+		}
+
+		if (iter->first.IsCloserThan(key))
+		{
+			return false;
+		}
+
+		evictions.push_back(iter->second);
+		totalBytes -= entry.numBytes;
+	}
+
+	return totalBytes + numBytes <= m_maxBytes;
+}
+
+void OrphanPool::AddToEvictionIndex(const Hash& hash, const Entry& entry)
+{
+	const EvictionKey key = GetEvictionKey(entry.orphan.GetHeight(), entry.sequence);
+	m_evictionIndex.emplace(key, hash);
+	if (!entry.source.empty())
+	{
+		m_evictionIndexBySource[entry.source].emplace(key, hash);
+	}
 }
 
-std::shared_ptr<const FullBlock> OrphanPool::GetNextOrphanBlock(const uint64_t height, const Hash& previousHash) const
+void OrphanPool::RemoveFromEvictionIndex(const Entry& entry)
 {
-	auto heightIter = m_orphansByHeight.find(height);
-	if (heightIter != m_orphansByHeight.cend())
+	const EvictionKey key = GetEvictionKey(entry.orphan.GetHeight(), entry.sequence);
+	m_evictionIndex.erase(key);
+	if (!entry.source.empty())
 	{
-		for (auto orphanIter = heightIter->second.cbegin(); orphanIter != heightIter->second.cend(); orphanIter++)
+		auto sourceIter = m_evictionIndexBySource.find(entry.source);
+		if (sourceIter != m_evictionIndexBySource.end())
 		{
-			if (orphanIter->GetBlock()->GetPreviousHash() == previousHash)
+			sourceIter->second.erase(key);
+			if (sourceIter->second.empty())
 			{
-				return orphanIter->GetBlock();
+				m_evictionIndexBySource.erase(sourceIter);
 			}
 		}
 	}
-
-	return std::shared_ptr<const FullBlock>(nullptr);
 }
 
-void OrphanPool::RemoveOrphan(const uint64_t height, const Hash& hash)
+void OrphanPool::RemoveEntry(const Hash& hash)
 {
-	auto iter = m_orphansByHeight.find(height);
-	if (iter != m_orphansByHeight.end())
+	auto iter = m_orphansByHash.find(hash);
+	if (iter == m_orphansByHash.end())
+	{
+		return;
+	}
+
+	const Entry& entry = iter->second;
+	const uint64_t height = entry.orphan.GetHeight();
+	RemoveFromEvictionIndex(entry);
+
+	auto childrenIter = m_orphansByPreviousHash.find(entry.orphan.GetBlock()->GetPreviousHash());
+	if (childrenIter != m_orphansByPreviousHash.end())
 	{
-		for (auto orphanIter = iter->second.begin(); orphanIter != iter->second.end(); orphanIter++)
+		auto& children = childrenIter->second;
+		children.erase(std::remove(children.begin(), children.end(), hash), children.end());
+		if (children.empty())
 		{
-			if (orphanIter->GetHash() == hash)
-			{
-				iter->second.erase(orphanIter);
-				break;
-			}
+			m_orphansByPreviousHash.erase(childrenIter);
 		}
+	}
 
-		if (iter->second.empty())
+	auto range = m_orphansByHeight.equal_range(height);
+	for (auto heightIter = range.first; heightIter != range.second; heightIter++)
+	{
+		if (heightIter->second == hash)
 		{
-			m_orphansByHeight.erase(height);
+			m_orphansByHeight.erase(heightIter);
+			break;
 		}
 	}
+
+	if (!entry.source.empty())
+	{
+		auto sourceIter = m_bytesBySource.find(entry.source);
+		if (sourceIter != m_bytesBySource.end())
+		{
+			sourceIter->second -= entry.numBytes;
+			if (sourceIter->second == 0)
+			{
+				m_bytesBySource.erase(sourceIter);
+			}
+		}
+	}
+
+	m_numBytes -= entry.numBytes;
+	m_orphansByHash.erase(iter);
 }
 
 BlockHeaderPtr OrphanPool::GetOrphanHeader(const Hash& hash) const
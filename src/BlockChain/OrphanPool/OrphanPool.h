@@ -4,24 +4,108 @@
 
 #include <Crypto/Hash.h>
 #include <Core/Models/FullBlock.h>
+#include <BlockChain/OrphanPoolStats.h>
 #include <unordered_map>
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
 #include <caches/Cache.h>
 
+//
+// Holds blocks that can't be connected to the confirmed chain yet, indexed by hash, by previous hash, and by height.
+// The pool is bounded by a memory budget (measured in serialized bytes), and each source (peer) may only use part of it.
+// When full, orphans at or below the confirmed height are evicted first, since they can no longer connect.
+// After those, orphans furthest above the confirmed height are evicted first, oldest first among equals,
+// since they're the least likely to be connected soon.
+//
 class OrphanPool
 {
 public:
-	OrphanPool();
+	OrphanPool(const uint64_t maxBytes, const uint64_t maxBytesPerSource);
 
 	bool IsOrphan(const uint64_t height, const Hash& hash) const;
-	void AddOrphanBlock(const FullBlock& block);
+
+	//
+	// Adds the block, evicting other orphans if needed to stay within budget.
+	// Returns false if the block was turned away, because it's further from the chain than everything it would have to evict.
+	// Nothing is evicted unless the block is accepted. An empty source is never subject to a per-source quota.
+	//
+	bool AddOrphanBlock(const FullBlock& block, const uint64_t confirmedHeight, const std::string& source = "");
 	std::shared_ptr<const FullBlock> GetOrphanBlock(const uint64_t height, const Hash& hash) const;
-	std::shared_ptr<const FullBlock> GetNextOrphanBlock(const uint64_t height, const Hash& previousHash) const;
 	void RemoveOrphan(const uint64_t height, const Hash& hash);
 
+	// Returns the orphans that build directly on the given block.
+	std::vector<std::shared_ptr<const FullBlock>> GetChildren(const Hash& previousHash) const;
+	bool IsEmpty() const noexcept { return m_orphansByHash.empty(); }
+
+	OrphanPoolStats GetStats() const;
+
 	void AddOrphanHeader(BlockHeaderPtr pHeader);
 	BlockHeaderPtr GetOrphanHeader(const Hash& hash) const;
 
 private:
-	std::unordered_map<uint64_t, std::vector<Orphan>> m_orphansByHeight;
+	//
+	// Position of an orphan in the eviction order. Lower keys are evicted first.
+	//
+	struct EvictionKey
+	{
+		bool live; // Above the confirmed height, so it may still be connected.
+		uint64_t rank; // The height for stale orphans, so the lowest go first, and its inverse for live ones, so the highest go first.
+		uint64_t sequence; // Insertion order, so older orphans are evicted first among equals.
+
+		bool operator<(const EvictionKey& rhs) const noexcept
+		{
+			return std::tie(live, rank, sequence) < std::tie(rhs.live, rhs.rank, rhs.sequence);
+		}
+
+		bool IsCloserThan(const EvictionKey& rhs) const noexcept
+		{
+			return std::tie(live, rank) > std::tie(rhs.live, rhs.rank);
+		}
+	};
+
+	struct Entry
+	{
+		Orphan orphan;
+		std::string source;
+		uint64_t numBytes;
+		uint64_t sequence;
+	};
+
+	EvictionKey GetEvictionKey(const uint64_t height, const uint64_t sequence) const noexcept;
+
+	// Re-keys the orphans whose heights are between the old and new confirmed heights, since only they change from live to stale (or back).
+	void UpdateConfirmedHeight(const uint64_t confirmedHeight);
+
+	// Finds the orphans that must be evicted, first from the source's quota and then from the whole pool, for the block to fit.
+	// Returns false, without evicting anything, if that would mean evicting an orphan closer to the chain than the block.
+	bool FindEvictions(
+		const uint64_t height,
+		const uint64_t numBytes,
+		const std::string& source,
+		std::vector<Hash>& evictions
+	) const;
+	void AddToEvictionIndex(const Hash& hash, const Entry& entry);
+	void RemoveFromEvictionIndex(const Entry& entry);
+	void RemoveEntry(const Hash& hash);
+
+	const uint64_t m_maxBytes;
+	const uint64_t m_maxBytesPerSource;
+
+	std::unordered_map<Hash, Entry> m_orphansByHash;
+	std::unordered_map<Hash, std::vector<Hash>> m_orphansByPreviousHash;
+	std::multimap<uint64_t, Hash> m_orphansByHeight; // Orphans with the same height are kept in insertion order.
+	std::unordered_map<std::string, uint64_t> m_bytesBySource;
+	uint64_t m_numBytes;
+
+	std::map<EvictionKey, Hash> m_evictionIndex;
+	std::unordered_map<std::string, std::map<EvictionKey, Hash>> m_evictionIndexBySource;
+	uint64_t m_confirmedHeight;
+	uint64_t m_nextSequence;
+
+	uint64_t m_numEvicted;
+	uint64_t m_numRejected;
+
 	LRUCache<Hash, BlockHeaderPtr> m_orphanHeadersByHash;
-};
+};
\ No newline at end of file
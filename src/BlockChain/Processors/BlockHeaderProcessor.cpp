@@ -5,10 +5,14 @@
 #include <Core/Exceptions/BlockChainException.h>
 #include <Infrastructure/Logger.h>
 #include <PMMR/HeaderMMR.h>
+#include <PoW/PoWManager.h>
 #include <Common/Util/HexUtil.h>
 #include <Common/Util/StringUtil.h>
+#include <Common/WorkStealingPool.h>
+#include <atomic>
 
 static const size_t SYNC_BATCH_SIZE = 128;
+static const size_t MIN_CYCLES_PER_CHUNK = 16;
 
 BlockHeaderProcessor::BlockHeaderProcessor(const Config& config, std::shared_ptr<Locked<ChainState>> pChainState)
 	: m_config(config), m_pChainState(pChainState)
@@ -106,7 +110,7 @@ EBlockChainStatus BlockHeaderProcessor::ProcessOrphan(Writer<ChainState> pLocked
 	pHeaderMMR->Rewind(reorgHeaders.front()->GetHeight());
 
 	// Validate each header and add it to the MMR & BlockDB
-	ValidateHeaders(pLockedState, reorgHeaders);
+	ValidateHeaders(pLockedState, reorgHeaders, false);
 
 	if (pHeader->GetTotalDifficulty() <= totalDifficulty)
 	{
@@ -137,7 +141,7 @@ EBlockChainStatus BlockHeaderProcessor::ProcessOrphan(Writer<ChainState> pLocked
 	return EBlockChainStatus::SUCCESS;
 }
 
-EBlockChainStatus BlockHeaderProcessor::ProcessSyncHeaders(const std::vector<BlockHeaderPtr>& headers)
+EBlockChainStatus BlockHeaderProcessor::ProcessSyncHeaders(const std::vector<BlockHeaderPtr>& headers, const bool cyclesVerified)
 {
 	if (headers.empty())
 	{
@@ -160,6 +164,11 @@ EBlockChainStatus BlockHeaderProcessor::ProcessSyncHeaders(const std::vector<Blo
 		}
 	}
 
+	if (!cyclesVerified && !VerifyCycles(headers))
+	{
+		throw BAD_DATA_EXCEPTION("Invalid proof of work.");
+	}
+
 	const size_t size = headers.size();
 	size_t index = 0;
 
@@ -214,8 +223,8 @@ EBlockChainStatus BlockHeaderProcessor::ProcessChunkedSyncHeaders(const std::vec
 	// Rewind MMR
 	RewindMMR(pLockedState, newHeaders);
 
-	// Validate the headers.
-	ValidateHeaders(pLockedState, newHeaders);
+	// Validate the headers. The cycles were already checked by ProcessSyncHeaders.
+	ValidateHeaders(pLockedState, newHeaders, true);
 
 	// Add the headers to the sync chain.
 	AddSyncHeaders(pLockedState, newHeaders);
@@ -276,6 +285,8 @@ void BlockHeaderProcessor::RewindMMR(Writer<ChainState> pLockedState, const std:
 	if (pCommonIndex->GetHeight() < (firstHeight - 1))
 	{
 		pHeaderMMR->Rewind(pCommonIndex->GetHeight() + 1);
+
+		std::vector<BlockHeaderPtr> headersToAdd;
 		for (size_t height = pCommonIndex->GetHeight() + 1; height < firstHeight; height++)
 		{
 			auto pHeader = pLockedState->GetBlockHeaderByHeight(height, EChainType::SYNC);
@@ -284,8 +295,10 @@ void BlockHeaderProcessor::RewindMMR(Writer<ChainState> pLockedState, const std:
 				throw BLOCK_CHAIN_EXCEPTION("Failed to retrieve header");
 			}
 
-			pHeaderMMR->AddHeader(*pHeader);
+			headersToAdd.push_back(pHeader);
 		}
+
+		pHeaderMMR->AddHeaders(headersToAdd);
 	}
 	else
 	{
@@ -293,7 +306,7 @@ void BlockHeaderProcessor::RewindMMR(Writer<ChainState> pLockedState, const std:
 	}
 }
 
-void BlockHeaderProcessor::ValidateHeaders(Writer<ChainState> pLockedState, const std::vector<BlockHeaderPtr>& headers)
+void BlockHeaderProcessor::ValidateHeaders(Writer<ChainState> pLockedState, const std::vector<BlockHeaderPtr>& headers, const bool cyclesVerified)
 {
 	LOG_TRACE("Validating headers");
 
@@ -309,15 +322,19 @@ void BlockHeaderProcessor::ValidateHeaders(Writer<ChainState> pLockedState, cons
 		throw BLOCK_CHAIN_EXCEPTION("Failed to retrieve previous header");
 	}
 
+	// All headers are added to the MMR up front, so their hashes are calculated in parallel.
+	// Each header's previous root is still checked against the MMR as of the previous header,
+	// and any invalid header causes the whole batch to be rolled back.
+	pHeaderMMR->AddHeaders(headers);
+
 	for (auto pHeader : headers)
 	{
-		if (!validator.IsValidHeader(*pHeader, *pPreviousHeader))
+		if (!validator.IsValidHeader(*pHeader, *pPreviousHeader, cyclesVerified))
 		{
 			LOG_ERROR_F("Header invalid: {}", *pHeader);
 			throw BAD_DATA_EXCEPTION("Header invalid.");
 		}
 
-		pHeaderMMR->AddHeader(*pHeader);
 		pBlockDB->AddBlockHeader(pHeader);
 		pPreviousHeader = pHeader;
 	}
@@ -348,4 +365,25 @@ void BlockHeaderProcessor::AddSyncHeaders(Writer<ChainState> pLockedState, const
 	{
 		pSyncChain->AddBlock(pHeader->GetHash());
 	}
+}
+
+bool BlockHeaderProcessor::VerifyCycles(const std::vector<BlockHeaderPtr>& headers) const
+{
+	// Cycle validation doesn't use the block database.
+	const PoWManager powManager(m_config, nullptr);
+
+	std::atomic_bool valid = true;
+	WorkStealingPool::GetShared().ParallelFor(headers.size(), MIN_CYCLES_PER_CHUNK, [&headers, &powManager, &valid](const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end && valid; i++)
+		{
+			if (!powManager.IsCycleValid(*headers[i]))
+			{
+				LOG_WARNING_F("Invalid cuckoo cycle for header {}", *headers[i]);
+				valid = false;
+			}
+		}
+	});
+
+	return valid;
 }
\ No newline at end of file
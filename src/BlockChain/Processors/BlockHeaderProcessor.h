@@ -22,11 +22,18 @@ public:
 	//
 	// Validates and adds multiple headers to the sync chain.
 	// The headers are also added to the candidate chain if total difficulty increases.
+	// Cuckoo cycles are checked before the chain is locked, unless cyclesVerified is true.
 	//
 	// Throws BadDataException if any of the headers are invalid.
 	// Throws BlockChainException if any other errors occur.
 	//
-	EBlockChainStatus ProcessSyncHeaders(const std::vector<BlockHeaderPtr>& headers);
+	EBlockChainStatus ProcessSyncHeaders(const std::vector<BlockHeaderPtr>& headers, const bool cyclesVerified = false);
+
+	//
+	// Checks the cuckoo cycles of the headers on the shared worker pool, without touching the chain state.
+	// Returns false if any are invalid.
+	//
+	bool VerifyCycles(const std::vector<BlockHeaderPtr>& headers) const;
 
 private:
 	EBlockChainStatus ProcessOrphan(
@@ -50,7 +57,8 @@ private:
 
 	void ValidateHeaders(
 		Writer<ChainState> pLockedState,
-		const std::vector<BlockHeaderPtr>& headers
+		const std::vector<BlockHeaderPtr>& headers,
+		const bool cyclesVerified
 	);
 
 	void AddSyncHeaders(
@@ -17,7 +17,7 @@ BlockProcessor::BlockProcessor(const Config& config, std::shared_ptr<Locked<Chai
 
 }
 
-EBlockChainStatus BlockProcessor::ProcessBlock(const FullBlock& block)
+EBlockChainStatus BlockProcessor::ProcessBlock(const FullBlock& block, const std::string& source)
 {	
 	const uint64_t candidateHeight = m_pChainState->Read()->GetHeight(EChainType::CANDIDATE);
 	const uint64_t horizonHeight = Consensus::GetHorizonHeight(candidateHeight);
@@ -38,7 +38,7 @@ EBlockChainStatus BlockProcessor::ProcessBlock(const FullBlock& block)
 		// Verify block is self-consistent before locking
 		BlockValidator::VerifySelfConsistent(block);
 
-		const EBlockChainStatus returnStatus = ProcessBlockInternal(block);
+		const EBlockChainStatus returnStatus = ProcessBlockInternal(block, source);
 		if (returnStatus == EBlockChainStatus::SUCCESS)
 		{
 			LOG_DEBUG_F("Block {} successfully processed.", *pHeader);
@@ -50,7 +50,130 @@ EBlockChainStatus BlockProcessor::ProcessBlock(const FullBlock& block)
 	return headerStatus;
 }
 
-EBlockChainStatus BlockProcessor::ProcessBlockInternal(const FullBlock& block)
+size_t BlockProcessor::ProcessOrphanGroup(const size_t maxBlocks, const std::chrono::milliseconds& maxDuration)
+{
+	const auto deadline = std::chrono::steady_clock::now() + maxDuration;
+
+	// 1. Collect the orphans that extend the confirmed chain, holding only a read lock.
+	std::vector<std::shared_ptr<const FullBlock>> candidates;
+	{
+		auto pReader = m_pChainState->Read();
+		auto pChainStore = pReader->GetChainStore();
+		auto pOrphanPool = pReader->GetOrphanPool();
+		auto pCandidateChain = pChainStore->GetCandidateChain();
+		auto pConfirmedChain = pChainStore->GetConfirmedChain();
+
+		Hash previousHash = pConfirmedChain->GetTipHash();
+		uint64_t height = pConfirmedChain->GetHeight() + 1;
+		while (candidates.size() < maxBlocks)
+		{
+			auto pCandidateIndex = pCandidateChain->GetByHeight(height);
+			if (pCandidateIndex == nullptr)
+			{
+				break;
+			}
+
+			auto pBlock = pOrphanPool->GetOrphanBlock(height, pCandidateIndex->GetHash());
+			if (pBlock == nullptr || pBlock->GetPreviousHash() != previousHash)
+			{
+				break;
+			}
+
+			candidates.push_back(pBlock);
+			previousHash = pBlock->GetHash();
+			height++;
+		}
+	}
+
+	// 2. Verify them without holding any lock. Blocks left unverified at the deadline are left for the next group.
+	size_t numVerified = 0;
+	while (numVerified < candidates.size() && (numVerified == 0 || std::chrono::steady_clock::now() < deadline))
+	{
+		BlockValidator::VerifySelfConsistent(*candidates[numVerified]);
+		numVerified++;
+	}
+
+	candidates.resize(numVerified);
+	if (candidates.empty())
+	{
+		return 0;
+	}
+
+	// 3. Apply and commit them under the write lock, stopping at the first block the chain has since moved past.
+	auto pBatch = m_pChainState->BatchWrite();
+	auto pChainStore = pBatch->GetChainStore();
+	auto pOrphanPool = pBatch->GetOrphanPool();
+	auto pCandidateChain = pChainStore->GetCandidateChain();
+	auto pConfirmedChain = pChainStore->GetConfirmedChain();
+
+	std::vector<std::shared_ptr<const FullBlock>> blocksApplied;
+	bool committing = false;
+	try
+	{
+		for (const auto& pBlock : candidates)
+		{
+			if (pBlock->GetPreviousHash() != pConfirmedChain->GetTipHash()
+				|| !pCandidateChain->IsOnChain(pBlock->GetHeight(), pBlock->GetHash()))
+			{
+				break;
+			}
+
+			ValidateAndAddBlock(*pBlock, pBatch);
+			pConfirmedChain->AddBlock(pBlock->GetHash());
+			blocksApplied.push_back(pBlock);
+		}
+
+		if (!blocksApplied.empty())
+		{
+			committing = true;
+			pBatch->Commit();
+			LOG_DEBUG_F(
+				"Committed {} blocks ({} - {}) as a group.",
+				blocksApplied.size(),
+				blocksApplied.front()->GetHeight(),
+				blocksApplied.back()->GetHeight()
+			);
+		}
+	}
+	catch (std::exception& e)
+	{
+		if (committing)
+		{
+			LOG_WARNING_F(
+				"Failed to commit group of {} candidates ({} - {}): {}",
+				candidates.size(),
+				blocksApplied.front()->GetHeight(),
+				blocksApplied.back()->GetHeight(),
+				e.what()
+			);
+		}
+		else
+		{
+			// Blocks are only added to blocksApplied once applied, so the failing block is the next candidate.
+			LOG_WARNING_F(
+				"Failed to apply block at height {} from group of {} candidates: {}",
+				candidates[blocksApplied.size()]->GetHeight(),
+				candidates.size(),
+				e.what()
+			);
+		}
+
+		pBatch->Rollback();
+		for (const auto& pBlock : blocksApplied)
+		{
+			if (!pOrphanPool->AddOrphanBlock(*pBlock, pConfirmedChain->GetHeight()))
+			{
+				LOG_WARNING_F("No room in orphan pool for {}. It will need to be downloaded again.", *pBlock);
+			}
+		}
+
+		throw;
+	}
+
+	return blocksApplied.size();
+}
+
+EBlockChainStatus BlockProcessor::ProcessBlockInternal(const FullBlock& block, const std::string& source)
 {
 	auto pBatch = m_pChainState->BatchWrite();
 	auto pChainStore = pBatch->GetChainStore();
@@ -76,7 +199,11 @@ EBlockChainStatus BlockProcessor::ProcessBlockInternal(const FullBlock& block)
 			return EBlockChainStatus::ALREADY_EXISTS;
 		}
 
-		pOrphanPool->AddOrphanBlock(block);
+		if (!pOrphanPool->AddOrphanBlock(block, pConfirmedChain->GetHeight(), source))
+		{
+			LOG_INFO_F("No room in orphan pool for {} from {}", block, source);
+			return EBlockChainStatus::ORPHAN_REJECTED;
+		}
 
 		return EBlockChainStatus::ORPHANED;
 	}
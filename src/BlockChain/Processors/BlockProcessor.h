@@ -5,6 +5,7 @@
 #include <Config/Config.h>
 #include <Core/Models/FullBlock.h>
 #include <BlockChain/BlockChainStatus.h>
+#include <chrono>
 
 enum class EBlockStatus
 {
@@ -23,10 +24,23 @@ class BlockProcessor
 public:
 	BlockProcessor(const Config& config, std::shared_ptr<Locked<ChainState>> pChainState);
 
-	EBlockChainStatus ProcessBlock(const FullBlock& block);
+	//
+	// The source identifies the peer the block came from, so it can be held to its orphan quota.
+	// Returns ORPHAN_REJECTED if the block is an orphan that the orphan pool had no room for.
+	//
+	EBlockChainStatus ProcessBlock(const FullBlock& block, const std::string& source = "");
+
+	//
+	// Applies consecutive orphan blocks that extend the confirmed chain, and commits them as a single group.
+	// The group is closed once maxBlocks have been applied, or once maxDuration has elapsed.
+	// Blocks are verified before the write lock is taken, so the lock is only held while they're applied.
+	// If any block fails, the entire group is rolled back and its blocks are returned to the orphan pool,
+	// so they can be processed individually. Returns the number of blocks committed.
+	//
+	size_t ProcessOrphanGroup(const size_t maxBlocks, const std::chrono::milliseconds& maxDuration);
 
 private:
-	EBlockChainStatus ProcessBlockInternal(const FullBlock& block);
+	EBlockChainStatus ProcessBlockInternal(const FullBlock& block, const std::string& source);
 	void HandleReorg(Writer<ChainState> pBatch, const std::vector<FullBlock::CPtr>& reorgBlocks);
 	void ValidateAndAddBlock(const FullBlock& block, Writer<ChainState> pLockedState);
 
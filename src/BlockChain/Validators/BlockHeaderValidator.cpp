@@ -18,7 +18,7 @@ BlockHeaderValidator::BlockHeaderValidator(
 
 }
 
-bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader) const
+bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader, const bool cycleVerified) const
 {
 	// Validate Height
 	if (header.GetHeight() != (previousHeader.GetHeight() + 1))
@@ -50,7 +50,8 @@ bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockH
 	}
 
 	// Validate Proof Of Work
-	const bool validPoW = PoWManager(m_config, m_pBlockDB).IsPoWValid(header, previousHeader);
+	const PoWManager powManager(m_config, m_pBlockDB);
+	const bool validPoW = cycleVerified ? powManager.IsDifficultyValid(header, previousHeader) : powManager.IsPoWValid(header, previousHeader);
 	if (!validPoW)
 	{
 		LOG_WARNING_F("Invalid Proof of Work for header {}", header);
@@ -12,7 +12,11 @@ class BlockHeaderValidator
 public:
 	BlockHeaderValidator(const Config& config, std::shared_ptr<const IBlockDB> pBlockDB, std::shared_ptr<const IHeaderMMR> pHeaderMMR);
 
-	bool IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader) const;
+	//
+	// Validates the header against the previous header and the header MMR.
+	// If cycleVerified is true, the cuckoo cycle is assumed to have already been checked with PoWManager::IsCycleValid.
+	//
+	bool IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader, const bool cycleVerified = false) const;
 
 	const Config& m_config;
 	std::shared_ptr<const IBlockDB> m_pBlockDB;
@@ -58,6 +58,12 @@ void BlockHeader::Serialize(Serializer& serializer) const
 	m_proofOfWork.Serialize(serializer);
 }
 
+size_t BlockHeader::GetSerializedSize() const
+{
+	// version, height, timestamp, 5 hashes, offset, 2 MMR sizes, total difficulty, scaling difficulty, nonce
+	return 2 + 8 + 8 + (5 * 32) + 32 + 8 + 8 + 8 + 4 + 8 + m_proofOfWork.GetSerializedSize();
+}
+
 BlockHeader BlockHeader::Deserialize(ByteBuffer& byteBuffer)
 {
 	const uint16_t version = byteBuffer.ReadU16();
@@ -40,6 +40,22 @@ void CompactBlock::Serialize(Serializer& serializer) const
 	}
 }
 
+size_t CompactBlock::GetSerializedSize() const
+{
+	size_t size = m_pBlockHeader->GetSerializedSize() + 8 + (3 * 8);
+	for (const TransactionOutput& output : m_outputs)
+	{
+		size += output.GetSerializedSize();
+	}
+
+	for (const TransactionKernel& kernel : m_kernels)
+	{
+		size += kernel.GetSerializedSize();
+	}
+
+	return size + (m_shortIds.size() * 6);
+}
+
 CompactBlock CompactBlock::Deserialize(ByteBuffer& byteBuffer)
 {
 	BlockHeaderPtr pBlockHeader = std::make_shared<const BlockHeader>(BlockHeader::Deserialize(byteBuffer));
@@ -12,6 +12,11 @@ void FullBlock::Serialize(Serializer& serializer) const
 	m_transactionBody.Serialize(serializer);
 }
 
+size_t FullBlock::GetSerializedSize() const
+{
+	return m_pBlockHeader->GetSerializedSize() + m_transactionBody.GetSerializedSize();
+}
+
 FullBlock FullBlock::Deserialize(ByteBuffer& byteBuffer)
 {
 	BlockHeaderPtr pBlockHeader = std::make_shared<const BlockHeader>(BlockHeader::Deserialize(byteBuffer));
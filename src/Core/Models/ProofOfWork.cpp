@@ -25,6 +25,11 @@ void ProofOfWork::Serialize(Serializer& serializer) const
 	SerializeCycle(serializer);
 }
 
+size_t ProofOfWork::GetSerializedSize() const
+{
+	return 1 + (((m_edgeBits * Consensus::PROOFSIZE) + 7) / 8);
+}
+
 void ProofOfWork::SerializeCycle(Serializer& serializer) const
 {
 	const int bytes_len = ((m_edgeBits * Consensus::PROOFSIZE) + 7) / 8;
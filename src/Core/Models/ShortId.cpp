@@ -35,6 +35,11 @@ void ShortId::Serialize(Serializer& serializer) const
 	serializer.AppendBigInteger<6>(m_id);
 }
 
+size_t ShortId::GetSerializedSize() const
+{
+	return 6;
+}
+
 ShortId ShortId::Deserialize(ByteBuffer& byteBuffer)
 {
 	CBigInteger<6> id = byteBuffer.ReadVector(6);
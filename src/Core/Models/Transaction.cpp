@@ -8,7 +8,7 @@ Transaction::Transaction(BlindingFactor&& offset, TransactionBody&& transactionB
 	: m_offset(std::move(offset)),
 	m_transactionBody(std::move(transactionBody))
 {
-	Serializer serializer;
+	Serializer serializer(GetSerializedSize());
 	Serialize(serializer);
 
 	m_hash = Crypto::Blake2b(serializer.GetBytes());
@@ -24,6 +24,11 @@ void Transaction::Serialize(Serializer& serializer) const
 	m_transactionBody.Serialize(serializer);
 }
 
+size_t Transaction::GetSerializedSize() const
+{
+	return 32 + m_transactionBody.GetSerializedSize();
+}
+
 Transaction Transaction::Deserialize(ByteBuffer& byteBuffer)
 {
 	// Read BlindingFactor/Offset (32 bytes)
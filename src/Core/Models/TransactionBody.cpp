@@ -16,24 +16,45 @@ void TransactionBody::Serialize(Serializer& serializer) const
 	serializer.Append<uint64_t>(m_kernels.size());
 
 	// Serialize Inputs
-	for (auto input : m_inputs)
+	for (const TransactionInput& input : m_inputs)
 	{
 		input.Serialize(serializer);
 	}
 
 	// Serialize Outputs
-	for (auto output : m_outputs)
+	for (const TransactionOutput& output : m_outputs)
 	{
 		output.Serialize(serializer);
 	}
 
 	// Serialize Kernels
-	for (auto kernel : m_kernels)
+	for (const TransactionKernel& kernel : m_kernels)
 	{
 		kernel.Serialize(serializer);
 	}
 }
 
+size_t TransactionBody::GetSerializedSize() const
+{
+	size_t size = 3 * 8;
+	for (const TransactionInput& input : m_inputs)
+	{
+		size += input.GetSerializedSize();
+	}
+
+	for (const TransactionOutput& output : m_outputs)
+	{
+		size += output.GetSerializedSize();
+	}
+
+	for (const TransactionKernel& kernel : m_kernels)
+	{
+		size += kernel.GetSerializedSize();
+	}
+
+	return size;
+}
+
 TransactionBody TransactionBody::Deserialize(ByteBuffer& byteBuffer)
 {
 	const uint64_t numInputs = byteBuffer.ReadU64();
@@ -7,7 +7,7 @@
 TransactionInput::TransactionInput(const EOutputFeatures features, Commitment&& commitment)
 	: m_features(features), m_commitment(std::move(commitment))
 {
-	Serializer serializer;
+	Serializer serializer(GetSerializedSize());
 	Serialize(serializer);
 	m_hash = Crypto::Blake2b(serializer.GetBytes());
 }
@@ -21,6 +21,12 @@ void TransactionInput::Serialize(Serializer& serializer) const
 	m_commitment.Serialize(serializer);
 }
 
+size_t TransactionInput::GetSerializedSize() const
+{
+	// features, commitment
+	return 1 + 33;
+}
+
 TransactionInput TransactionInput::Deserialize(ByteBuffer& byteBuffer)
 {
 	// Read OutputFeatures (1 byte)
@@ -7,7 +7,7 @@
 TransactionKernel::TransactionKernel(const EKernelFeatures features, const uint64_t fee, const uint64_t lockHeight, Commitment&& excessCommitment, Signature&& excessSignature)
 	: m_features(features), m_fee(fee), m_lockHeight(lockHeight), m_excessCommitment(std::move(excessCommitment)), m_excessSignature(std::move(excessSignature))
 {
-	Serializer serializer;
+	Serializer serializer(GetSerializedSize());
 	Serialize(serializer);
 	m_hash = Crypto::Blake2b(serializer.GetBytes());
 }
@@ -30,6 +30,12 @@ void TransactionKernel::Serialize(Serializer& serializer) const
 	m_excessSignature.Serialize(serializer);
 }
 
+size_t TransactionKernel::GetSerializedSize() const
+{
+	// features, fee, lock height, excess commitment, excess signature
+	return 1 + 8 + 8 + 33 + 64;
+}
+
 TransactionKernel TransactionKernel::Deserialize(ByteBuffer& byteBuffer)
 {
 	// Read KernelFeatures (1 byte)
@@ -27,6 +27,12 @@ void TransactionOutput::Serialize(Serializer& serializer) const
 	m_rangeProof.Serialize(serializer);
 }
 
+size_t TransactionOutput::GetSerializedSize() const
+{
+	// features, commitment, rangeproof
+	return 1 + 33 + m_rangeProof.GetSerializedSize();
+}
+
 TransactionOutput TransactionOutput::Deserialize(ByteBuffer& byteBuffer)
 {
 	// Read OutputFeatures (1 byte)
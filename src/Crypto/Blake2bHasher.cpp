@@ -0,0 +1,45 @@
+#include <Crypto/Blake2bHasher.h>
+
+#include "ThirdParty/Blake2.h"
+
+static_assert(sizeof(blake2b_state) <= 256, "Blake2bHasher::m_state is too small for blake2b_state");
+
+Blake2bHasher::Blake2bHasher()
+{
+	Reset();
+}
+
+Blake2bHasher& Blake2bHasher::Write(const unsigned char* data, const size_t len)
+{
+	blake2b_update((blake2b_state*)m_state, data, len);
+	return *this;
+}
+
+Blake2bHasher& Blake2bHasher::WriteU64(const uint64_t value)
+{
+	unsigned char bytes[8];
+	for (size_t i = 0; i < 8; i++)
+	{
+		bytes[i] = (unsigned char)(value >> (56 - (8 * i)));
+	}
+
+	return Write(bytes, 8);
+}
+
+void Blake2bHasher::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+	blake2b_final((blake2b_state*)m_state, hash, OUTPUT_SIZE);
+}
+
+CBigInteger<32> Blake2bHasher::Finalize()
+{
+	CBigInteger<32> hash;
+	Finalize(hash.data());
+	return hash;
+}
+
+Blake2bHasher& Blake2bHasher::Reset()
+{
+	blake2b_init((blake2b_state*)m_state, OUTPUT_SIZE);
+	return *this;
+}
\ No newline at end of file
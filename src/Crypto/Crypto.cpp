@@ -39,6 +39,34 @@ CBigInteger<32> Crypto::Blake2b(const std::vector<unsigned char>& key, const std
 	return CBigInteger<32>(&tmp[0]);
 }
 
+std::vector<CBigInteger<32>> Crypto::Blake2bMulti(const std::vector<std::vector<unsigned char>>& inputs)
+{
+	const size_t count = inputs.size();
+	std::vector<CBigInteger<32>> hashes(count);
+	std::vector<const unsigned char*> in(count);
+	std::vector<size_t> inlen(count);
+	std::vector<unsigned char*> out(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		in[i] = inputs[i].data();
+		inlen[i] = inputs[i].size();
+		out[i] = hashes[i].data();
+	}
+
+	Blake2bMulti(in.data(), inlen.data(), out.data(), count);
+
+	return hashes;
+}
+
+void Crypto::Blake2bMulti(
+	const unsigned char* const* pInputs,
+	const size_t* pInputLengths,
+	unsigned char* const* pOutputs,
+	const size_t count)
+{
+	blake2b_multi(pOutputs, 32, pInputs, pInputLengths, count);
+}
+
 CBigInteger<32> Crypto::SHA256(const std::vector<unsigned char> & input)
 {
 	std::vector<unsigned char> sha256(32, 0);
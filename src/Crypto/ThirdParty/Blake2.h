@@ -161,6 +161,10 @@ extern "C" {
 	/* This is simply an alias for blake2b */
 	int blake2(void *out, size_t outlen, const void *in, size_t inlen, const void *key, size_t keylen);
 
+	/* Multi-buffer API: hashes count independent, unkeyed messages using the widest SIMD lanes the CPU supports */
+	int blake2b_multi(uint8_t *const *out, size_t outlen, const uint8_t *const *in, const size_t *inlen, size_t count);
+	size_t blake2b_multi_lanes(void);
+
 #if defined(__cplusplus)
 }
 #endif
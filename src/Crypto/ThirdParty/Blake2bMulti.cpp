@@ -0,0 +1,108 @@
+/*
+Runtime dispatch for the multi-buffer BLAKE2b API.
+The widest lane implementation supported by the CPU is selected once, and messages too long to fit in a single block,
+along with any leftover messages that don't fill a group of lanes, are hashed with the scalar implementation.
+*/
+
+#include "Blake2bMulti.h"
+
+#if BLAKE2B_MULTI_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+enum blake2b_multi_level
+{
+	BLAKE2B_MULTI_SCALAR = 0,
+	BLAKE2B_MULTI_SSE41 = 2,
+	BLAKE2B_MULTI_AVX2 = 4
+};
+
+static blake2b_multi_level blake2b_multi_detect()
+{
+#if BLAKE2B_MULTI_X86
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	const bool sse41 = (info[2] & (1 << 19)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+
+	bool avx2 = false;
+	if (osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#else
+	__builtin_cpu_init();
+	const bool sse41 = __builtin_cpu_supports("sse4.1");
+	const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+	if (avx2) {
+		return BLAKE2B_MULTI_AVX2;
+	}
+
+	if (sse41) {
+		return BLAKE2B_MULTI_SSE41;
+	}
+#endif
+
+	return BLAKE2B_MULTI_SCALAR;
+}
+
+static blake2b_multi_level blake2b_multi_get_level()
+{
+	static const blake2b_multi_level level = blake2b_multi_detect();
+	return level;
+}
+
+size_t blake2b_multi_lanes()
+{
+	const blake2b_multi_level level = blake2b_multi_get_level();
+	return level == BLAKE2B_MULTI_SCALAR ? 1 : (size_t)level;
+}
+
+int blake2b_multi(uint8_t *const *out, size_t outlen, const uint8_t *const *in, const size_t *inlen, size_t count)
+{
+	if (out == NULL || in == NULL || inlen == NULL) return -1;
+
+	if (!outlen || outlen > BLAKE2B_OUTBYTES) return -1;
+
+	const blake2b_multi_level level = blake2b_multi_get_level();
+	const size_t lanes = (size_t)level;
+
+	uint8_t *laneOut[4];
+	const uint8_t *laneIn[4];
+	size_t laneLen[4];
+	size_t numLanes = 0;
+
+	for (size_t i = 0; i < count; ++i) {
+		if (NULL == in[i] && inlen[i] > 0) return -1;
+
+		if (level == BLAKE2B_MULTI_SCALAR || inlen[i] > BLAKE2B_BLOCKBYTES) {
+			blake2b(out[i], outlen, in[i], inlen[i], NULL, 0);
+			continue;
+		}
+
+		laneOut[numLanes] = out[i];
+		laneIn[numLanes] = in[i];
+		laneLen[numLanes] = inlen[i];
+		if (++numLanes == lanes) {
+#if BLAKE2B_MULTI_X86
+			if (level == BLAKE2B_MULTI_AVX2) {
+				blake2b_multi_avx2(laneOut, outlen, laneIn, laneLen);
+			} else {
+				blake2b_multi_sse41(laneOut, outlen, laneIn, laneLen);
+			}
+#endif
+			numLanes = 0;
+		}
+	}
+
+	for (size_t i = 0; i < numLanes; ++i) {
+		blake2b(laneOut[i], outlen, laneIn[i], laneLen[i], NULL, 0);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*
+Multi-buffer BLAKE2b for short, unkeyed messages.
+
+Each lane hashes one independent message of at most BLAKE2B_BLOCKBYTES bytes, so every message is a single, final compression.
+The lane implementations live in their own translation units so they can be compiled with the matching instruction set flags,
+and are only ever called after the CPU has been checked for support (see Blake2bMulti.cpp).
+*/
+#ifndef BLAKE2B_MULTI_H
+#define BLAKE2B_MULTI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Blake2.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BLAKE2B_MULTI_X86 1
+#else
+#define BLAKE2B_MULTI_X86 0
+#endif
+
+static const uint64_t blake2b_multi_IV[8] =
+{
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
+	0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+	0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+	0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static const uint8_t blake2b_multi_sigma[12][16] =
+{
+	{ 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+	{ 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+	{ 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+	{ 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+	{ 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+	{ 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+	{ 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+	{ 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+	{ 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13 , 0 },
+	{ 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
+};
+
+/* Hashes exactly 4 messages (inlen[i] <= BLAKE2B_BLOCKBYTES). Requires AVX2. */
+void blake2b_multi_avx2(uint8_t *const *out, size_t outlen, const uint8_t *const *in, const size_t *inlen);
+
+/* Hashes exactly 2 messages (inlen[i] <= BLAKE2B_BLOCKBYTES). Requires SSE4.1. */
+void blake2b_multi_sse41(uint8_t *const *out, size_t outlen, const uint8_t *const *in, const size_t *inlen);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*
+2-lane BLAKE2b using SSE4.1. Each 128-bit register holds the same state word of 2 independent messages.
+This file must be compiled with SSE4.1 enabled (eg. -msse4.1), and is only called when the CPU supports it.
+*/
+
+#include "Blake2bMulti.h"
+#include "Blake2Impl.h"
+
+#if BLAKE2B_MULTI_X86
+
+#include <smmintrin.h>
+
+#define ROTR32(x) _mm_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define ROTR24(x) _mm_shuffle_epi8((x), r24)
+#define ROTR16(x) _mm_shuffle_epi8((x), r16)
+#define ROTR63(x) _mm_or_si128(_mm_srli_epi64((x), 63), _mm_add_epi64((x), (x)))
+
+#define G(r,i,a,b,c,d)                                                  \
+  do {                                                                  \
+    a = _mm_add_epi64(_mm_add_epi64(a, b), m[blake2b_multi_sigma[r][2*i+0]]); \
+    d = ROTR32(_mm_xor_si128(d, a));                                    \
+    c = _mm_add_epi64(c, d);                                            \
+    b = ROTR24(_mm_xor_si128(b, c));                                    \
+    a = _mm_add_epi64(_mm_add_epi64(a, b), m[blake2b_multi_sigma[r][2*i+1]]); \
+    d = ROTR16(_mm_xor_si128(d, a));                                    \
+    c = _mm_add_epi64(c, d);                                            \
+    b = ROTR63(_mm_xor_si128(b, c));                                    \
+  } while(0)
+
+#define ROUND(r)                    \
+  do {                              \
+    G(r,0,v[ 0],v[ 4],v[ 8],v[12]); \
+    G(r,1,v[ 1],v[ 5],v[ 9],v[13]); \
+    G(r,2,v[ 2],v[ 6],v[10],v[14]); \
+    G(r,3,v[ 3],v[ 7],v[11],v[15]); \
+    G(r,4,v[ 0],v[ 5],v[10],v[15]); \
+    G(r,5,v[ 1],v[ 6],v[11],v[12]); \
+    G(r,6,v[ 2],v[ 7],v[ 8],v[13]); \
+    G(r,7,v[ 3],v[ 4],v[ 9],v[14]); \
+  } while(0)
+
+void blake2b_multi_sse41(uint8_t *const *out, size_t outlen, const uint8_t *const *in, const size_t *inlen)
+{
+	const __m128i r24 = _mm_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+	const __m128i r16 = _mm_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+
+	/* Zero-padded final blocks */
+	uint8_t blocks[2][BLAKE2B_BLOCKBYTES];
+	for (size_t lane = 0; lane < 2; ++lane) {
+		memset(blocks[lane], 0, BLAKE2B_BLOCKBYTES);
+		if (inlen[lane] > 0) {
+			memcpy(blocks[lane], in[lane], inlen[lane]);
+		}
+	}
+
+	__m128i m[16];
+	for (size_t i = 0; i < 16; ++i) {
+		m[i] = _mm_set_epi64x((int64_t)load64(blocks[1] + i * 8), (int64_t)load64(blocks[0] + i * 8));
+	}
+
+	/* Parameter block: digest length, no key, fanout 1, depth 1 */
+	__m128i h[8];
+	h[0] = _mm_set1_epi64x((int64_t)(blake2b_multi_IV[0] ^ 0x01010000ULL ^ (uint64_t)outlen));
+	for (size_t i = 1; i < 8; ++i) {
+		h[i] = _mm_set1_epi64x((int64_t)blake2b_multi_IV[i]);
+	}
+
+	__m128i v[16];
+	for (size_t i = 0; i < 8; ++i) {
+		v[i] = h[i];
+	}
+
+	v[8] = _mm_set1_epi64x((int64_t)blake2b_multi_IV[0]);
+	v[9] = _mm_set1_epi64x((int64_t)blake2b_multi_IV[1]);
+	v[10] = _mm_set1_epi64x((int64_t)blake2b_multi_IV[2]);
+	v[11] = _mm_set1_epi64x((int64_t)blake2b_multi_IV[3]);
+	v[12] = _mm_set_epi64x( /* Counter = message length */
+		(int64_t)(blake2b_multi_IV[4] ^ (uint64_t)inlen[1]),
+		(int64_t)(blake2b_multi_IV[4] ^ (uint64_t)inlen[0])
+	);
+	v[13] = _mm_set1_epi64x((int64_t)blake2b_multi_IV[5]);
+	v[14] = _mm_set1_epi64x((int64_t)~blake2b_multi_IV[6]); /* Last block */
+	v[15] = _mm_set1_epi64x((int64_t)blake2b_multi_IV[7]);
+
+	ROUND(0);
+	ROUND(1);
+	ROUND(2);
+	ROUND(3);
+	ROUND(4);
+	ROUND(5);
+	ROUND(6);
+	ROUND(7);
+	ROUND(8);
+	ROUND(9);
+	ROUND(10);
+	ROUND(11);
+
+	uint64_t words[8][2];
+	for (size_t i = 0; i < 8; ++i) {
+		_mm_storeu_si128((__m128i *)words[i], _mm_xor_si128(h[i], _mm_xor_si128(v[i], v[i + 8])));
+	}
+
+	for (size_t lane = 0; lane < 2; ++lane) {
+		uint8_t buffer[BLAKE2B_OUTBYTES];
+		for (size_t i = 0; i < 8; ++i) {
+			store64(buffer + i * 8, words[i][lane]);
+		}
+
+		memcpy(out[lane], buffer, outlen);
+	}
+}
+
+#undef G
+#undef ROUND
+
+#endif
\ No newline at end of file
@@ -10,6 +10,9 @@
 
 using namespace rocksdb;
 
+static const std::string COMMIT_JOURNAL_KEY = "JOURNAL";
+static const std::string PENDING_JOURNAL_KEY = "PENDING_JOURNAL";
+
 std::shared_ptr<BlockDB> BlockDB::OpenDB(const Config& config)
 {
 	fs::path dbPath = config.GetNodeConfig().GetDatabasePath() / "CHAIN/";
@@ -20,18 +23,29 @@ std::shared_ptr<BlockDB> BlockDB::OpenDB(const Config& config)
 	ColumnFamilyDescriptor OUTPUT_POS_COLUMN = ColumnFamilyDescriptor("OUTPUT_POS", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
 	ColumnFamilyDescriptor INPUT_BITMAP_COLUMN = ColumnFamilyDescriptor("INPUT_BITMAP", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
 	ColumnFamilyDescriptor SPENT_OUTPUTS_COLUMN = ColumnFamilyDescriptor("SPENT_OUTPUTS", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
+	ColumnFamilyDescriptor BLOCK_INDEX_COLUMN = ColumnFamilyDescriptor("BLOCK_INDEX", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
+	ColumnFamilyDescriptor COMMIT_JOURNAL_COLUMN = ColumnFamilyDescriptor("COMMIT_JOURNAL", ColumnFamilyOptions());
 
-	std::vector<ColumnFamilyDescriptor> tableNames = { ColumnFamilyDescriptor(), BLOCK_COLUMN, HEADER_COLUMN, BLOCK_SUMS_COLUMN, OUTPUT_POS_COLUMN, INPUT_BITMAP_COLUMN, SPENT_OUTPUTS_COLUMN };
+	std::vector<ColumnFamilyDescriptor> tableNames = { ColumnFamilyDescriptor(), BLOCK_COLUMN, HEADER_COLUMN, BLOCK_SUMS_COLUMN, OUTPUT_POS_COLUMN, INPUT_BITMAP_COLUMN, SPENT_OUTPUTS_COLUMN, BLOCK_INDEX_COLUMN, COMMIT_JOURNAL_COLUMN };
 	std::shared_ptr<RocksDB> pRocksDB = RocksDBFactory::Open(dbPath, tableNames);
 	pRocksDB->DeleteAll("INPUT_BITMAP");
 
-	return std::make_shared<BlockDB>(config, pRocksDB);
+	ReplayCommitJournal(*pRocksDB);
+
+	std::shared_ptr<BlockFiles> pBlockFiles = BlockFiles::Open(config.GetNodeConfig().GetDatabasePath() / "BLOCKS");
+
+	return std::make_shared<BlockDB>(config, pRocksDB, pBlockFiles);
 }
 
 void BlockDB::Commit()
 {
+	// Block files must be flushed before the index rows referencing them are committed.
+	m_pBlockFiles->Commit();
 	m_pRocksDB->Commit();
 
+	// Pruned block files are only deleted once the index rows referencing them are gone.
+	m_pBlockFiles->DeletePendingFiles();
+
 	for (auto pHeader : m_uncommitted)
 	{
 		m_blockHeadersCache.Put(pHeader->GetHash(), pHeader);
@@ -43,6 +57,7 @@ void BlockDB::Commit()
 void BlockDB::Rollback() noexcept
 {
 	m_uncommitted.clear();
+	m_pBlockFiles->Rollback();
 	m_pRocksDB->Rollback();
 }
 
@@ -104,14 +119,24 @@ void BlockDB::AddBlock(const FullBlock& block)
 {
 	LOG_TRACE_F("Adding block {}", block);
 
+	const BlockLocation location = m_pBlockFiles->Append(block);
+
 	const std::vector<unsigned char>& hash = block.GetHash().GetData();
 	rocksdb::Slice key((const char*)hash.data(), hash.size());
-	m_pRocksDB->Put("BLOCK", DBEntry<FullBlock>(key, block));
+	m_pRocksDB->Put("BLOCK_INDEX", DBEntry<BlockLocation>(key, location));
 }
 
 std::unique_ptr<FullBlock> BlockDB::GetBlock(const Hash& hash) const
 {
 	rocksdb::Slice key((const char*)hash.data(), hash.size());
+
+	auto pLocation = m_pRocksDB->Get<BlockLocation>("BLOCK_INDEX", key);
+	if (pLocation != nullptr)
+	{
+		return m_pBlockFiles->Read(*pLocation);
+	}
+
+	// Blocks stored before the switch to flat files are still served from the legacy BLOCK table.
 	return m_pRocksDB->Get<FullBlock>("BLOCK", key);
 }
 
@@ -195,4 +220,138 @@ void BlockDB::ClearSpentPositions()
 	LOG_WARNING("Deleting all spent positions.");
 
 	m_pRocksDB->DeleteAll("SPENT_OUTPUTS");
+}
+
+std::map<uint32_t, std::vector<Hash>> BlockDB::GetPrunableBlockFiles(const uint64_t prunedHeight) const
+{
+	std::map<uint32_t, std::vector<Hash>> blockFiles;
+	for (const uint32_t fileNumber : m_pBlockFiles->GetFilesBelow(prunedHeight))
+	{
+		blockFiles[fileNumber] = m_pBlockFiles->GetBlockHashes(fileNumber);
+	}
+
+	return blockFiles;
+}
+
+uint64_t BlockDB::PruneBlocks(
+	const std::vector<Hash>& blockHashes,
+	const std::map<uint32_t, std::vector<Hash>>& blockFiles,
+	const uint64_t prunedHeight)
+{
+	// Only rows that may exist are deleted, to avoid writing tombstones for blocks that were never stored (ie. fast-sync).
+	// Existence is checked against the bloom filters, and sizes are estimated, so no block or spent output values are read.
+	std::vector<std::string> blockKeys;
+	std::vector<std::string> indexKeys;
+	std::vector<std::string> spentKeys;
+	for (const Hash& blockHash : blockHashes)
+	{
+		rocksdb::Slice key((const char*)blockHash.data(), blockHash.size());
+
+		if (m_pRocksDB->MayExist("BLOCK", key))
+		{
+			blockKeys.push_back(key.ToString());
+		}
+
+		if (m_pRocksDB->MayExist("BLOCK_INDEX", key))
+		{
+			indexKeys.push_back(key.ToString());
+		}
+
+		if (m_pRocksDB->MayExist("SPENT_OUTPUTS", key))
+		{
+			spentKeys.push_back(key.ToString());
+		}
+	}
+
+	uint64_t bytesReclaimed = m_pRocksDB->GetApproximateSize("BLOCK", blockKeys);
+	bytesReclaimed += m_pRocksDB->GetApproximateSize("SPENT_OUTPUTS", spentKeys);
+
+	// Removed files may also hold blocks that were never confirmed (ie. forks), so their index rows come from the hashes
+	// found by walking the files themselves. Files that are no longer prunable are skipped, and rows that were since
+	// rewritten to point at a newer file are left alone.
+	std::vector<uint32_t> filesToRemove;
+	for (const uint32_t fileNumber : m_pBlockFiles->GetFilesBelow(prunedHeight))
+	{
+		auto iter = blockFiles.find(fileNumber);
+		if (iter == blockFiles.cend())
+		{
+			continue;
+		}
+
+		for (const Hash& blockHash : iter->second)
+		{
+			rocksdb::Slice key((const char*)blockHash.data(), blockHash.size());
+
+			auto pLocation = m_pRocksDB->Get<BlockLocation>("BLOCK_INDEX", key);
+			if (pLocation != nullptr && pLocation->GetFileNumber() == fileNumber)
+			{
+				indexKeys.push_back(key.ToString());
+			}
+		}
+
+		filesToRemove.push_back(fileNumber);
+	}
+
+	m_pRocksDB->Delete("BLOCK", blockKeys);
+	m_pRocksDB->Delete("BLOCK_INDEX", indexKeys);
+	m_pRocksDB->Delete("SPENT_OUTPUTS", spentKeys);
+
+	// The files themselves are deleted by Commit, after the rows above are committed.
+	bytesReclaimed += m_pBlockFiles->RemoveFiles(filesToRemove);
+
+	LOG_DEBUG_F("Pruned {} blocks, reclaiming {} bytes", blockHashes.size(), bytesReclaimed);
+	return bytesReclaimed;
+}
+
+void BlockDB::SavePendingJournal(const CommitJournal& journal, const bool sync)
+{
+	LOG_TRACE_F("Saving pending journal with {} writes", journal.GetNumWrites());
+
+	m_pRocksDB->PutImmediate("COMMIT_JOURNAL", DBEntry<CommitJournal>(PENDING_JOURNAL_KEY, journal), sync);
+}
+
+void BlockDB::SaveCommitJournal(const CommitJournal& journal)
+{
+	LOG_TRACE_F("Saving commit journal with {} writes", journal.GetNumWrites());
+
+	if (journal.HasPostCommitWrites())
+	{
+		m_pRocksDB->Put("COMMIT_JOURNAL", DBEntry<CommitJournal>(COMMIT_JOURNAL_KEY, journal));
+	}
+
+	if (journal.HasWritesAhead())
+	{
+		m_pRocksDB->Delete("COMMIT_JOURNAL", PENDING_JOURNAL_KEY);
+	}
+}
+
+void BlockDB::ClearCommitJournal()
+{
+	m_pRocksDB->DeleteImmediate("COMMIT_JOURNAL", COMMIT_JOURNAL_KEY, false);
+}
+
+void BlockDB::ReplayCommitJournal(RocksDB& rocksDB)
+{
+	auto pJournal = rocksDB.Get<CommitJournal>("COMMIT_JOURNAL", COMMIT_JOURNAL_KEY);
+	if (pJournal != nullptr)
+	{
+		// The node stopped after committing a batch, but before all of its file writes were known to be complete.
+		LOG_WARNING_F("Replaying commit journal with {} writes", pJournal->GetNumWrites());
+		pJournal->Apply();
+		LOG_INFO("Commit journal replayed");
+	}
+	else
+	{
+		auto pPending = rocksDB.Get<CommitJournal>("COMMIT_JOURNAL", PENDING_JOURNAL_KEY);
+		if (pPending != nullptr)
+		{
+			// The node stopped after appends were written ahead, but before the batch committed.
+			LOG_WARNING_F("Reverting pending journal with {} writes", pPending->GetNumWrites());
+			pPending->Revert();
+			LOG_INFO("Pending journal reverted");
+		}
+	}
+
+	rocksDB.Delete("COMMIT_JOURNAL", COMMIT_JOURNAL_KEY);
+	rocksDB.Delete("COMMIT_JOURNAL", PENDING_JOURNAL_KEY);
 }
\ No newline at end of file
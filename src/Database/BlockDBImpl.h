@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RocksDB/RocksDB.h"
+#include "BlockStore/BlockFiles.h"
 
 #include <Database/BlockDb.h>
 #include <Config/Config.h>
@@ -11,8 +12,8 @@
 class BlockDB : public IBlockDB
 {
 public:
-	BlockDB(const Config& config, const std::shared_ptr<RocksDB>& pRocksDB)
-		: m_config(config), m_pRocksDB(pRocksDB), m_blockHeadersCache(128) { }
+	BlockDB(const Config& config, const std::shared_ptr<RocksDB>& pRocksDB, const std::shared_ptr<BlockFiles>& pBlockFiles)
+		: m_config(config), m_pRocksDB(pRocksDB), m_pBlockFiles(pBlockFiles), m_blockHeadersCache(128) { }
 	virtual ~BlockDB() = default;
 
 	static std::shared_ptr<BlockDB> OpenDB(const Config& config);
@@ -43,7 +44,20 @@ public:
 	std::unordered_map<Commitment, OutputLocation> GetSpentPositions(const Hash& blockHash) const final;
 	void ClearSpentPositions() final;
 
+	std::map<uint32_t, std::vector<Hash>> GetPrunableBlockFiles(const uint64_t prunedHeight) const final;
+	uint64_t PruneBlocks(
+		const std::vector<Hash>& blockHashes,
+		const std::map<uint32_t, std::vector<Hash>>& blockFiles,
+		const uint64_t prunedHeight
+	) final;
+
+	void SavePendingJournal(const CommitJournal& journal, const bool sync) final;
+	void SaveCommitJournal(const CommitJournal& journal) final;
+	void ClearCommitJournal() final;
+
 private:
+	static void ReplayCommitJournal(RocksDB& rocksDB);
+
 	//Status Read(ColumnFamilyHandle* pFamilyHandle, const Slice& key, std::string* pValue) const;
 	//Status Write(ColumnFamilyHandle* pFamilyHandle, const Slice& key, const Slice& value);
 	//Status Delete(ColumnFamilyHandle* pFamilyHandle, const Slice& key);
@@ -51,6 +65,7 @@ private:
 
 	const Config& m_config;
 	std::shared_ptr<RocksDB> m_pRocksDB;
+	std::shared_ptr<BlockFiles> m_pBlockFiles;
 	FIFOCache<Hash, BlockHeaderPtr> m_blockHeadersCache;
 
 	std::vector<BlockHeaderPtr> m_uncommitted;
@@ -0,0 +1,337 @@
+#pragma once
+
+#include "BlockLocation.h"
+
+#include <Core/File/AppendOnlyFile.h>
+#include <Core/Models/FullBlock.h>
+#include <Core/Traits/Batchable.h>
+#include <Core/Serialization/Serializer.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Database/DatabaseException.h>
+#include <Common/Util/FileUtil.h>
+#include <Common/Util/StringUtil.h>
+#include <Infrastructure/Logger.h>
+#include <filesystem.h>
+#include <map>
+#include <set>
+#include <memory>
+
+//
+// Append-only storage of full blocks in rotating flat files (blk00000.dat, blk00001.dat, ...).
+//
+// Each record is laid out as: height (8 bytes) | size (4 bytes) | serialized FullBlock (size bytes).
+// The BlockLocation returned by Append points at the serialized block, and is expected to be indexed by the caller.
+// Appended blocks are buffered until Commit, so a crash can only ever leave unreferenced bytes at the end of a file.
+// A torn record left behind by a crash mid-flush is truncated when the files are opened, so appends never land after it.
+// Likewise, pruned files are only deleted after the index rows referencing them are committed.
+//
+class BlockFiles : public Traits::IBatchable
+{
+public:
+	static constexpr uint64_t MAX_FILE_SIZE = 128 * 1024 * 1024;
+	static constexpr uint64_t RECORD_HEADER_SIZE = 12;
+
+	virtual ~BlockFiles() = default;
+
+	static std::shared_ptr<BlockFiles> Open(const fs::path& directory)
+	{
+		FileUtil::CreateDirectories(directory);
+
+		auto pBlockFiles = std::shared_ptr<BlockFiles>(new BlockFiles(directory));
+		for (const auto& entry : fs::directory_iterator(directory))
+		{
+			const std::string filename = entry.path().filename().u8string();
+			if (StringUtil::StartsWith(filename, "blk") && StringUtil::EndsWith(filename, ".dat"))
+			{
+				const uint32_t fileNumber = (uint32_t)std::stoul(filename.substr(3, filename.size() - 7));
+				pBlockFiles->LoadFile(fileNumber);
+				pBlockFiles->ScanFile(fileNumber);
+			}
+		}
+
+		if (pBlockFiles->m_files.empty())
+		{
+			pBlockFiles->LoadFile(0);
+		}
+
+		LOG_INFO_F("Loaded {} block files from {}", pBlockFiles->m_files.size(), directory);
+		return pBlockFiles;
+	}
+
+	void Commit() final
+	{
+		for (const uint32_t fileNumber : m_modified)
+		{
+			if (!m_files[fileNumber]->Flush())
+			{
+				LOG_ERROR_F("Failed to flush block file {}", fileNumber);
+				throw DATABASE_EXCEPTION_F("Failed to flush block file {}", fileNumber);
+			}
+		}
+
+		m_modified.clear();
+		SetDirty(false);
+	}
+
+	void Rollback() noexcept final
+	{
+		for (const uint32_t fileNumber : m_modified)
+		{
+			m_files[fileNumber]->Discard();
+		}
+
+		m_modified.clear();
+		m_pendingRemoval.clear();
+		SetDirty(false);
+	}
+
+	BlockLocation Append(const FullBlock& block)
+	{
+		const size_t blockSize = block.GetSerializedSize();
+
+		auto iter = m_files.rbegin();
+		if (iter->second->GetSize() + RECORD_HEADER_SIZE + blockSize > MAX_FILE_SIZE && iter->second->GetSize() > 0)
+		{
+			LoadFile(iter->first + 1);
+			iter = m_files.rbegin();
+		}
+
+		const uint32_t fileNumber = iter->first;
+		std::shared_ptr<AppendOnlyFile> pFile = iter->second;
+		const uint64_t offset = pFile->GetSize() + RECORD_HEADER_SIZE;
+
+		Serializer record(RECORD_HEADER_SIZE + blockSize);
+		record.Append<uint64_t>(block.GetHeight());
+		record.Append<uint32_t>((uint32_t)blockSize);
+		block.Serialize(record);
+		pFile->Append(record.GetBytes());
+
+		SetDirty(true);
+		m_modified.insert(fileNumber);
+
+		m_maxHeights[fileNumber] = (std::max)(m_maxHeights[fileNumber], block.GetHeight());
+
+		return BlockLocation(fileNumber, offset, (uint32_t)blockSize, block.GetHeight());
+	}
+
+	std::unique_ptr<FullBlock> Read(const BlockLocation& location) const
+	{
+		auto iter = m_files.find(location.GetFileNumber());
+		if (iter == m_files.cend() || location.GetOffset() + location.GetSize() > iter->second->GetSize())
+		{
+			LOG_ERROR_F(
+				"Block at height {} not found in block file {}",
+				location.GetHeight(),
+				location.GetFileNumber()
+			);
+			return nullptr;
+		}
+
+		// Committed blocks are deserialized straight from the mapping. Only blocks still pending a Commit are copied.
+		const unsigned char* pView = iter->second->GetView(location.GetOffset(), location.GetSize());
+		if (pView != nullptr)
+		{
+			ByteBuffer byteBuffer(pView, location.GetSize());
+			return std::make_unique<FullBlock>(FullBlock::Deserialize(byteBuffer));
+		}
+
+		std::vector<unsigned char> serialized;
+		iter->second->Read(location.GetOffset(), location.GetSize(), serialized);
+
+		ByteBuffer byteBuffer(std::move(serialized));
+		return std::make_unique<FullBlock>(FullBlock::Deserialize(byteBuffer));
+	}
+
+	//
+	// Returns every block file that only contains blocks below the given height.
+	// The newest file, any file with uncommitted appends, and files already pending removal are never included.
+	//
+	std::vector<uint32_t> GetFilesBelow(const uint64_t height) const
+	{
+		std::vector<uint32_t> fileNumbers;
+
+		const uint32_t newestFile = m_files.rbegin()->first;
+		for (const auto& file : m_files)
+		{
+			const uint32_t fileNumber = file.first;
+			if (fileNumber == newestFile)
+			{
+				break;
+			}
+
+			if (m_modified.count(fileNumber) == 0 && m_pendingRemoval.count(fileNumber) == 0 && GetMaxHeight(fileNumber) < height)
+			{
+				fileNumbers.push_back(fileNumber);
+			}
+		}
+
+		return fileNumbers;
+	}
+
+	//
+	// Returns the hash of every block stored in the file, including blocks that were never part of the confirmed chain.
+	//
+	std::vector<Hash> GetBlockHashes(const uint32_t fileNumber) const
+	{
+		std::shared_ptr<AppendOnlyFile> pFile = m_files.at(fileNumber);
+
+		std::vector<Hash> hashes;
+		const uint64_t end = ForEachRecord(*pFile, [&pFile, &hashes](const uint64_t, const uint64_t offset, const uint32_t blockSize)
+		{
+			std::vector<unsigned char> serialized;
+			const unsigned char* pView = pFile->GetView(offset, blockSize);
+			if (pView == nullptr)
+			{
+				pFile->Read(offset, blockSize, serialized);
+				pView = serialized.data();
+			}
+
+			ByteBuffer blockBuffer(pView, blockSize);
+			hashes.push_back(BlockHeader::Deserialize(blockBuffer).GetHash());
+		});
+
+		if (end < pFile->GetSize())
+		{
+			LOG_WARNING_F("Block file {} has a torn record at offset {}", fileNumber, end);
+		}
+
+		return hashes;
+	}
+
+	//
+	// Schedules the files for deletion once the database batch referencing them has committed.
+	// Returns the number of bytes that will be reclaimed.
+	//
+	uint64_t RemoveFiles(const std::vector<uint32_t>& fileNumbers)
+	{
+		uint64_t bytesRemoved = 0;
+		for (const uint32_t fileNumber : fileNumbers)
+		{
+			if (m_pendingRemoval.insert(fileNumber).second)
+			{
+				bytesRemoved += m_files.at(fileNumber)->GetSize();
+				SetDirty(true);
+			}
+		}
+
+		return bytesRemoved;
+	}
+
+	//
+	// Deletes the files scheduled by RemoveFiles. Must only be called after the index rows referencing them are committed.
+	// A failure here only leaves unreferenced files behind, which are swept up the next time pruning runs.
+	//
+	void DeletePendingFiles() noexcept
+	{
+		for (const uint32_t fileNumber : m_pendingRemoval)
+		{
+			auto iter = m_files.find(fileNumber);
+			if (iter == m_files.end())
+			{
+				continue;
+			}
+
+			const uint64_t fileSize = iter->second->GetSize();
+			m_files.erase(iter);
+			m_maxHeights.erase(fileNumber);
+
+			if (FileUtil::RemoveFile(GetPath(fileNumber)))
+			{
+				LOG_INFO_F("Pruned block file {} ({} bytes)", fileNumber, fileSize);
+			}
+			else
+			{
+				LOG_WARNING_F("Failed to remove block file {}", fileNumber);
+			}
+		}
+
+		m_pendingRemoval.clear();
+	}
+
+private:
+	BlockFiles(const fs::path& directory) : m_directory(directory) { }
+
+	//
+	// Returns the highest block height stored in the file.
+	// Calculated by walking the record headers when the file is opened, then kept up to date by Append.
+	//
+	uint64_t GetMaxHeight(const uint32_t fileNumber) const
+	{
+		auto iter = m_maxHeights.find(fileNumber);
+		return iter != m_maxHeights.cend() ? iter->second : 0;
+	}
+
+	//
+	// Records the highest block height stored in the file, and truncates the file after its last complete record.
+	// Complete records are kept even if nothing references them. Only a partially written record is dropped.
+	//
+	void ScanFile(const uint32_t fileNumber)
+	{
+		std::shared_ptr<AppendOnlyFile> pFile = m_files.at(fileNumber);
+
+		uint64_t maxHeight = 0;
+		const uint64_t position = ForEachRecord(*pFile, [&maxHeight](const uint64_t height, const uint64_t, const uint32_t)
+		{
+			maxHeight = (std::max)(maxHeight, height);
+		});
+
+		m_maxHeights[fileNumber] = maxHeight;
+
+		if (position < pFile->GetSize())
+		{
+			LOG_WARNING_F("Truncating block file {} from {} to {} bytes", fileNumber, pFile->GetSize(), position);
+			if (!pFile->Rewind(position) || !pFile->Flush())
+			{
+				LOG_ERROR_F("Failed to truncate block file {}", fileNumber);
+				throw DATABASE_EXCEPTION_F("Failed to truncate block file {}", fileNumber);
+			}
+		}
+	}
+
+	//
+	// Calls func(height, offset, blockSize) for every complete record in the file, where offset points at the serialized block.
+	// Stops at the first record that's empty or runs past the end of the file.
+	// Returns the position just after the last complete record.
+	//
+	template<typename Func>
+	static uint64_t ForEachRecord(const AppendOnlyFile& file, const Func& func)
+	{
+		uint64_t position = 0;
+		while (position + RECORD_HEADER_SIZE <= file.GetSize())
+		{
+			std::vector<unsigned char> header;
+			file.Read(position, RECORD_HEADER_SIZE, header);
+
+			ByteBuffer byteBuffer(std::move(header));
+			const uint64_t height = byteBuffer.ReadU64();
+			const uint32_t blockSize = byteBuffer.ReadU32();
+			if (blockSize == 0 || position + RECORD_HEADER_SIZE + blockSize > file.GetSize())
+			{
+				break;
+			}
+
+			func(height, position + RECORD_HEADER_SIZE, blockSize);
+			position += RECORD_HEADER_SIZE + blockSize;
+		}
+
+		return position;
+	}
+
+	void LoadFile(const uint32_t fileNumber)
+	{
+		auto pFile = std::make_shared<AppendOnlyFile>(GetPath(fileNumber));
+		pFile->Load();
+		m_files[fileNumber] = pFile;
+	}
+
+	fs::path GetPath(const uint32_t fileNumber) const
+	{
+		return m_directory / StringUtil::Format("blk{:0>5}.dat", fileNumber);
+	}
+
+	fs::path m_directory;
+	std::map<uint32_t, std::shared_ptr<AppendOnlyFile>> m_files;
+	std::set<uint32_t> m_modified;
+	std::set<uint32_t> m_pendingRemoval;
+	std::map<uint32_t, uint64_t> m_maxHeights;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Core/Serialization/Serializer.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Traits/Serializable.h>
+#include <cstdint>
+
+//
+// Position of a serialized FullBlock within the flat block files (blkXXXXX.dat).
+// Stored in the BLOCK_INDEX table, keyed by block hash.
+//
+class BlockLocation : public Traits::ISerializable
+{
+public:
+	//
+	// Constructor
+	//
+	BlockLocation(const uint32_t fileNumber, const uint64_t offset, const uint32_t size, const uint64_t height)
+		: m_fileNumber(fileNumber), m_offset(offset), m_size(size), m_height(height) { }
+	virtual ~BlockLocation() = default;
+
+	//
+	// Getters
+	//
+	uint32_t GetFileNumber() const noexcept { return m_fileNumber; }
+	uint64_t GetOffset() const noexcept { return m_offset; }
+	uint32_t GetSize() const noexcept { return m_size; }
+	uint64_t GetHeight() const noexcept { return m_height; }
+
+	//
+	// Serialization/Deserialization
+	//
+	void Serialize(Serializer& serializer) const noexcept final
+	{
+		serializer.Append(m_fileNumber);
+		serializer.Append(m_offset);
+		serializer.Append(m_size);
+		serializer.Append(m_height);
+	}
+
+	static BlockLocation Deserialize(ByteBuffer& byteBuffer)
+	{
+		const uint32_t fileNumber = byteBuffer.ReadU32();
+		const uint64_t offset = byteBuffer.ReadU64();
+		const uint32_t size = byteBuffer.ReadU32();
+		const uint64_t height = byteBuffer.ReadU64();
+		return BlockLocation(fileNumber, offset, size, height);
+	}
+
+private:
+	uint32_t m_fileNumber;
+	uint64_t m_offset;
+	uint32_t m_size;
+	uint64_t m_height;
+};
@@ -10,8 +10,11 @@
 #include <rocksdb/db.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/options.h>
+#include <rocksdb/convenience.h>
+#include <rocksdb/write_batch.h>
 #include <rocksdb/utilities/optimistic_transaction_db.h>
 #include <rocksdb/utilities/transaction.h>
+#include <rocksdb/utilities/write_batch_with_index.h>
 #include <filesystem.h>
 #include <cassert>
 #include <memory>
@@ -81,6 +84,70 @@ public:
 		return Get<T>(GetTable(tableName), key);
 	}
 
+	//
+	// Checks whether the key may exist, using only the memtables, bloom filters and block cache.
+	// False positives are possible, but a key that exists is never reported missing. Keys written by the active
+	// transaction are not considered.
+	//
+	bool MayExist(const std::string& tableName, const rocksdb::Slice& key) const
+	{
+		const RocksDBTable& table = GetTable(tableName);
+
+		std::string value;
+		return m_pTransactionDB->GetBaseDB()->KeyMayExist(rocksdb::ReadOptions(), table.GetHandle(), key, &value);
+	}
+
+	//
+	// Returns the approximate number of bytes (in memtables and SST files) used by the given keys.
+	// The sizes are estimated from the table indexes, so no values are read.
+	//
+	uint64_t GetApproximateSize(const std::string& tableName, const std::vector<std::string>& keys) const
+	{
+		if (keys.empty())
+		{
+			return 0;
+		}
+
+		const RocksDBTable& table = GetTable(tableName);
+
+		// Each range covers exactly one key: [key, key + '\0').
+		std::vector<std::string> limits;
+		limits.reserve(keys.size());
+		std::vector<rocksdb::Range> ranges;
+		ranges.reserve(keys.size());
+		for (const std::string& key : keys)
+		{
+			limits.push_back(key + '\0');
+			ranges.push_back(rocksdb::Range(key, limits.back()));
+		}
+
+		rocksdb::SizeApproximationOptions options;
+		options.include_memtabtles = true;
+		options.include_files = true;
+
+		std::vector<uint64_t> sizes(ranges.size(), 0);
+		const rocksdb::Status status = m_pTransactionDB->GetBaseDB()->GetApproximateSizes(
+			options,
+			table.GetHandle(),
+			ranges.data(),
+			(int)ranges.size(),
+			sizes.data()
+		);
+		if (!status.ok())
+		{
+			LOG_WARNING_F("GetApproximateSizes failed for table {} with error: {}", table, status.getState());
+			return 0;
+		}
+
+		uint64_t totalSize = 0;
+		for (const uint64_t size : sizes)
+		{
+			totalSize += size;
+		}
+
+		return totalSize;
+	}
+
 	template<typename T,
 		typename SFINAE = typename std::enable_if_t<std::is_base_of_v<Traits::ISerializable, T>>>
 	void Put(const RocksDBTable& table, const DBEntry<T>& entry)
@@ -127,25 +194,20 @@ public:
 	{
 		assert(!entries.empty());
 
-		std::shared_ptr<rocksdb::Transaction> pTempTransaction = nullptr;
-		if (m_pTransaction == nullptr)
-		{
-			pTempTransaction = std::shared_ptr<rocksdb::Transaction>(m_pTransactionDB->BeginTransaction(rocksdb::WriteOptions()));
-		}
-
-		rocksdb::Status status;
-
+		rocksdb::WriteBatch batch;
 		for (const DBEntry<T>& entry : entries)
 		{
 			std::vector<unsigned char> serialized = entry.SerializeValue();
 			rocksdb::Slice value((const char*)serialized.data(), serialized.size());
+
+			rocksdb::Status status;
 			if (m_pTransaction != nullptr)
 			{
 				status = m_pTransaction->Put(table.GetHandle(), entry.key, value);
 			}
 			else
 			{
-				status = pTempTransaction->Put(table.GetHandle(), entry.key, value);
+				status = batch.Put(table.GetHandle(), entry.key, value);
 			}
 
 			if (!status.ok())
@@ -160,6 +222,11 @@ public:
 				throw DATABASE_EXCEPTION(errorMessage);
 			}
 		}
+
+		if (m_pTransaction == nullptr)
+		{
+			Write(table, batch);
+		}
 	}
 
 	template<typename T,
@@ -169,6 +236,34 @@ public:
 		Put(GetTable(tableName), entries);
 	}
 
+	//
+	// Writes the entry straight to the base DB, bypassing any open transaction, and optionally syncs the WAL.
+	// Used for records that must be stored before the active transaction commits.
+	//
+	template<typename T,
+		typename SFINAE = typename std::enable_if_t<std::is_base_of_v<Traits::ISerializable, T>>>
+	void PutImmediate(const std::string& tableName, const DBEntry<T>& entry, const bool sync)
+	{
+		const RocksDBTable& table = GetTable(tableName);
+
+		std::vector<unsigned char> serialized = entry.SerializeValue();
+		rocksdb::WriteBatch batch;
+		batch.Put(table.GetHandle(), entry.key, rocksdb::Slice((const char*)serialized.data(), serialized.size()));
+		Write(table, batch, sync);
+	}
+
+	//
+	// Deletes the key straight from the base DB, bypassing any open (or already committed) transaction.
+	//
+	void DeleteImmediate(const std::string& tableName, const rocksdb::Slice& key, const bool sync)
+	{
+		const RocksDBTable& table = GetTable(tableName);
+
+		rocksdb::WriteBatch batch;
+		batch.Delete(table.GetHandle(), key);
+		Write(table, batch, sync);
+	}
+
 	void Delete(const RocksDBTable& table, const rocksdb::Slice& key)
 	{
 		LOG_DEBUG_F("Deleting {} from table {}", key.ToString(true), table);
@@ -203,57 +298,104 @@ public:
 
 	void Delete(const std::string& tableName, const std::vector<std::string>& keys)
 	{
-		// FUTURE: Use a WriteBatch
-		const RocksDBTable& table = GetTable(tableName);
-		for (const rocksdb::Slice& key : keys)
+		Delete(GetTable(tableName), keys);
+	}
+
+	void Delete(const RocksDBTable& table, const std::vector<std::string>& keys)
+	{
+		if (keys.empty())
 		{
-			Delete(table, key);
+			return;
+		}
+
+		LOG_DEBUG_F("Deleting {} keys from table {}", keys.size(), table);
+
+		rocksdb::WriteBatch batch;
+		for (const std::string& key : keys)
+		{
+			rocksdb::Status status;
+			if (m_pTransaction != nullptr)
+			{
+				status = m_pTransaction->Delete(table.GetHandle(), key);
+			}
+			else
+			{
+				status = batch.Delete(table.GetHandle(), key);
+			}
+
+			if (!status.ok())
+			{
+				const std::string errorMessage = StringUtil::Format(
+					"Error while attempting to delete {} from table {}. Error: {}",
+					rocksdb::Slice(key).ToString(true),
+					table,
+					status.getState()
+				);
+				LOG_ERROR(errorMessage);
+				throw DATABASE_EXCEPTION(errorMessage);
+			}
+		}
+
+		if (m_pTransaction == nullptr)
+		{
+			Write(table, batch);
 		}
 	}
 
+	//
+	// Clears the table.
+	// SST files fully covered by the table's key range are dropped outright, and whatever remains (memtables,
+	// partially covered files) is removed with a single range tombstone, so the table is never walked row by row.
+	// The clear is applied to the base DB immediately, even inside a transaction, and is not undone by a rollback.
+	// Inside a transaction, it must happen before the transaction writes to the table, since those writes would
+	// conflict with the range tombstone when committed.
+	//
 	void DeleteAll(const RocksDBTable& table)
 	{
 		LOG_WARNING_F("Deleting all rows from table {}", table);
 
-		rocksdb::Status status;
 		if (m_pTransaction != nullptr)
 		{
-			std::unique_ptr<rocksdb::Iterator> it(m_pTransaction->GetIterator(rocksdb::ReadOptions(), table.GetHandle()));
-			for (it->SeekToFirst(); it->Valid(); it->Next())
+			std::unique_ptr<rocksdb::WBWIIterator> pPending(m_pTransaction->GetWriteBatch()->NewIterator(table.GetHandle()));
+			pPending->SeekToFirst();
+			if (pPending->Valid())
 			{
-				status = m_pTransaction->Delete(table.GetHandle(), it->key());
-				if (!status.ok())
-				{
-					const std::string errorMessage = StringUtil::Format(
-						"Error while attempting to delete {} from table {}. Error: {}",
-						it->key().data(),
-						table,
-						status.getState()
-					);
-					LOG_ERROR(errorMessage);
-					throw DATABASE_EXCEPTION(errorMessage);
-				}
+				LOG_ERROR_F("Table {} has pending writes in the open transaction", table);
+				throw DATABASE_EXCEPTION_F("Table {} cannot be cleared after being written in the same transaction", table);
 			}
 		}
-		else
+
+		rocksdb::DB* pBaseDB = m_pTransactionDB->GetBaseDB();
+
+		std::string firstKey;
+		std::string lastKey;
 		{
-			std::unique_ptr<rocksdb::Iterator> it(m_pTransactionDB->NewIterator(rocksdb::ReadOptions(), table.GetHandle()));
-			for (it->SeekToFirst(); it->Valid(); it->Next())
+			std::unique_ptr<rocksdb::Iterator> it(pBaseDB->NewIterator(rocksdb::ReadOptions(), table.GetHandle()));
+			it->SeekToFirst();
+			if (!it->Valid())
 			{
-				status = m_pTransactionDB->Delete(rocksdb::WriteOptions(), table.GetHandle(), it->key());
-				if (!status.ok())
-				{
-					const std::string errorMessage = StringUtil::Format(
-						"Error while attempting to delete {} from table {}. Error: {}",
-						it->key().data(),
-						table,
-						status.getState()
-					);
-					LOG_ERROR(errorMessage);
-					throw DATABASE_EXCEPTION(errorMessage);
-				}
+				return;
 			}
+
+			firstKey = it->key().ToString();
+
+			it->SeekToLast();
+			lastKey = it->key().ToString();
 		}
+
+		rocksdb::Slice begin(firstKey);
+		rocksdb::Slice end(lastKey);
+		rocksdb::Status status = rocksdb::DeleteFilesInRange(pBaseDB, table.GetHandle(), &begin, &end);
+		if (!status.ok())
+		{
+			LOG_WARNING_F("DeleteFilesInRange failed for table {} with error: {}", table, status.getState());
+		}
+
+		// DeleteRange excludes the end key, so the last key is deleted explicitly in the same batch.
+		rocksdb::WriteBatch batch;
+		batch.DeleteRange(table.GetHandle(), begin, end);
+		batch.Delete(table.GetHandle(), end);
+		Write(table, batch);
 	}
 
 	void DeleteAll(const std::string& tableName)
@@ -297,6 +439,19 @@ public:
 	}
 
 private:
+	void Write(const RocksDBTable& table, rocksdb::WriteBatch& batch, const bool sync = false)
+	{
+		rocksdb::WriteOptions options;
+		options.sync = sync;
+
+		const rocksdb::Status status = m_pTransactionDB->GetBaseDB()->Write(options, &batch);
+		if (!status.ok())
+		{
+			LOG_ERROR_F("WriteBatch failed for table {} with error: {}", table, status.getState());
+			throw DATABASE_EXCEPTION_F("WriteBatch failed for table {} with error: {}", table, status.getState());
+		}
+	}
+
 	const RocksDBTable& GetTable(const std::string& name) const
 	{
 		for (const RocksDBTable& table : m_tables)
@@ -12,6 +12,7 @@ static unsigned long DEFAULT_TIMEOUT = 5 * 1000; // 5s
 Socket::Socket(const SocketAddress& address)
 	: m_address(address),
 	m_socketOpen(false),
+	m_pRateCounter(std::make_shared<RateCounter>()),
 	m_blocking(true),
 	m_receiveBufferSize(0),
 	m_receiveTimeout(DEFAULT_TIMEOUT),
@@ -32,8 +33,10 @@ bool Socket::Connect(std::shared_ptr<asio::io_context> pContext)
 	asio::ip::tcp::endpoint endpoint(asio::ip::address(asio::ip::address_v4::from_string(m_address.GetIPAddress().Format())), m_address.GetPortNumber());
 
 	m_pSocket = std::make_shared<asio::ip::tcp::socket>(*pContext);
-	m_pSocket->async_connect(endpoint, [this](const asio::error_code & ec)
+	m_pSocket->async_connect(endpoint, [this, pSelf = shared_from_this()](const asio::error_code & ec)
 		{
+			std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
 			m_errorCode = ec;
 			if (!ec)
             {
@@ -65,26 +68,46 @@ bool Socket::Connect(std::shared_ptr<asio::io_context> pContext)
 		}
 	);
 
-	pContext->run();
-
-	auto timeout = std::chrono::system_clock::now() + std::chrono::seconds(1);
-	while (!m_errorCode && !m_socketOpen && std::chrono::system_clock::now() < timeout)
+	// The context is run by another thread, so just wait for the connect handler.
+	auto timeout = std::chrono::system_clock::now() + std::chrono::milliseconds(DEFAULT_TIMEOUT);
+	while (std::chrono::system_clock::now() < timeout)
 	{
+		{
+			std::shared_lock<std::shared_mutex> readLock(m_mutex);
+			if (m_errorCode || m_socketOpen)
+			{
+				break;
+			}
+		}
+
 		ThreadUtil::SleepFor(std::chrono::milliseconds(10), false);
 	}
 
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+	if (!m_socketOpen)
+	{
+		// Cancels the connect attempt if it's still pending.
+		asio::error_code ignoreError;
+		m_pSocket->close(ignoreError);
+	}
+
 	return m_socketOpen;
 }
 
-bool Socket::Accept(std::shared_ptr<asio::io_context> pContext, asio::ip::tcp::acceptor& acceptor, const std::atomic_bool& terminate)
+bool Socket::Accept(
+	std::shared_ptr<asio::io_context> pContext,
+	asio::io_context& acceptorContext,
+	asio::ip::tcp::acceptor& acceptor,
+	const std::atomic_bool& terminate)
 {
 	m_pContext = pContext;
 	m_pSocket = std::make_shared<asio::ip::tcp::socket>(*pContext);
-	acceptor.async_accept(*m_pSocket, [this, pContext](const asio::error_code & ec)
+	acceptor.async_accept(*m_pSocket, [this](const asio::error_code & ec)
 		{
 			m_errorCode = ec;
 			if (!ec)
 			{
+				#ifdef _WIN32
 				if (setsockopt(m_pSocket->native_handle(), SOL_SOCKET, SO_RCVTIMEO, (char*)& DEFAULT_TIMEOUT, sizeof(DEFAULT_TIMEOUT)) == SOCKET_ERROR)
 				{
 					return false;
@@ -94,6 +117,7 @@ bool Socket::Accept(std::shared_ptr<asio::io_context> pContext, asio::ip::tcp::a
 				{
 					return false;
 				}
+				#endif
 
 				const std::string address = m_pSocket->remote_endpoint().address().to_string();
 				m_address = SocketAddress(address, m_pSocket->remote_endpoint().port());
@@ -116,10 +140,10 @@ bool Socket::Accept(std::shared_ptr<asio::io_context> pContext, asio::ip::tcp::a
 			break;
 		}
 
-		pContext->run_one_for(std::chrono::milliseconds(100));
+		acceptorContext.run_one_for(std::chrono::milliseconds(100));
 	}
 
-	pContext->reset();
+	acceptorContext.restart();
 
 	return m_socketOpen;
 }
@@ -129,6 +153,10 @@ bool Socket::CloseSocket()
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
 
 	m_socketOpen = false;
+	if (m_pSocket == nullptr)
+	{
+		return true;
+	}
 
 	asio::error_code error;
 	m_pSocket->shutdown(asio::socket_base::shutdown_both, error);
@@ -268,12 +296,8 @@ bool Socket::Send(const std::vector<unsigned char>& message, const bool incremen
 {
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
 
-	if (incrementCount)
-	{
-		m_rateCounter.AddMessageSent();
-	}
-
 	const size_t bytesWritten = asio::write(*m_pSocket, asio::buffer(message.data(), message.size()), m_errorCode);
+	m_pRateCounter->AddSent(bytesWritten, incrementCount ? 1 : 0);
 	if (m_errorCode && m_errorCode.value() != EAGAIN && m_errorCode.value() != EWOULDBLOCK)
 	{
 		throw SocketException(m_errorCode);
@@ -303,11 +327,7 @@ bool Socket::Receive(const size_t numBytes, const bool incrementCount, std::vect
 
 		if (bytesRead == numBytes)
 		{
-			if (incrementCount)
-			{
-				m_rateCounter.AddMessageReceived();
-			}
-
+			m_pRateCounter->AddReceived(numBytes, incrementCount ? 1 : 0);
 			return true;
 		}
 		else if (m_errorCode.value() == EAGAIN || m_errorCode.value() == EWOULDBLOCK)
@@ -320,6 +340,44 @@ bool Socket::Receive(const size_t numBytes, const bool incrementCount, std::vect
 	return false;
 }
 
+void Socket::AsyncSend(const Strand& strand, std::shared_ptr<const std::vector<unsigned char>> pMessage, const bool incrementCount, const IOHandler& handler)
+{
+	asio::async_write(
+		*m_pSocket,
+		asio::buffer(pMessage->data(), pMessage->size()),
+		asio::bind_executor(strand, [pSelf = shared_from_this(), pMessage, incrementCount, handler](const asio::error_code& ec, const size_t bytesWritten)
+		{
+			pSelf->m_pRateCounter->AddSent(bytesWritten, (incrementCount && !ec) ? 1 : 0);
+			if (ec)
+			{
+				std::unique_lock<std::shared_mutex> writeLock(pSelf->m_mutex);
+				pSelf->m_errorCode = ec;
+			}
+
+			handler(ec, bytesWritten);
+		})
+	);
+}
+
+void Socket::AsyncReceive(const Strand& strand, unsigned char* pBuffer, const size_t numBytes, const bool incrementCount, const IOHandler& handler)
+{
+	asio::async_read(
+		*m_pSocket,
+		asio::buffer(pBuffer, numBytes),
+		asio::bind_executor(strand, [pSelf = shared_from_this(), incrementCount, handler](const asio::error_code& ec, const size_t bytesRead)
+		{
+			pSelf->m_pRateCounter->AddReceived(bytesRead, (incrementCount && !ec) ? 1 : 0);
+			if (ec)
+			{
+				std::unique_lock<std::shared_mutex> writeLock(pSelf->m_mutex);
+				pSelf->m_errorCode = ec;
+			}
+
+			handler(ec, bytesRead);
+		})
+	);
+}
+
 bool Socket::HasReceivedData()
 {
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
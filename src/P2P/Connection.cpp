@@ -1,5 +1,4 @@
 #include "Connection.h"
-#include "MessageRetriever.h"
 #include "MessageProcessor.h"
 #include "MessageSender.h"
 #include "ConnectionManager.h"
@@ -15,28 +14,55 @@
 #include <chrono>
 #include <memory>
 
+static const size_t HEADER_SIZE = 11;
+static const std::chrono::seconds PING_INTERVAL = std::chrono::seconds(10);
+static const std::chrono::seconds IDLE_TIMEOUT = std::chrono::seconds(30);
+
+// Byte limits allow bursts of up to 1 second of traffic. Message limits allow a full minute's worth.
+static TokenBucket CreateBytesBucket(const uint32_t kilobytesPerSecond)
+{
+	const double bytesPerSecond = kilobytesPerSecond * 1024.0;
+	return TokenBucket(bytesPerSecond, bytesPerSecond);
+}
+
+static TokenBucket CreateMessagesBucket(const uint32_t messagesPerMinute)
+{
+	return TokenBucket(messagesPerMinute / 60.0, (double)messagesPerMinute);
+}
+
 Connection::Connection(
 	SocketPtr pSocket,
 	const uint64_t connectionId,
+	const Config& config,
 	ConnectionManager& connectionManager,
 	const ConnectedPeer& connectedPeer,
 	SyncStatusConstPtr pSyncStatus,
 	std::shared_ptr<HandShake> pHandShake,
 	std::shared_ptr<MessageProcessor> pMessageProcessor,
-	std::shared_ptr<MessageRetriever> pMessageRetriever,
 	std::shared_ptr<MessageSender> pMessageSender)
-	: m_pSocket(pSocket),
-	m_connectionId(connectionId),
+	: m_config(config),
 	m_connectionManager(connectionManager),
-	m_connectedPeer(connectedPeer),
 	m_pSyncStatus(pSyncStatus),
 	m_pHandShake(pHandShake),
 	m_pMessageProcessor(pMessageProcessor),
-	m_pMessageRetriever(pMessageRetriever),
 	m_pMessageSender(pMessageSender),
-	m_terminate(false)
+	m_terminate(false),
+	m_connectionId(connectionId),
+	m_connectedPeer(connectedPeer),
+	m_pSocket(pSocket),
+	m_pStats(std::make_shared<ConnectionStats>(pSocket->GetRateCounter())),
+	m_strand(asio::make_strand(*connectionManager.GetIOContext())),
+	m_headerBuffer(HEADER_SIZE, 0),
+	m_lastReceivedTime(std::chrono::steady_clock::now().time_since_epoch().count()),
+	m_downloadBytes(CreateBytesBucket(config.GetP2PConfig().GetMaxDownloadKBps())),
+	m_downloadMessages(CreateMessagesBucket(config.GetP2PConfig().GetMaxMessagesPerMinute())),
+	m_readThrottleTimer(*connectionManager.GetIOContext()),
+	m_pingTimer(*connectionManager.GetIOContext()),
+	m_writing(false),
+	m_uploadBytes(CreateBytesBucket(config.GetP2PConfig().GetMaxUploadKBps())),
+	m_writeThrottleTimer(*connectionManager.GetIOContext())
 {
-
+	m_connectedPeer.SetStats(m_pStats);
 }
 
 Connection::~Connection()
@@ -47,9 +73,31 @@ Connection::~Connection()
 void Connection::Disconnect()
 {
 	m_terminate = true;
-	ThreadUtil::Join(m_connectionThread);
+
+	// The last reference may be released by the connect thread itself, which can't join itself.
+	if (m_connectionThread.joinable() && m_connectionThread.get_id() == std::this_thread::get_id())
+	{
+		ThreadUtil::Detach(m_connectionThread);
+	}
+	else
+	{
+		ThreadUtil::Join(m_connectionThread);
+	}
+
+	Close();
+}
+
+void Connection::Close()
+{
+	m_terminate = true;
 	m_connectedPeer.GetPeer()->SetConnected(false);
-	m_pSocket.reset();
+
+	// Closing the socket aborts any pending reads and writes, which releases their references to this connection.
+	// It's closed on the strand, so it can't race with a read or write that's being started or completed.
+	if (m_pSocket != nullptr)
+	{
+		asio::post(m_strand, [pSocket = m_pSocket] { pSocket->CloseSocket(); });
+	}
 }
 
 std::shared_ptr<Connection> Connection::Create(
@@ -63,21 +111,20 @@ std::shared_ptr<Connection> Connection::Create(
 	SyncStatusConstPtr pSyncStatus)
 {
 	auto pHandShake = std::make_shared<HandShake>(config, connectionManager, pBlockChainServer);
-	auto pMessageRetriever = std::make_shared<MessageRetriever>(config, connectionManager);
 	auto pMessageSender = std::make_shared<MessageSender>(config);
 
 	auto pConnection = std::shared_ptr<Connection>(new Connection(
 		pSocket,
 		connectionId,
+		config,
 		connectionManager,
 		connectedPeer,
 		pSyncStatus,
 		pHandShake,
 		pMessageProcessor,
-		pMessageRetriever,
 		pMessageSender
 	));
-	pConnection->m_connectionThread = std::thread(Thread_ProcessConnection, pConnection);
+	pConnection->m_connectionThread = std::thread(Thread_Connect, pConnection);
 	ThreadManagerAPI::SetThreadName(pConnection->m_connectionThread.get_id(), "PEER");
 	return pConnection;
 }
@@ -94,20 +141,33 @@ bool Connection::IsConnectionActive() const
 
 void Connection::Send(const IMessage& message)
 {
-	m_sendQueue.push_back(message.Clone());
+	if (message.GetMessageType() != MessageTypes::Ping && message.GetMessageType() != MessageTypes::Pong)
+	{
+		LOG_TRACE_F("Sending message ({}) to ({})", MessageTypes::ToString(message.GetMessageType()), m_connectedPeer);
+	}
+
+	Send(std::make_shared<const std::vector<unsigned char>>(m_pMessageSender->Serialize(message)));
+}
+
+void Connection::Send(std::shared_ptr<const std::vector<unsigned char>> pSerializedMessage)
+{
+	PendingWrite pendingWrite;
+	pendingWrite.pBytes = std::move(pSerializedMessage);
+	Enqueue(std::move(pendingWrite));
 }
 
-bool Connection::ExceedsRateLimit() const
+void Connection::SendStream(const std::function<bool(std::vector<unsigned char>&)>& readChunk)
 {
-	return m_pSocket->GetRateCounter().GetSentInLastMinute() > 500
-		|| m_pSocket->GetRateCounter().GetReceivedInLastMinute() > 500;
+	PendingWrite pendingWrite;
+	pendingWrite.readChunk = readChunk;
+	Enqueue(std::move(pendingWrite));
 }
 
 //
-// Continuously checks for messages to send and/or receive until the connection is terminated.
-// This function runs in its own thread.
+// Connects (outbound only) and performs the handshake, then hands the connection off to the io_context.
+// This function runs in its own thread, which exits as soon as the handshake is complete.
 //
-void Connection::Thread_ProcessConnection(std::shared_ptr<Connection> pConnection)
+void Connection::Thread_Connect(std::shared_ptr<Connection> pConnection)
 {
 	try
 	{
@@ -115,13 +175,12 @@ void Connection::Thread_ProcessConnection(std::shared_ptr<Connection> pConnectio
 		bool connected = pConnection->GetSocket()->IsSocketOpen();
 		if (!connected)
 		{
-			pConnection->m_pContext = std::make_shared<asio::io_context>();
 			direction = EDirection::OUTBOUND;
-			connected = pConnection->m_pSocket->Connect(pConnection->m_pContext);
+			connected = pConnection->m_pSocket->Connect(pConnection->m_connectionManager.GetIOContext());
 		}
 
 		bool handshakeSuccess = false;
-		if (connected)
+		if (connected && !pConnection->m_terminate)
 		{
 			handshakeSuccess = pConnection->m_pHandShake->PerformHandshake(
 				*pConnection->m_pSocket,
@@ -130,10 +189,17 @@ void Connection::Thread_ProcessConnection(std::shared_ptr<Connection> pConnectio
 			);
 		}
 
-		if (handshakeSuccess)
+		if (handshakeSuccess && !pConnection->m_terminate)
 		{
 			LOG_DEBUG("Successful Handshake");
 			pConnection->m_connectionManager.AddConnection(pConnection);
+			pConnection->m_connectedPeer.GetPeer()->SetConnected(true);
+			pConnection->m_lastReceivedTime = std::chrono::steady_clock::now().time_since_epoch().count();
+
+			asio::post(pConnection->m_strand, [pConnection] {
+				pConnection->ReceiveHeader();
+				pConnection->SchedulePing();
+			});
 			pConnection->Send(GetPeerAddressesMessage(Capabilities::ECapability::FAST_SYNC_NODE));
 		}
 		else
@@ -141,129 +207,324 @@ void Connection::Thread_ProcessConnection(std::shared_ptr<Connection> pConnectio
 			pConnection->m_pSocket->CloseSocket();
 			pConnection->m_terminate = true;
 			ThreadUtil::Detach(pConnection->m_connectionThread);
-			return;
 		}
 	}
 	catch (...)
 	{
-        LOG_ERROR("Exception caught");
-        pConnection->m_terminate = true;
+		LOG_ERROR("Exception caught");
+		pConnection->Close();
 		ThreadUtil::Detach(pConnection->m_connectionThread);
+	}
+}
+
+void Connection::ReceiveHeader()
+{
+	if (m_terminate)
+	{
+		return;
+	}
+
+	m_pSocket->AsyncReceive(
+		m_strand,
+		m_headerBuffer.data(),
+		HEADER_SIZE,
+		true,
+		[pConnection = shared_from_this()](const asio::error_code& ec, const size_t) { pConnection->OnHeaderReceived(ec); }
+	);
+}
+
+void Connection::OnHeaderReceived(const asio::error_code& ec)
+{
+	if (ec || m_terminate)
+	{
+		Close();
 		return;
 	}
 
-	pConnection->m_connectedPeer.GetPeer()->SetConnected(true);
+	ByteBuffer byteBuffer(m_headerBuffer);
+	m_messageHeader = MessageHeader::Deserialize(byteBuffer);
+	if (!m_messageHeader.IsValid(m_config))
+	{
+		LOG_ERROR_F("Invalid message header received from ({})", m_connectedPeer);
+		Close();
+		return;
+	}
+
+	if (m_messageHeader.GetMessageType() != MessageTypes::Ping && m_messageHeader.GetMessageType() != MessageTypes::Pong)
+	{
+		LOG_TRACE_F("Retrieved message ({}) from ({})", MessageTypes::ToString(m_messageHeader.GetMessageType()), m_connectedPeer);
+	}
+
+	// Payloads are read into a pooled buffer, and deserialized directly from it.
+	m_pPayload = m_connectionManager.GetBufferPool()->Acquire(m_messageHeader.GetMessageLength());
+	if (m_pPayload->empty())
+	{
+		OnPayloadReceived(ec);
+		return;
+	}
+
+	m_pSocket->AsyncReceive(
+		m_strand,
+		m_pPayload->data(),
+		m_pPayload->size(),
+		false,
+		[pConnection = shared_from_this()](const asio::error_code& ec, const size_t) { pConnection->OnPayloadReceived(ec); }
+	);
+}
+
+void Connection::OnPayloadReceived(const asio::error_code& ec)
+{
+	if (ec || m_terminate)
+	{
+		Close();
+		return;
+	}
 
-	SyncStatusConstPtr pSyncStatus = pConnection->m_pSyncStatus;
+	m_connectedPeer.GetPeer()->UpdateLastContactTime();
+	m_lastReceivedTime = std::chrono::steady_clock::now().time_since_epoch().count();
 
-	std::chrono::system_clock::time_point lastPingTime = std::chrono::system_clock::now();
-	std::chrono::system_clock::time_point lastReceivedMessageTime = std::chrono::system_clock::now();
+	const uint64_t numBytes = HEADER_SIZE + m_messageHeader.GetMessageLength();
+	m_pStats->AddReceived((uint8_t)m_messageHeader.GetMessageType(), numBytes);
 
-	while (!pConnection->m_terminate && !pConnection->GetPeer()->IsBanned())
+	// Processing can block (ie. validating a block, or reading a TxHashSet), so it happens on the message pool.
+	// The next read isn't started until processing finishes, so each connection has at most one message in flight.
+	auto pRawMessage = std::make_shared<const RawMessage>(MessageHeader(m_messageHeader), std::move(m_pPayload));
+	m_connectionManager.GetMessagePool().Submit([pConnection = shared_from_this(), pRawMessage, numBytes]
 	{
-		if (pConnection->ExceedsRateLimit())
+		if (pConnection->ProcessMessage(*pRawMessage))
 		{
-			LOG_WARNING_F("Banning peer ({}) for exceeding rate limit.", pConnection->GetIPAddress());
-			pConnection->GetPeer()->Ban(EBanReason::Abusive);
-			break;
+			asio::post(pConnection->m_strand, [pConnection, numBytes] { pConnection->ThrottleReceive(numBytes); });
 		}
+	});
+}
 
-		auto now = std::chrono::system_clock::now();
-		if (lastPingTime + std::chrono::seconds(10) < now)
-		{
-			const PingMessage pingMessage(pSyncStatus->GetBlockDifficulty(), pSyncStatus->GetBlockHeight());
-			pConnection->Send(pingMessage);
+bool Connection::ProcessMessage(const RawMessage& rawMessage)
+{
+	try
+	{
+		const MessageProcessor::EStatus status = m_pMessageProcessor->ProcessMessage(
+			*this,
+			m_connectedPeer,
+			rawMessage
+		);
 
-			lastPingTime = now;
+		if (status == MessageProcessor::EStatus::BAN_PEER)
+		{
+			EBanReason banReason = EBanReason::Abusive; // TODO: Determine real reason.
+			LOG_WARNING_F("Banning peer ({}) for ({}).", GetIPAddress(), BanReason::Format(banReason));
+			GetPeer()->Ban(banReason);
+			Close();
+			return false;
 		}
+	}
+	catch (const DeserializationException&)
+	{
+		LOG_ERROR("Deserialization exception occurred");
+		Close();
+		return false;
+	}
+	catch (const SocketException&)
+	{
+		LOG_DEBUG_F("Socket exception occurred with ({})", m_connectedPeer);
+		Close();
+		return false;
+	}
+	catch (const std::exception& e)
+	{
+		LOG_ERROR("Unknown exception occurred: " + std::string(e.what()));
+		Close();
+		return false;
+	}
+	catch (...)
+	{
+		LOG_ERROR("Unknown error occurred.");
+		Close();
+		return false;
+	}
 
-		try
+	return true;
+}
+
+//
+// Peers that exceed the download or message limits aren't banned. Reading from them just pauses until they're back
+// under the limit, which pushes back on the sender through TCP flow control.
+//
+void Connection::ThrottleReceive(const uint64_t numBytes)
+{
+	const std::chrono::milliseconds delay = (std::max)(
+		m_downloadBytes.Consume((double)numBytes),
+		m_downloadMessages.Consume(1)
+	);
+	if (delay.count() == 0)
+	{
+		ReceiveHeader();
+		return;
+	}
+
+	LOG_TRACE_F("Throttling reads from ({}) for {}ms", m_connectedPeer, delay.count());
+	m_pStats->AddDownloadThrottled(delay.count());
+	m_readThrottleTimer.expires_after(delay);
+	m_readThrottleTimer.async_wait(asio::bind_executor(m_strand, [pConnection = shared_from_this()](const asio::error_code& ec)
+	{
+		if (!ec)
 		{
-			bool messageSentOrReceived = false;
+			pConnection->ReceiveHeader();
+		}
+	}));
+}
 
-			// Check for received messages and if there is a new message, process it.
-			std::unique_ptr<RawMessage> pRawMessage = pConnection->m_pMessageRetriever->RetrieveMessage(
-				*pConnection->m_pSocket,
-				pConnection->m_connectedPeer,
-				MessageRetriever::NON_BLOCKING
-			);
+void Connection::SchedulePing()
+{
+	m_pingTimer.expires_after(PING_INTERVAL);
+	m_pingTimer.async_wait(asio::bind_executor(m_strand, [pConnection = shared_from_this()](const asio::error_code& ec) { pConnection->OnPingTimer(ec); }));
+}
 
-			if (pRawMessage != nullptr)
-			{
-				const MessageProcessor::EStatus status = pConnection->m_pMessageProcessor->ProcessMessage(
-					pConnection->m_connectionId,
-					*pConnection->m_pSocket,
-					pConnection->m_connectedPeer,
-					*pRawMessage
-				);
-
-                if (status == MessageProcessor::EStatus::BAN_PEER)
-                {
-					EBanReason banReason = EBanReason::Abusive; // TODO: Determine real reason.
-					LOG_WARNING_F("Banning peer ({}) for ({}).", pConnection->GetIPAddress(), BanReason::Format(banReason));
-					pConnection->GetPeer()->Ban(banReason);
-					break;
-                }
-                
-                lastReceivedMessageTime = std::chrono::system_clock::now();
-				messageSentOrReceived = true;
-			}
+void Connection::OnPingTimer(const asio::error_code& ec)
+{
+	if (ec || m_terminate)
+	{
+		return;
+	}
 
-			// Send the next message in the queue, if one exists.
-			auto pMessageToSend = pConnection->m_sendQueue.copy_front();
-			if (pMessageToSend != nullptr)
-			{
-				IMessagePtr pMessage = *pMessageToSend;
-				pConnection->m_sendQueue.pop_front(1);
+	if (GetPeer()->IsBanned())
+	{
+		Close();
+		return;
+	}
 
-				pConnection->m_pMessageSender->Send(*pConnection->m_pSocket, *pMessage);
+	const auto lastReceivedTime = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(m_lastReceivedTime.load()));
+	if (lastReceivedTime + IDLE_TIMEOUT < std::chrono::steady_clock::now())
+	{
+		LOG_DEBUG_F("Closing idle connection with ({})", m_connectedPeer);
+		Close();
+		return;
+	}
 
-				messageSentOrReceived = true;
-			}
-			
-			if (!messageSentOrReceived)
-			{
-				if ((lastReceivedMessageTime + std::chrono::seconds(30)) < std::chrono::system_clock::now())
-				{
-					break;
-				}
+	Send(PingMessage(m_pSyncStatus->GetBlockDifficulty(), m_pSyncStatus->GetBlockHeight()));
+	SchedulePing();
+}
 
-				ThreadUtil::SleepFor(std::chrono::milliseconds(5), pConnection->m_terminate);
-			}
+void Connection::Enqueue(PendingWrite&& pendingWrite)
+{
+	if (m_terminate)
+	{
+		return;
+	}
+
+	asio::post(m_strand, [pConnection = shared_from_this(), pendingWrite = std::move(pendingWrite)]() mutable
+	{
+		if (pConnection->m_terminate)
+		{
+			return;
 		}
-		catch (const DeserializationException&)
+
+		pConnection->m_writeQueue.emplace_back(std::move(pendingWrite));
+		if (!pConnection->m_writing)
 		{
-			LOG_ERROR("Deserialization exception occurred");
-			break;
+			pConnection->m_writing = true;
+			pConnection->WriteNext();
 		}
-		catch (const SocketException&)
+	});
+}
+
+//
+// Starts writing the next queued message or stream chunk. Only one write is ever outstanding,
+// so messages can't interleave with each other or with a stream.
+//
+void Connection::WriteNext()
+{
+	while (!m_writeQueue.empty() && !m_terminate)
+	{
+		PendingWrite& next = m_writeQueue.front();
+		if (next.readChunk)
 		{
-			#ifdef _WIN32
-			const int lastError = WSAGetLastError();
+			auto pChunk = std::make_shared<std::vector<unsigned char>>();
 
-			TCHAR* s = NULL;
-			FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-				NULL, lastError, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR)&s, 0, NULL);
+			bool hasChunk = false;
+			try
+			{
+				hasChunk = next.readChunk(*pChunk);
+			}
+			catch (const std::exception& e)
+			{
+				LOG_ERROR_F("Failed to read stream for ({}): {}", m_connectedPeer, e.what());
+				m_writeQueue.clear();
+				m_writing = false;
+				Close();
+				return;
+			}
 
-			const std::string errorMessage = StringUtil::ToUTF8(s);
-			LOG_DEBUG("Socket exception occurred: " + errorMessage);
+			if (!hasChunk)
+			{
+				m_writeQueue.pop_front();
+				continue;
+			}
 
-			LocalFree(s);
-			#endif
-			break;
-		}
-		catch (const std::exception& e)
-		{
-			LOG_ERROR("Unknown exception occurred: " + std::string(e.what()));
-			break;
+			m_pSocket->AsyncSend(
+				m_strand,
+				pChunk,
+				false,
+				[pConnection = shared_from_this()](const asio::error_code& ec, const size_t bytesWritten)
+				{
+					pConnection->OnWriteComplete(ec, MessageTypes::TxHashSetArchive, bytesWritten, false);
+				}
+			);
 		}
-		catch (...)
+		else
 		{
-			LOG_ERROR("Unknown error occurred.");
-			break;
+			std::shared_ptr<const std::vector<unsigned char>> pBytes = next.pBytes;
+			m_writeQueue.pop_front();
+
+			// The message type is the 3rd byte of the header, after the magic bytes.
+			const uint8_t messageType = pBytes->size() > 2 ? (*pBytes)[2] : 0;
+			m_pSocket->AsyncSend(
+				m_strand,
+				pBytes,
+				true,
+				[pConnection = shared_from_this(), messageType](const asio::error_code& ec, const size_t bytesWritten)
+				{
+					pConnection->OnWriteComplete(ec, messageType, bytesWritten, true);
+				}
+			);
 		}
+
+		return;
 	}
 
-	pConnection->GetSocket()->CloseSocket();
-	pConnection->m_connectedPeer.GetPeer()->SetConnected(false);
+	m_writeQueue.clear();
+	m_writing = false;
 }
+
+void Connection::OnWriteComplete(const asio::error_code& ec, const uint8_t messageType, const size_t numBytes, const bool isMessage)
+{
+	m_pStats->AddSent(messageType, numBytes, (isMessage && !ec) ? 1 : 0);
+
+	if (ec)
+	{
+		m_writeQueue.clear();
+		m_writing = false;
+		Close();
+		return;
+	}
+
+	const std::chrono::milliseconds delay = m_uploadBytes.Consume((double)numBytes);
+	if (delay.count() == 0)
+	{
+		WriteNext();
+		return;
+	}
+
+	m_pStats->AddUploadThrottled(delay.count());
+	m_writeThrottleTimer.expires_after(delay);
+	m_writeThrottleTimer.async_wait(asio::bind_executor(m_strand, [pConnection = shared_from_this()](const asio::error_code& ec)
+	{
+		if (ec)
+		{
+			pConnection->m_writeQueue.clear();
+			pConnection->m_writing = false;
+			return;
+		}
+
+		pConnection->WriteNext();
+	}));
+}
\ No newline at end of file
@@ -2,31 +2,39 @@
 
 #include "Seed/PeerManager.h"
 #include "Messages/Message.h"
+#include "Messages/MessageHeader.h"
 
-#include <Common/ConcurrentQueue.h>
 #include <BlockChain/BlockChainServer.h>
 #include <Net/Socket.h>
+#include <Net/BufferPool.h>
+#include <Net/TokenBucket.h>
 #include <P2P/ConnectedPeer.h>
+#include <P2P/ConnectionStats.h>
 #include <Config/Config.h>
 #include <atomic>
-#include <queue>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
 
 // Forward Declarations
 class IMessage;
+class RawMessage;
 class ConnectionManager;
 class PeerManager;
 class Pipeline;
 class HandShake;
 class MessageProcessor;
-class MessageRetriever;
 class MessageSender;
 
 //
 // A Connection will be created for each ConnectedPeer.
-// Each Connection will run on its own thread, and will watch the socket for messages,
-// and will ping the peer when it hasn't been heard from in a while.
+// Connecting and handshaking happen on a short-lived thread. After that, the Connection is driven entirely by
+// asynchronous reads, writes, and a ping timer on the ConnectionManager's io_context, so idle peers cost no CPU time.
+// All socket operations and completion handlers run on the connection's strand. Received messages are processed on
+// the ConnectionManager's message pool, and the next read is only started once the previous message is processed.
 //
-class Connection
+class Connection : public std::enable_shared_from_this<Connection>
 {
 public:
 	Connection(const Connection&) = delete;
@@ -52,6 +60,19 @@ public:
 
 	void Send(const IMessage& message);
 
+	//
+	// Queues a message that was already serialized with MessageSender::Serialize.
+	// The buffer is never modified, so the same one can be queued on many connections.
+	//
+	void Send(std::shared_ptr<const std::vector<unsigned char>> pSerializedMessage);
+
+	//
+	// Writes a raw byte stream after all messages that are already queued, and before any that are queued later.
+	// readChunk is called each time the previous chunk has been written, and should return false once the stream is finished.
+	// If readChunk throws, the connection is closed.
+	//
+	void SendStream(const std::function<bool(std::vector<unsigned char>&)>& readChunk);
+
 	SocketPtr GetSocket() const { return m_pSocket; }
 	PeerPtr GetPeer() { return m_connectedPeer.GetPeer(); }
 	PeerConstPtr GetPeer() const { return m_connectedPeer.GetPeer(); }
@@ -60,30 +81,53 @@ public:
 	uint64_t GetTotalDifficulty() const { return m_connectedPeer.GetTotalDifficulty(); }
 	uint64_t GetHeight() const { return m_connectedPeer.GetHeight(); }
 	Capabilities GetCapabilities() const { return m_connectedPeer.GetPeer()->GetCapabilities(); }
-
-	bool ExceedsRateLimit() const;
+	const ConnectionStatsPtr& GetStats() const { return m_pStats; }
 
 private:
 	Connection(
 		SocketPtr pSocket,
 		const uint64_t connectionId,
+		const Config& config,
 		ConnectionManager& connectionManager,
 		const ConnectedPeer& connectedPeer,
 		SyncStatusConstPtr pSyncStatus,
 		std::shared_ptr<HandShake> pHandShake,
 		std::shared_ptr<MessageProcessor> pMessageProcessor,
-		std::shared_ptr<MessageRetriever> pMessageRetriever,
 		std::shared_ptr<MessageSender> pMessageSender
 	);
 
-	static void Thread_ProcessConnection(std::shared_ptr<Connection> pConnection);
+	static void Thread_Connect(std::shared_ptr<Connection> pConnection);
+
+	void Close();
+
+	// Read chain: header -> payload -> MessageProcessor (on the message pool) -> header
+	void ReceiveHeader();
+	void OnHeaderReceived(const asio::error_code& ec);
+	void OnPayloadReceived(const asio::error_code& ec);
+	void ThrottleReceive(const uint64_t numBytes);
 
+	// Returns false if the connection was closed.
+	bool ProcessMessage(const RawMessage& rawMessage);
+
+	void SchedulePing();
+	void OnPingTimer(const asio::error_code& ec);
+
+	struct PendingWrite
+	{
+		std::shared_ptr<const std::vector<unsigned char>> pBytes;
+		std::function<bool(std::vector<unsigned char>&)> readChunk;
+	};
+
+	void Enqueue(PendingWrite&& pendingWrite);
+	void WriteNext();
+	void OnWriteComplete(const asio::error_code& ec, const uint8_t messageType, const size_t numBytes, const bool isMessage);
+
+	const Config& m_config;
 	ConnectionManager& m_connectionManager;
 	SyncStatusConstPtr m_pSyncStatus;
 
 	std::shared_ptr<HandShake> m_pHandShake;
 	std::shared_ptr<MessageProcessor> m_pMessageProcessor;
-	std::shared_ptr<MessageRetriever> m_pMessageRetriever;
 	std::shared_ptr<MessageSender> m_pMessageSender;
 
 	std::atomic<bool> m_terminate = true;
@@ -92,10 +136,26 @@ private:
 
 	ConnectedPeer m_connectedPeer;
 
-	std::shared_ptr<asio::io_context> m_pContext;
 	mutable SocketPtr m_pSocket;
-
-	ConcurrentQueue<IMessagePtr> m_sendQueue;
+	ConnectionStatsPtr m_pStats;
+	Socket::Strand m_strand;
+
+	// Only touched by the read chain, which never has more than one read outstanding.
+	std::vector<unsigned char> m_headerBuffer;
+	MessageHeader m_messageHeader;
+	BufferPool::Buffer m_pPayload;
+	std::atomic<std::chrono::steady_clock::rep> m_lastReceivedTime;
+	TokenBucket m_downloadBytes;
+	TokenBucket m_downloadMessages;
+	asio::steady_timer m_readThrottleTimer;
+
+	asio::steady_timer m_pingTimer;
+
+	// Only touched on m_strand. m_writing stays set while waiting on the upload limit, so nothing else starts a write.
+	std::deque<PendingWrite> m_writeQueue;
+	bool m_writing;
+	TokenBucket m_uploadBytes;
+	asio::steady_timer m_writeThrottleTimer;
 };
 
 typedef std::shared_ptr<Connection> ConnectionPtr;
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ConnectionManager.h"
+#include "MessageSender.h"
 #include "Sync/Syncer.h"
 #include "Pipeline/Pipeline.h"
 #include "Seed/Seeder.h"
@@ -15,8 +16,14 @@
 #include <Common/Util/ThreadUtil.h>
 #include <Crypto/RandomNumberGenerator.h>
 
-ConnectionManager::ConnectionManager()
-	: m_connections(std::make_shared<std::vector<ConnectionPtr>>()),
+static const size_t MAX_POOLED_RECEIVE_BYTES = 32 * 1024 * 1024;
+
+ConnectionManager::ConnectionManager(const Config& config)
+	: m_config(config),
+	m_connections(std::make_shared<std::vector<ConnectionPtr>>()),
+	m_pIOContextPool(IOContextPool::Create((std::min)((size_t)4, (size_t)(std::max)(2u, std::thread::hardware_concurrency())))),
+	m_pBufferPool(BufferPool::Create(MAX_POOLED_RECEIVE_BYTES)),
+	m_pMessagePool(std::make_unique<WorkStealingPool>()),
 	m_numOutbound(0),
 	m_numInbound(0)
 {
@@ -32,9 +39,8 @@ void ConnectionManager::Shutdown()
 {
 	try
 	{
-		ThreadUtil::Join(m_broadcastThread);
-
 		PruneConnections(false);
+		m_pIOContextPool->Shutdown();
 	}
 	catch (const std::exception& e)
 	{
@@ -46,11 +52,9 @@ void ConnectionManager::Shutdown()
 	}
 }
 
-std::shared_ptr<ConnectionManager> ConnectionManager::Create()
+std::shared_ptr<ConnectionManager> ConnectionManager::Create(const Config& config)
 {
-	auto pConnectionManager = std::shared_ptr<ConnectionManager>(new ConnectionManager());
-	pConnectionManager->m_broadcastThread = std::thread(Thread_Broadcast, std::ref(*pConnectionManager));
-	return pConnectionManager;
+	return std::shared_ptr<ConnectionManager>(new ConnectionManager(config));
 }
 
 void ConnectionManager::UpdateSyncStatus(SyncStatus& syncStatus) const
@@ -188,7 +192,18 @@ bool ConnectionManager::SendMessageToPeer(const IMessage& message, PeerConstPtr
 
 void ConnectionManager::BroadcastMessage(const IMessage& message, const uint64_t sourceId)
 {
-	m_sendQueue.push_back(MessageToBroadcast(sourceId, message.Clone()));
+	// Sends are non-blocking, so there's no need to hand the message off to another thread.
+	auto pSerializedMessage = std::make_shared<const std::vector<unsigned char>>(MessageSender(m_config).Serialize(message));
+
+	// TODO: This should only broadcast to 8(?) peers. Should maybe be configurable.
+	auto pConnections = m_connections.Read();
+	for (const ConnectionPtr& pConnection : *pConnections)
+	{
+		if (pConnection->GetId() != sourceId)
+		{
+			pConnection->Send(pSerializedMessage);
+		}
+	}
 }
 
 void ConnectionManager::AddConnection(ConnectionPtr pConnection)
@@ -305,30 +320,4 @@ ConnectionPtr ConnectionManager::GetMostWorkPeer(const std::vector<ConnectionPtr
 	const size_t index = RandomNumberGenerator::GenerateRandom(0, mostWorkPeers.size() - 1);
 
 	return mostWorkPeers[index];
-}
-
-void ConnectionManager::Thread_Broadcast(ConnectionManager& connectionManager)
-{
-	while (!ShutdownManagerAPI::WasShutdownRequested()) 
-	{
-		std::unique_ptr<MessageToBroadcast> pBroadcastMessage = connectionManager.m_sendQueue.copy_front();
-		if (pBroadcastMessage != nullptr)
-		{
-			connectionManager.m_sendQueue.pop_front(1);
-
-			// TODO: This should only broadcast to 8(?) peers. Should maybe be configurable.
-			auto pConnections = connectionManager.m_connections.Read();
-			for (ConnectionPtr pConnection : *pConnections)
-			{
-				if (pConnection->GetId() != pBroadcastMessage->m_sourceId)
-				{
-					pConnection->Send(*pBroadcastMessage->m_pMessage);
-				}
-			}
-		}
-		else
-		{
-			ThreadUtil::SleepFor(std::chrono::milliseconds(100), ShutdownManagerAPI::WasShutdownRequested());
-		}
-	}
 }
\ No newline at end of file
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "Connection.h"
+#include "IOContextPool.h"
 
-#include <Common/ConcurrentQueue.h>
 #include <Core/Traits/Lockable.h>
+#include <Common/WorkStealingPool.h>
+#include <Config/Config.h>
 #include <memory>
 #include <vector>
 #include <thread>
@@ -12,13 +14,22 @@
 class ConnectionManager
 {
 public:
-	static std::shared_ptr<ConnectionManager> Create();
+	static std::shared_ptr<ConnectionManager> Create(const Config& config);
 	~ConnectionManager();
 
 	void Shutdown();
 
 	void UpdateSyncStatus(SyncStatus& syncStatus) const;
 
+	// The context that all peer sockets and timers run on.
+	const std::shared_ptr<asio::io_context>& GetIOContext() const { return m_pIOContextPool->GetContext(); }
+
+	// Receive buffers shared by all connections.
+	const BufferPoolPtr& GetBufferPool() const { return m_pBufferPool; }
+
+	// Workers that process received messages, so slow messages never hold up the IO threads.
+	WorkStealingPool& GetMessagePool() { return *m_pMessagePool; }
+
 	size_t GetNumInbound() const { return m_numInbound; }
 	size_t GetNumOutbound() const { return m_numOutbound; }
 	size_t GetNumberOfActiveConnections() const { return m_connections.Read()->size(); }
@@ -32,32 +43,27 @@ public:
 
 	PeerPtr SendMessageToMostWorkPeer(const IMessage& message, const bool preferGrinPP = false);
 	bool SendMessageToPeer(const IMessage& message, PeerConstPtr pPeer);
+
+	//
+	// Serializes the message once, and queues the same buffer on every connection except the source.
+	//
 	void BroadcastMessage(const IMessage& message, const uint64_t sourceId);
 
 	void PruneConnections(const bool bInactiveOnly);
 	void AddConnection(ConnectionPtr pConnection);
 
 private:
-	ConnectionManager();
+	ConnectionManager(const Config& config);
 
 	ConnectionPtr GetMostWorkPeer(const std::vector<ConnectionPtr>& connections, const bool preferGrinPP) const;
-	static void Thread_Broadcast(ConnectionManager& connectionManager);
-	
-	Locked<std::vector<ConnectionPtr>> m_connections;
-
-	struct MessageToBroadcast
-	{
-		MessageToBroadcast(uint64_t sourceId, std::shared_ptr<IMessage> pMessage)
-			: m_sourceId(sourceId), m_pMessage(pMessage)
-		{
 
-		}
-		uint64_t m_sourceId;
-		std::shared_ptr<IMessage> m_pMessage;
-	};
+	const Config& m_config;
+	Locked<std::vector<ConnectionPtr>> m_connections;
+	std::shared_ptr<IOContextPool> m_pIOContextPool;
+	BufferPoolPtr m_pBufferPool;
 
-	ConcurrentQueue<MessageToBroadcast> m_sendQueue;
-	std::thread m_broadcastThread;
+	// Declared after the IO pool, so it's destroyed first: processing tasks may still post to connection strands.
+	std::unique_ptr<WorkStealingPool> m_pMessagePool;
 
 	std::atomic<size_t> m_numOutbound;
 	std::atomic<size_t> m_numInbound;
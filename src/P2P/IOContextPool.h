@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Common/Util/ThreadUtil.h>
+#include <Infrastructure/ThreadManager.h>
+#include <Infrastructure/Logger.h>
+#include <asio.hpp>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+//
+// A small pool of threads running a single shared asio::io_context.
+// Every peer socket and timer lives on this context, so reads, writes, and pings complete on these threads
+// as events arrive, rather than each Connection polling its own socket.
+//
+class IOContextPool
+{
+public:
+	static std::shared_ptr<IOContextPool> Create(const size_t numThreads)
+	{
+		auto pPool = std::shared_ptr<IOContextPool>(new IOContextPool());
+		for (size_t i = 0; i < (std::max)((size_t)1, numThreads); i++)
+		{
+			pPool->m_threads.emplace_back(std::thread(Thread_Run, pPool->m_pContext));
+		}
+
+		return pPool;
+	}
+
+	~IOContextPool()
+	{
+		Shutdown();
+	}
+
+	void Shutdown()
+	{
+		m_workGuard.reset();
+		m_pContext->stop();
+		ThreadUtil::JoinAll(m_threads);
+		m_threads.clear();
+	}
+
+	const std::shared_ptr<asio::io_context>& GetContext() const { return m_pContext; }
+
+private:
+	IOContextPool()
+		: m_pContext(std::make_shared<asio::io_context>()),
+		m_workGuard(asio::make_work_guard(*m_pContext))
+	{
+
+	}
+
+	static void Thread_Run(std::shared_ptr<asio::io_context> pContext)
+	{
+		ThreadManagerAPI::SetCurrentThreadName("P2P_IO");
+		LOG_TRACE("BEGIN");
+
+		while (!pContext->stopped())
+		{
+			try
+			{
+				pContext->run();
+			}
+			catch (const std::exception& e)
+			{
+				LOG_ERROR_F("Exception thrown: {}", e.what());
+			}
+		}
+
+		LOG_TRACE("END");
+	}
+
+	std::shared_ptr<asio::io_context> m_pContext;
+	std::optional<asio::executor_work_guard<asio::io_context::executor_type>> m_workGuard;
+	std::vector<std::thread> m_threads;
+};
\ No newline at end of file
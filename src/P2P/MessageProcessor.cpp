@@ -1,8 +1,9 @@
 #include "MessageProcessor.h"
-#include "MessageSender.h"
+#include "Connection.h"
 #include "BlockLocator.h"
 #include "ConnectionManager.h"
 #include "Pipeline/Pipeline.h"
+#include "Sync/BlockDownloadScheduler.h"
 
 // Network Messages
 #include "Messages/ErrorMessage.h"
@@ -52,20 +53,21 @@ MessageProcessor::MessageProcessor(
 	Locked<PeerManager> peerManager,
 	IBlockChainServerPtr pBlockChainServer,
 	const std::shared_ptr<Pipeline>& pPipeline,
-	SyncStatusConstPtr pSyncStatus)
+	SyncStatusConstPtr pSyncStatus,
+	std::shared_ptr<BlockDownloadScheduler> pBlockScheduler)
 	: m_config(config),
 	m_connectionManager(connectionManager),
 	m_peerManager(peerManager),
 	m_pBlockChainServer(pBlockChainServer),
 	m_pPipeline(pPipeline),
-	m_pSyncStatus(pSyncStatus)
+	m_pSyncStatus(pSyncStatus),
+	m_pBlockScheduler(pBlockScheduler)
 {
 
 }
 
 MessageProcessor::EStatus MessageProcessor::ProcessMessage(
-	const uint64_t connectionId,
-	Socket& socket,
+	Connection& connection,
 	ConnectedPeer& connectedPeer,
 	const RawMessage& rawMessage)
 {
@@ -73,7 +75,7 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessage(
 
 	try
 	{
-		return ProcessMessageInternal(connectionId, socket, connectedPeer, rawMessage);
+		return ProcessMessageInternal(connection, connectedPeer, rawMessage);
 	}
 	catch (const BadDataException&)
 	{
@@ -96,11 +98,11 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessage(
 }
 
 MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
-	const uint64_t connectionId,
-	Socket& socket,
+	Connection& connection,
 	ConnectedPeer& connectedPeer,
 	const RawMessage& rawMessage)
 {
+	const uint64_t connectionId = connection.GetId();
 	const std::string formattedIPAddress = connectedPeer.GetPeer()->GetIPAddress().Format();
 	const MessageHeader& header = rawMessage.GetMessageHeader();
 	ByteBuffer byteBuffer(rawMessage.GetPayload());
@@ -131,7 +133,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				auto pTipHeader = m_pBlockChainServer->GetTipBlockHeader(EChainType::CONFIRMED);
 				const PongMessage pongMessage(pTipHeader->GetTotalDifficulty(), pTipHeader->GetHeight());
 
-				return MessageSender(m_config).Send(socket, pongMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+				connection.Send(pongMessage);
+				return EStatus::SUCCESS;
 			}
 			case Pong:
 			{
@@ -157,7 +160,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				LOG_TRACE_F("Sending {} addresses to {}.", socketAddresses.size(), formattedIPAddress);
 				const PeerAddressesMessage peerAddressesMessage(std::move(socketAddresses));
 
-				return MessageSender(m_config).Send(socket, peerAddressesMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+				connection.Send(peerAddressesMessage);
+				return EStatus::SUCCESS;
 			}
 			case PeerAddrs:
 			{
@@ -178,7 +182,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				LOG_DEBUG_F("Sending {} headers to {}.", blockHeaders.size(), formattedIPAddress);
                 
 				const HeadersMessage headersMessage(std::move(blockHeaders));
-				return MessageSender(m_config).Send(socket, headersMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+				connection.Send(headersMessage);
+				return EStatus::SUCCESS;
 			}
 			case Header:
 			{
@@ -203,7 +208,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 					if (!m_pBlockChainServer->HasBlock(pBlockHeader->GetHeight(), pBlockHeader->GetHash()))
 					{
 						const GetCompactBlockMessage getCompactBlockMessage(pBlockHeader->GetHash());
-						return MessageSender(m_config).Send(socket, getCompactBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+						connection.Send(getCompactBlockMessage);
+						return EStatus::SUCCESS;
 					}
 				}
 				else if (status == EBlockChainStatus::INVALID)
@@ -226,6 +232,12 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 
 				LOG_DEBUG_F("{} headers received from {}", blockHeaders.size(), formattedIPAddress);
 
+				// During header sync, batches are verified and added in the background so the next batch can be requested right away.
+				if (m_pSyncStatus->GetStatus() == ESyncStatus::SYNCING_HEADERS)
+				{
+					return m_pPipeline->GetHeaderPipe()->AddHeadersToProcess(connectedPeer.GetPeer(), blockHeaders) ? EStatus::SUCCESS : EStatus::BAN_PEER;
+				}
+
 				const EBlockChainStatus status = pBlockChainServer->AddBlockHeaders(blockHeaders);
 				LOG_DEBUG_F("Headers message from {} finished processing", formattedIPAddress);
 
@@ -238,25 +250,33 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				if (pBlock != nullptr)
 				{
 					BlockMessage blockMessage(std::move(*pBlock));
-					return MessageSender(m_config).Send(socket, blockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+					connection.Send(blockMessage);
+					return EStatus::SUCCESS;
 				}
 
 				return EStatus::RESOURCE_NOT_FOUND;
 			}
 			case Block:
 			{
-				const BlockMessage blockMessage = BlockMessage::Deserialize(byteBuffer);
-				const FullBlock& block = blockMessage.GetBlock();
+				// Deserialized straight into a shared block, so it can be handed to the BlockPipe without a copy.
+				const FullBlock::CPtr pBlock = std::make_shared<const FullBlock>(FullBlock::Deserialize(byteBuffer));
+				const FullBlock& block = *pBlock;
 
 				LOG_TRACE_F("Block received: {}", block.GetHeight());
 
 				if (m_pSyncStatus->GetStatus() == ESyncStatus::SYNCING_BLOCKS)
 				{
-					m_pPipeline->GetBlockPipe()->AddBlockToProcess(connectedPeer.GetPeer(), block);
+					m_pBlockScheduler->OnBlockReceived(
+						connectedPeer.GetPeer()->GetIPAddress(),
+						block.GetHeight(),
+						block.GetHash(),
+						rawMessage.GetPayload().size()
+					);
+					m_pPipeline->GetBlockPipe()->AddBlockToProcess(connectedPeer.GetPeer(), pBlock);
 				}
 				else
 				{
-					const EBlockChainStatus added = m_pBlockChainServer->AddBlock(block);
+					const EBlockChainStatus added = m_pBlockChainServer->AddBlock(block, formattedIPAddress);
 					if (added == EBlockChainStatus::SUCCESS)
 					{
 						const HeaderMessage headerMessage(block.GetBlockHeader());
@@ -268,7 +288,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 						if (block.GetTotalDifficulty() > m_pBlockChainServer->GetTotalDifficulty(EChainType::CONFIRMED))
 						{
 							const GetCompactBlockMessage getPreviousCompactBlockMessage(block.GetPreviousHash());
-							return MessageSender(m_config).Send(socket, getPreviousCompactBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+							connection.Send(getPreviousCompactBlockMessage);
+							return EStatus::SUCCESS;
 						}
 					}
 					else if (added == EBlockChainStatus::INVALID)
@@ -286,7 +307,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				if (pCompactBlock != nullptr)
 				{
 					const CompactBlockMessage compactBlockMessage(*pCompactBlock);
-					return MessageSender(m_config).Send(socket, compactBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+					connection.Send(compactBlockMessage);
+					return EStatus::SUCCESS;
 				}
 
 				return EStatus::RESOURCE_NOT_FOUND;
@@ -296,7 +318,7 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				const CompactBlockMessage compactBlockMessage = CompactBlockMessage::Deserialize(byteBuffer);
 				const CompactBlock& compactBlock = compactBlockMessage.GetCompactBlock();
 
-				const EBlockChainStatus added = m_pBlockChainServer->AddCompactBlock(compactBlock);
+				const EBlockChainStatus added = m_pBlockChainServer->AddCompactBlock(compactBlock, formattedIPAddress);
 				if (added == EBlockChainStatus::SUCCESS)
 				{
 					const HeaderMessage headerMessage(compactBlock.GetBlockHeader());
@@ -306,7 +328,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				else if (added == EBlockChainStatus::TRANSACTIONS_MISSING)
 				{
 					const GetBlockMessage getBlockMessage(compactBlock.GetHash());
-					return MessageSender(m_config).Send(socket, getBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+					connection.Send(getBlockMessage);
+					return EStatus::SUCCESS;
 				}
 				else if (added == EBlockChainStatus::ORPHANED)
 				{
@@ -315,7 +338,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 						if (compactBlock.GetTotalDifficulty() > m_pBlockChainServer->GetTotalDifficulty(EChainType::CONFIRMED))
 						{
 							const GetCompactBlockMessage getPreviousCompactBlockMessage(compactBlock.GetPreviousHash());
-							return MessageSender(m_config).Send(socket, getPreviousCompactBlockMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+							connection.Send(getPreviousCompactBlockMessage);
+							return EStatus::SUCCESS;
 						}
 					}
 				}
@@ -352,13 +376,13 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 			{
 				const TxHashSetRequestMessage txHashSetRequestMessage = TxHashSetRequestMessage::Deserialize(byteBuffer);
 
-				return SendTxHashSet(connectedPeer, socket, txHashSetRequestMessage);
+				return SendTxHashSet(connectedPeer, connection, txHashSetRequestMessage);
 			}
 			case TxHashSetArchive:
 			{
 				const TxHashSetArchiveMessage txHashSetArchiveMessage = TxHashSetArchiveMessage::Deserialize(byteBuffer);
 
-				return m_pPipeline->GetTxHashSetPipe()->ReceiveTxHashSet(connectedPeer.GetPeer(), socket, txHashSetArchiveMessage) ? EStatus::SUCCESS : EStatus::BAN_PEER;
+				return m_pPipeline->GetTxHashSetPipe()->ReceiveTxHashSet(connectedPeer.GetPeer(), *connection.GetSocket(), txHashSetArchiveMessage) ? EStatus::SUCCESS : EStatus::BAN_PEER;
 			}
 			case GetTransactionMsg:
 			{
@@ -369,7 +393,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				if (pTransaction != nullptr)
 				{
 					const TransactionMessage transactionMessage(pTransaction);
-					return MessageSender(m_config).Send(socket, transactionMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+					connection.Send(transactionMessage);
+					return EStatus::SUCCESS;
 				}
 
 				return EStatus::RESOURCE_NOT_FOUND;
@@ -388,7 +413,8 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 				if (pTransaction == nullptr)
 				{
 					const GetTransactionMessage getTransactionMessage(kernelHash);
-					return MessageSender(m_config).Send(socket, getTransactionMessage) ? EStatus::SUCCESS : EStatus::SOCKET_FAILURE;
+					connection.Send(getTransactionMessage);
+					return EStatus::SUCCESS;
 				}
 
 				return EStatus::RESOURCE_NOT_FOUND;
@@ -405,17 +431,17 @@ MessageProcessor::EStatus MessageProcessor::ProcessMessageInternal(
 
 MessageProcessor::EStatus MessageProcessor::SendTxHashSet(
 	ConnectedPeer& peer,
-	Socket& socket,
+	Connection& connection,
 	const TxHashSetRequestMessage& txHashSetRequestMessage)
 {
 	const time_t maxTxHashSetRequest = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() - std::chrono::hours(2));
 	if (peer.GetPeer()->GetLastTxHashSetRequest() > maxTxHashSetRequest)
 	{
-		LOG_WARNING_F("Peer ({}) requested multiple TxHashSet's within 2 hours.", socket.GetIPAddress());
+		LOG_WARNING_F("Peer ({}) requested multiple TxHashSet's within 2 hours.", connection.GetIPAddress());
 		return EStatus::BAN_PEER;
 	}
 
-	LOG_INFO_F("Sending TxHashSet snapshot to {}", socket.GetIPAddress());
+	LOG_INFO_F("Sending TxHashSet snapshot to {}", connection.GetIPAddress());
 	peer.GetPeer()->UpdateLastTxHashSetRequest();
 
 	auto pHeader = m_pBlockChainServer->GetBlockHeaderByHash(txHashSetRequestMessage.GetBlockHash());
@@ -436,60 +462,45 @@ MessageProcessor::EStatus MessageProcessor::SendTxHashSet(
 	}
 
 	// Hack until I can determine why zips aren't deleted.
-	FileRemover remover(zipFilePath);
+	auto pRemover = std::make_shared<FileRemover>(zipFilePath);
 
-	std::ifstream file(zipFilePath, std::ios::in | std::ios::ate | std::ios::binary);
-	if (!file.is_open())
+	auto pFile = std::make_shared<std::ifstream>(zipFilePath, std::ios::in | std::ios::binary);
+	if (!pFile->is_open())
 	{
-		FileUtil::RemoveFile(zipFilePath);
 		return EStatus::UNKNOWN_ERROR;
 	}
-	
-	try
-	{
-		const uint64_t fileSize = FileUtil::GetFileSize(zipFilePath);
-		file.seekg(0);
-		TxHashSetArchiveMessage archiveMessage(Hash(pHeader->GetHash()), pHeader->GetHeight(), fileSize);
-		MessageSender(m_config).Send(socket, archiveMessage);
 
-		socket.SetBlocking(false);
+	const uint64_t fileSize = FileUtil::GetFileSize(zipFilePath);
+	TxHashSetArchiveMessage archiveMessage(Hash(pHeader->GetHash()), pHeader->GetHeight(), fileSize);
+	connection.Send(archiveMessage);
 
-		std::vector<unsigned char> buffer(BUFFER_SIZE, 0);
-		uint64_t totalBytesRead = 0;
-		while (totalBytesRead < fileSize)
+	// The archive is read one chunk at a time, as the connection finishes writing the previous chunk.
+	// The file is closed and removed once the last reference to the stream is released.
+	auto pBytesRemaining = std::make_shared<uint64_t>(fileSize);
+	connection.SendStream([pRemover, pFile, pBytesRemaining](std::vector<unsigned char>& chunk)
 		{
-			file.read((char*)&buffer[0], BUFFER_SIZE);
-			const uint64_t bytesRead = file.gcount();
-
-			const std::vector<unsigned char> bytesToSend(buffer.cbegin(), buffer.cbegin() + bytesRead);
-			const bool sent = socket.Send(bytesToSend, false);
-
-			if (!sent || ShutdownManagerAPI::WasShutdownRequested())
+			if (*pBytesRemaining == 0)
 			{
-				LOG_ERROR("Transmission ended abruptly");
-				file.close();
-				FileUtil::RemoveFile(zipFilePath);
+				pFile->close();
+				return false;
+			}
 
-				return EStatus::BAN_PEER;
+			if (ShutdownManagerAPI::WasShutdownRequested())
+			{
+				throw std::runtime_error("Shutdown requested");
 			}
 
-			totalBytesRead += bytesRead;
-		}
+			chunk.resize((size_t)(std::min)((uint64_t)BUFFER_SIZE, *pBytesRemaining));
+			pFile->read((char*)chunk.data(), chunk.size());
+			if ((size_t)pFile->gcount() != chunk.size())
+			{
+				throw std::runtime_error("Transmission ended abruptly");
+			}
 
-		socket.SetBlocking(true);
-	}
-	catch (...)
-	{
-		if (file.is_open())
-		{
-			file.close();
+			*pBytesRemaining -= chunk.size();
+			return true;
 		}
-		FileUtil::RemoveFile(zipFilePath);
-		throw;
-	}
-
-	file.close();
-	FileUtil::RemoveFile(zipFilePath);
+	);
 
 	return EStatus::SUCCESS;
 }
\ No newline at end of file
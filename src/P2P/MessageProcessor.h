@@ -9,11 +9,12 @@
 #include <memory>
 
 // Forward Declarations
-class Socket;
+class Connection;
 class ConnectionManager;
 class ConnectedPeer;
 class RawMessage;
 class Pipeline;
+class BlockDownloadScheduler;
 class TxHashSetArchiveMessage;
 class TxHashSetRequestMessage;
 
@@ -37,14 +38,18 @@ public:
 		Locked<PeerManager> peerManager,
 		IBlockChainServerPtr pBlockChainServer,
 		const std::shared_ptr<Pipeline>& pipeline,
-		SyncStatusConstPtr pSyncStatus
+		SyncStatusConstPtr pSyncStatus,
+		std::shared_ptr<BlockDownloadScheduler> pBlockScheduler
 	);
 
-	EStatus ProcessMessage(const uint64_t connectionId, Socket& socket, ConnectedPeer& connectedPeer, const RawMessage& rawMessage);
+	//
+	// Processes a message received on the connection. Responses are queued on the connection, so this never blocks on a write.
+	//
+	EStatus ProcessMessage(Connection& connection, ConnectedPeer& connectedPeer, const RawMessage& rawMessage);
 
 private:
-	EStatus ProcessMessageInternal(const uint64_t connectionId, Socket& socket, ConnectedPeer& connectedPeer, const RawMessage& rawMessage);
-	EStatus SendTxHashSet(ConnectedPeer& connectedPeer, Socket& socket, const TxHashSetRequestMessage& txHashSetRequestMessage);
+	EStatus ProcessMessageInternal(Connection& connection, ConnectedPeer& connectedPeer, const RawMessage& rawMessage);
+	EStatus SendTxHashSet(ConnectedPeer& connectedPeer, Connection& connection, const TxHashSetRequestMessage& txHashSetRequestMessage);
 
 	const Config& m_config;
 	ConnectionManager& m_connectionManager;
@@ -52,4 +57,5 @@ private:
 	IBlockChainServerPtr m_pBlockChainServer;
 	std::shared_ptr<Pipeline> m_pPipeline;
 	SyncStatusConstPtr m_pSyncStatus;
+	std::shared_ptr<BlockDownloadScheduler> m_pBlockScheduler;
 };
\ No newline at end of file
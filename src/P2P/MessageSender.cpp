@@ -10,19 +10,24 @@ MessageSender::MessageSender(const Config& config)
 
 bool MessageSender::Send(Socket& socket, const IMessage& message) const
 {
-	Serializer serializer;
-	serializer.AppendByteVector(m_config.GetEnvironment().GetMagicBytes());
-	serializer.Append<uint8_t>((uint8_t)message.GetMessageType());
-
-	Serializer bodySerializer;
-	message.SerializeBody(bodySerializer);
-	serializer.Append<uint64_t>(bodySerializer.size());
-	serializer.AppendByteVector(bodySerializer.GetBytes());
-
 	if (message.GetMessageType() != MessageTypes::Ping && message.GetMessageType() != MessageTypes::Pong)
 	{
 		LOG_TRACE_F("Sending message ({}) to ({})", MessageTypes::ToString(message.GetMessageType()), socket);
 	}
 
-	return socket.Send(serializer.GetBytes(), true);
+	return socket.Send(Serialize(message), true);
+}
+
+std::vector<unsigned char> MessageSender::Serialize(const IMessage& message) const
+{
+	const std::vector<unsigned char>& magicBytes = m_config.GetEnvironment().GetMagicBytes();
+	const size_t bodySize = message.GetBodySize();
+
+	Serializer serializer(magicBytes.size() + 1 + 8 + bodySize);
+	serializer.AppendByteVector(magicBytes);
+	serializer.Append<uint8_t>((uint8_t)message.GetMessageType());
+	serializer.Append<uint64_t>(bodySize);
+	message.SerializeBody(serializer);
+
+	return serializer.Release();
 }
\ No newline at end of file
@@ -12,6 +12,9 @@ public:
 
 	bool Send(Socket& socket, const IMessage& message) const;
 
+	// Serializes the header (magic bytes, type, body length) and body into a single buffer.
+	std::vector<unsigned char> Serialize(const IMessage& message) const;
+
 private:
 	const Config& m_config;
 };
\ No newline at end of file
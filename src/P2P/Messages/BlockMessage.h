@@ -55,6 +55,11 @@ protected:
 		m_block.Serialize(serializer);
 	}
 
+	virtual size_t GetBodySize() const override final
+	{
+		return m_block.GetSerializedSize();
+	}
+
 private:
 	FullBlock m_block;
 };
\ No newline at end of file
@@ -60,6 +60,11 @@ protected:
 		m_block.Serialize(serializer);
 	}
 
+	virtual size_t GetBodySize() const override final
+	{
+		return m_block.GetSerializedSize();
+	}
+
 private:
 	CompactBlock m_block;
 };
\ No newline at end of file
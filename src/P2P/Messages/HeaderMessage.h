@@ -55,6 +55,11 @@ protected:
 		m_pHeader->Serialize(serializer);
 	}
 
+	virtual size_t GetBodySize() const override final
+	{
+		return m_pHeader->GetSerializedSize();
+	}
+
 private:
 	BlockHeaderPtr m_pHeader;
 };
\ No newline at end of file
@@ -66,6 +66,17 @@ protected:
 		}
 	}
 
+	virtual size_t GetBodySize() const override final
+	{
+		size_t size = 2;
+		for (const BlockHeaderPtr& pHeader : m_headers)
+		{
+			size += pHeader->GetSerializedSize();
+		}
+
+		return size;
+	}
+
 private:
 	std::vector<BlockHeaderPtr> m_headers;
 };
\ No newline at end of file
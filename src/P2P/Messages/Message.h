@@ -15,6 +15,17 @@ public:
 
 	virtual MessageTypes::EMessageType GetMessageType() const = 0;
 	virtual void SerializeBody(Serializer& serializer) const = 0;
+
+	//
+	// Number of bytes SerializeBody will append.
+	// Messages with large or frequently sent bodies calculate this directly, so they can be serialized into a single allocation.
+	//
+	virtual size_t GetBodySize() const
+	{
+		Serializer serializer;
+		SerializeBody(serializer);
+		return serializer.size();
+	}
 };
 
 typedef std::shared_ptr<IMessage> IMessagePtr;
\ No newline at end of file
@@ -57,6 +57,11 @@ protected:
 		serializer.Append<uint64_t>(m_height);
 	}
 
+	virtual size_t GetBodySize() const override final
+	{
+		return 16;
+	}
+
 private:
 	// Total difficulty accumulated by the sender, used to check whether sync may be needed.
 	const uint64_t m_totalDifficulty;
@@ -2,6 +2,7 @@
 
 #include "MessageHeader.h"
 
+#include <Net/BufferPool.h>
 #include <vector>
 
 class RawMessage
@@ -11,11 +12,16 @@ public:
 	// Constructors
 	//
 	RawMessage(MessageHeader&& messageHeader, std::vector<unsigned char>&& payload)
-		: m_messageHeader(messageHeader), m_payload(std::move(payload))
+		: m_messageHeader(messageHeader), m_pPayload(BufferPool::Wrap(std::move(payload)))
 	{
 
 	}
-	RawMessage(const RawMessage& other) = default;
+	RawMessage(MessageHeader&& messageHeader, BufferPool::Buffer&& pPayload)
+		: m_messageHeader(messageHeader), m_pPayload(std::move(pPayload))
+	{
+
+	}
+	RawMessage(const RawMessage& other) = delete;
 	RawMessage(RawMessage&& other) noexcept = default;
 
 	//
@@ -26,16 +32,18 @@ public:
 	//
 	// Operators
 	//
-	RawMessage& operator=(const RawMessage& other) = default;
+	RawMessage& operator=(const RawMessage& other) = delete;
 	RawMessage& operator=(RawMessage&& other) noexcept = default;
 
 	//
 	// Getters
 	//
 	const MessageHeader& GetMessageHeader() const { return m_messageHeader; }
-	const std::vector<unsigned char>& GetPayload() const { return m_payload; }
+	const std::vector<unsigned char>& GetPayload() const { return *m_pPayload; }
 
 private:
 	MessageHeader m_messageHeader;
-	std::vector<unsigned char> m_payload;
+
+	// May be a pooled receive buffer, which is handed back to its pool when the message is destroyed.
+	BufferPool::Buffer m_pPayload;
 };
\ No newline at end of file
@@ -56,6 +56,11 @@ protected:
 		m_pTransaction->Serialize(serializer);
 	}
 
+	virtual size_t GetBodySize() const override final
+	{
+		return m_pTransaction->GetSerializedSize();
+	}
+
 private:
 	TransactionPtr m_pTransaction;
 };
\ No newline at end of file
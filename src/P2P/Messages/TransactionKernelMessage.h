@@ -60,6 +60,11 @@ protected:
 		serializer.AppendBigInteger<32>(m_kernelHash);
 	}
 
+	virtual size_t GetBodySize() const override final
+	{
+		return 32;
+	}
+
 private:
 	Hash m_kernelHash;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Seed/Seeder.h"
 #include "Pipeline/Pipeline.h"
 #include "Sync/Syncer.h"
+#include "Sync/BlockDownloadScheduler.h"
 #include "Messages/TransactionKernelMessage.h"
 #include <BlockChain/BlockChainServer.h>
 
@@ -50,11 +51,11 @@ std::shared_ptr<P2PServer> P2PServer::Create(
 		pDatabase->GetPeerDB()
 	);
 
-	// Connection Manager
-	ConnectionManagerPtr pConnectionManager = ConnectionManager::Create();
-
 	const Config& config = pContext->GetConfig();
 
+	// Connection Manager
+	ConnectionManagerPtr pConnectionManager = ConnectionManager::Create(config);
+
 	// Pipeline
 	std::shared_ptr<Pipeline> pPipeline = Pipeline::Create(
 		config,
@@ -63,6 +64,9 @@ std::shared_ptr<P2PServer> P2PServer::Create(
 		pSyncStatus
 	);
 
+	// Block requests are scheduled by the Syncer, and deliveries reported by the Seeder's connections.
+	auto pBlockScheduler = std::make_shared<BlockDownloadScheduler>();
+
 	// Seeder
 	std::shared_ptr<Seeder> pSeeder = Seeder::Create(
 		pContext,
@@ -70,7 +74,8 @@ std::shared_ptr<P2PServer> P2PServer::Create(
 		peerManager,
 		pBlockChainServer,
 		pPipeline,
-		pSyncStatus
+		pSyncStatus,
+		pBlockScheduler
 	);
 
 	// Syncer
@@ -78,7 +83,8 @@ std::shared_ptr<P2PServer> P2PServer::Create(
 		pConnectionManager,
 		pBlockChainServer,
 		pPipeline,
-		pSyncStatus
+		pSyncStatus,
+		pBlockScheduler
 	);
 
 	// Dandelion
@@ -14,7 +14,12 @@ BlockPipe::BlockPipe(const Config& config, IBlockChainServerPtr pBlockChainServe
 
 BlockPipe::~BlockPipe()
 {
-	m_terminate = true;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_terminate = true;
+	}
+
+	m_blockVerified.notify_all();
 
 	ThreadUtil::Join(m_blockThread);
 	ThreadUtil::Join(m_processThread);
@@ -29,37 +34,58 @@ std::shared_ptr<BlockPipe> BlockPipe::Create(const Config& config, IBlockChainSe
 	return pBlockPipe;
 }
 
+void BlockPipe::VerifyBlock(const BlockEntry& blockEntry)
+{
+	// If verification throws, the block must still be released so it can be requested again.
+	ProcessingGuard guard(*this, blockEntry.m_pBlock->GetHash());
+	if (m_terminate)
+	{
+		return;
+	}
+
+	if (!m_pBlockChainServer->VerifyBlockSelfConsistent(*blockEntry.m_pBlock))
+	{
+		blockEntry.m_peer->Ban(EBanReason::BadBlock);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_verifiedBlocks.emplace(blockEntry.m_pBlock->GetHeight(), blockEntry);
+	}
+
+	// Thread_ProcessNewBlocks finishes the block from here.
+	guard.Release();
+	m_blockVerified.notify_one();
+}
+
+void BlockPipe::FinishBlock(const Hash& hash)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_processing.erase(hash);
+}
+
 void BlockPipe::Thread_ProcessNewBlocks(BlockPipe& pipeline)
 {
-	ThreadManagerAPI::SetCurrentThreadName("BLOCK_PREPROCESS_PIPE");
+	ThreadManagerAPI::SetCurrentThreadName("BLOCK_PROCESS_PIPE");
 	LOG_TRACE("BEGIN");
 
 	while (!pipeline.m_terminate)
 	{
-		std::vector<BlockEntry> blocksToProcess = pipeline.m_blocksToProcess.copy_front(8); // TODO: Use number of CPU threads.
-		if (!blocksToProcess.empty())
-		{
-			if (blocksToProcess.size() == 1)
-			{
-				ProcessNewBlock(pipeline, blocksToProcess.front());
-			}
-			else
-			{
-				std::vector<std::thread> tasks;
-				for (const BlockEntry& blockEntry : blocksToProcess)
-				{
-					tasks.push_back(std::thread([&pipeline, blockEntry] { ProcessNewBlock(pipeline, blockEntry); }));
-				}
-
-				ThreadUtil::JoinAll(tasks);
-			}
-
-			pipeline.m_blocksToProcess.pop_front(blocksToProcess.size());
-		}
-		else
+		std::unique_lock<std::mutex> lock(pipeline.m_mutex);
+		pipeline.m_blockVerified.wait(lock, [&pipeline] { return pipeline.m_terminate || !pipeline.m_verifiedBlocks.empty(); });
+		if (pipeline.m_terminate)
 		{
-			ThreadUtil::SleepFor(std::chrono::milliseconds(5), pipeline.m_terminate);
+			break;
 		}
+
+		// Lowest height first, so fewer blocks need to go through the orphan pool.
+		const BlockEntry blockEntry = pipeline.m_verifiedBlocks.begin()->second;
+		pipeline.m_verifiedBlocks.erase(pipeline.m_verifiedBlocks.begin());
+		lock.unlock();
+
+		ProcessNewBlock(pipeline, blockEntry);
+		pipeline.FinishBlock(blockEntry.m_pBlock->GetHash());
 	}
 
 	LOG_TRACE("END");
@@ -69,7 +95,8 @@ void BlockPipe::ProcessNewBlock(BlockPipe& pipeline, const BlockEntry& blockEntr
 {
 	try
 	{
-		const EBlockChainStatus status = pipeline.m_pBlockChainServer->AddBlock(blockEntry.m_block);
+		// The block was marked as validated by VerifyBlock, so only the contextual checks are repeated.
+		const EBlockChainStatus status = pipeline.m_pBlockChainServer->AddBlock(*blockEntry.m_pBlock, blockEntry.m_peer->GetIPAddress().Format());
 		if (status == EBlockChainStatus::INVALID)
 		{
 			blockEntry.m_peer->Ban(EBanReason::BadBlock);
@@ -77,7 +104,7 @@ void BlockPipe::ProcessNewBlock(BlockPipe& pipeline, const BlockEntry& blockEntr
 	}
 	catch (std::exception& e)
 	{
-		LOG_ERROR_F("Exception ({}) caught while attempting to add block {}.", e.what(), blockEntry.m_block);
+		LOG_ERROR_F("Exception ({}) caught while attempting to add block {}.", e.what(), *blockEntry.m_pBlock);
 		blockEntry.m_peer->Ban(EBanReason::BadBlock);
 	}
 }
@@ -89,31 +116,38 @@ void BlockPipe::Thread_PostProcessBlocks(BlockPipe& pipeline)
 
 	while (!pipeline.m_terminate)
 	{
-		if (!pipeline.m_pBlockChainServer->ProcessNextOrphanBlock())
+		// Only wakes up to check for shutdown until the chain reports an orphan that can connect.
+		if (!pipeline.m_pBlockChainServer->WaitForOrphanBlock(std::chrono::milliseconds(500)))
+		{
+			continue;
+		}
+
+		// Applying an orphan can make its own child ready, so keep going until the chain is stuck again.
+		while (!pipeline.m_terminate && pipeline.m_pBlockChainServer->ProcessNextOrphanBlock())
 		{
-			ThreadUtil::SleepFor(std::chrono::milliseconds(5), pipeline.m_terminate);
+
 		}
 	}
 
 	LOG_TRACE("END");
 }
 
-bool BlockPipe::AddBlockToProcess(PeerPtr pPeer, const FullBlock& block)
+bool BlockPipe::AddBlockToProcess(PeerPtr pPeer, const FullBlock::CPtr& pBlock)
 {
-	std::function<bool(const BlockEntry&, const BlockEntry&)> comparator = [](const BlockEntry& blockEntry1, const BlockEntry& blockEntry2)
 	{
-		return blockEntry1.m_block.GetHash() == blockEntry2.m_block.GetHash();
-	};
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (!m_processing.insert(pBlock->GetHash()).second)
+		{
+			return false;
+		}
+	}
 
-	return m_blocksToProcess.push_back_unique(BlockEntry(pPeer, block), comparator);
+	m_validationPool.Submit([this, blockEntry = BlockEntry(pPeer, pBlock)] { VerifyBlock(blockEntry); });
+	return true;
 }
 
 bool BlockPipe::IsProcessingBlock(const Hash& hash) const
 {
-	std::function<bool(const BlockEntry&, const Hash&)> comparator = [](const BlockEntry& blockEntry, const Hash& hash)
-	{
-		return blockEntry.m_block.GetHash() == hash;
-	};
-
-	return m_blocksToProcess.contains<Hash>(hash, comparator);
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_processing.find(hash) != m_processing.end();
 }
\ No newline at end of file
@@ -4,7 +4,11 @@
 #include <P2P/Peer.h>
 #include <Core/Models/FullBlock.h>
 #include <BlockChain/BlockChainServer.h>
-#include <Common/ConcurrentQueue.h>
+#include <Common/WorkStealingPool.h>
+#include <unordered_set>
+#include <condition_variable>
+#include <mutex>
+#include <map>
 #include <string>
 #include <cstdint>
 #include <atomic>
@@ -15,6 +19,11 @@ class Config;
 class TxHashSetArchiveMessage;
 class Transaction;
 
+//
+// Processes blocks received during block sync in two stages.
+// Context-free validation (signatures, rangeproofs, sums) runs in parallel on a work-stealing pool,
+// and blocks that pass are handed to a single thread that adds them to the chain, lowest height first.
+//
 class BlockPipe
 {
 public:
@@ -24,7 +33,7 @@ public:
 	);
 	~BlockPipe();
 
-	bool AddBlockToProcess(PeerPtr pPeer, const FullBlock& block);
+	bool AddBlockToProcess(PeerPtr pPeer, const FullBlock::CPtr& pBlock);
 	bool IsProcessingBlock(const Hash& hash) const;
 
 private:
@@ -35,25 +44,62 @@ private:
 
 	struct BlockEntry
 	{
-		BlockEntry(PeerPtr pPeer, const FullBlock& fullBlock)
-			: m_peer(pPeer), m_block(fullBlock)
+		BlockEntry(PeerPtr pPeer, const FullBlock::CPtr& pBlock)
+			: m_peer(pPeer), m_pBlock(pBlock)
 		{
 
 		}
 
 		PeerPtr m_peer;
-		FullBlock m_block;
+		FullBlock::CPtr m_pBlock;
 	};
 
-	// Pre-Process New Blocks
+	// Removes the block from m_processing when it goes out of scope, unless it was handed off to the process thread.
+	class ProcessingGuard
+	{
+	public:
+		ProcessingGuard(BlockPipe& pipeline, const Hash& hash)
+			: m_pipeline(pipeline), m_hash(hash), m_released(false)
+		{
+
+		}
+
+		~ProcessingGuard()
+		{
+			if (!m_released)
+			{
+				m_pipeline.FinishBlock(m_hash);
+			}
+		}
+
+		void Release() noexcept { m_released = true; }
+
+	private:
+		BlockPipe& m_pipeline;
+		Hash m_hash;
+		bool m_released;
+	};
+
+	// Validate New Blocks
+	void VerifyBlock(const BlockEntry& blockEntry);
+	void FinishBlock(const Hash& hash);
+
+	// Add Validated Blocks
 	static void Thread_ProcessNewBlocks(BlockPipe& pipeline);
 	static void ProcessNewBlock(BlockPipe& pipeline, const BlockEntry& blockEntry);
 	std::thread m_blockThread;
-	ConcurrentQueue<BlockEntry> m_blocksToProcess;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_blockVerified;
+	std::unordered_set<Hash> m_processing;
+	std::multimap<uint64_t, BlockEntry> m_verifiedBlocks;
 
 	// Process Next Block
 	std::thread m_processThread;
 	static void Thread_PostProcessBlocks(BlockPipe& pipeline);
 
 	std::atomic_bool m_terminate;
+
+	// Declared last so its workers are stopped before the state they use is destroyed.
+	WorkStealingPool m_validationPool;
 };
\ No newline at end of file
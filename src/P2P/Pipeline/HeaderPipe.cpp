@@ -0,0 +1,279 @@
+#include "HeaderPipe.h"
+
+#include <Common/Util/ThreadUtil.h>
+#include <Infrastructure/ThreadManager.h>
+#include <Infrastructure/Logger.h>
+#include <BlockChain/BlockChainServer.h>
+#include <algorithm>
+
+// Enough to keep several round trips of headers in flight, while bounding memory to a few MB.
+static const size_t MAX_QUEUED_BATCHES = 32;
+
+HeaderPipe::HeaderPipe(const Config& config, IBlockChainServerPtr pBlockChainServer, const std::chrono::milliseconds& batchTimeout)
+	: m_config(config), m_pBlockChainServer(pBlockChainServer), m_batchTimeout(batchTimeout), m_terminate(false)
+{
+}
+
+HeaderPipe::~HeaderPipe()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_terminate = true;
+	}
+
+	m_batchAdded.notify_all();
+	m_batchVerified.notify_all();
+
+	ThreadUtil::Join(m_verifyThread);
+	ThreadUtil::Join(m_processThread);
+}
+
+std::shared_ptr<HeaderPipe> HeaderPipe::Create(const Config& config, IBlockChainServerPtr pBlockChainServer, const std::chrono::milliseconds& batchTimeout)
+{
+	std::shared_ptr<HeaderPipe> pHeaderPipe = std::shared_ptr<HeaderPipe>(new HeaderPipe(config, pBlockChainServer, batchTimeout));
+	pHeaderPipe->m_verifyThread = std::thread(Thread_VerifyHeaders, std::ref(*pHeaderPipe.get()));
+	pHeaderPipe->m_processThread = std::thread(Thread_ProcessHeaders, std::ref(*pHeaderPipe.get()));
+
+	return pHeaderPipe;
+}
+
+bool HeaderPipe::AddHeadersToProcess(PeerPtr pPeer, const std::vector<BlockHeaderPtr>& headers)
+{
+	if (headers.empty())
+	{
+		return true;
+	}
+
+	// Batches are chained together by hash, so they must be contiguous.
+	for (size_t i = 1; i < headers.size(); i++)
+	{
+		if (headers[i]->GetHeight() != headers[i - 1]->GetHeight() + 1 || headers[i]->GetPreviousHash() != headers[i - 1]->GetHash())
+		{
+			LOG_ERROR_F("Headers from {} are not contiguous.", pPeer);
+			return false;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	const Hash& previousHash = headers.front()->GetPreviousHash();
+	if (m_batches.find(previousHash) != m_batches.end())
+	{
+		LOG_TRACE_F("Already queued headers after {}", previousHash);
+		return true;
+	}
+
+	if (m_batches.size() >= MAX_QUEUED_BATCHES)
+	{
+		LOG_DEBUG_F("Header queue full. Dropping {} headers from {}", headers.size(), pPeer);
+		return true;
+	}
+
+	m_batches.emplace(previousHash, HeaderBatch(pPeer, headers));
+	lock.unlock();
+
+	m_batchAdded.notify_one();
+	return true;
+}
+
+BlockHeaderPtr HeaderPipe::GetDownloadTip() const
+{
+	BlockHeaderPtr pSyncTip = m_pBlockChainServer->GetTipBlockHeader(EChainType::SYNC);
+	if (pSyncTip == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	BlockHeaderPtr pDownloadTip = nullptr;
+	Hash hash = pSyncTip->GetHash();
+	for (size_t i = 0; i < m_batches.size(); i++)
+	{
+		auto iter = m_batches.find(hash);
+		if (iter == m_batches.end())
+		{
+			break;
+		}
+
+		pDownloadTip = iter->second.m_headers.back();
+		hash = pDownloadTip->GetHash();
+	}
+
+	return pDownloadTip;
+}
+
+bool HeaderPipe::IsFull() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_batches.size() >= MAX_QUEUED_BATCHES;
+}
+
+void HeaderPipe::Thread_VerifyHeaders(HeaderPipe& pipeline)
+{
+	ThreadManagerAPI::SetCurrentThreadName("HEADER_VERIFY_PIPE");
+	LOG_TRACE("BEGIN");
+
+	auto findUnverified = [&pipeline]()
+	{
+		auto lowest = pipeline.m_batches.end();
+		for (auto iter = pipeline.m_batches.begin(); iter != pipeline.m_batches.end(); iter++)
+		{
+			if (iter->second.m_pVerified == nullptr && (lowest == pipeline.m_batches.end()
+				|| iter->second.m_headers.front()->GetHeight() < lowest->second.m_headers.front()->GetHeight()))
+			{
+				lowest = iter;
+			}
+		}
+
+		return lowest;
+	};
+
+	while (!pipeline.m_terminate)
+	{
+		std::unique_lock<std::mutex> lock(pipeline.m_mutex);
+		pipeline.m_batchAdded.wait(lock, [&pipeline, &findUnverified] {
+			return pipeline.m_terminate || findUnverified() != pipeline.m_batches.end();
+		});
+
+		if (pipeline.m_terminate)
+		{
+			break;
+		}
+
+		auto iter = findUnverified();
+		const Hash previousHash = iter->first;
+		const PeerPtr pPeer = iter->second.m_peer;
+		const std::vector<BlockHeaderPtr> headers = iter->second.m_headers;
+		lock.unlock();
+
+		// Cycle verification doesn't depend on the chain, so it doesn't have to wait for earlier batches.
+		VerifiedHeadersPtr pVerified = nullptr;
+		try
+		{
+			pVerified = pipeline.m_pBlockChainServer->VerifyHeaderCycles(headers);
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_F("Exception ({}) caught while verifying headers from {}.", e.what(), pPeer);
+		}
+
+		lock.lock();
+		iter = pipeline.m_batches.find(previousHash);
+		if (iter == pipeline.m_batches.end())
+		{
+			continue;
+		}
+
+		if (pVerified != nullptr)
+		{
+			iter->second.m_pVerified = pVerified;
+			lock.unlock();
+			pipeline.m_batchVerified.notify_one();
+		}
+		else
+		{
+			pipeline.m_batches.erase(iter);
+			lock.unlock();
+			pPeer->Ban(EBanReason::BadBlockHeader);
+		}
+	}
+
+	LOG_TRACE("END");
+}
+
+void HeaderPipe::Thread_ProcessHeaders(HeaderPipe& pipeline)
+{
+	ThreadManagerAPI::SetCurrentThreadName("HEADER_PROCESS_PIPE");
+	LOG_TRACE("BEGIN");
+
+	while (!pipeline.m_terminate)
+	{
+		std::vector<std::pair<uint64_t, Hash>> candidates;
+		{
+			std::unique_lock<std::mutex> lock(pipeline.m_mutex);
+			pipeline.m_batchVerified.wait_for(lock, std::chrono::milliseconds(100));
+
+			for (const auto& entry : pipeline.m_batches)
+			{
+				if (entry.second.m_pVerified != nullptr)
+				{
+					candidates.push_back({ entry.second.m_headers.front()->GetHeight(), entry.first });
+				}
+			}
+		}
+
+		pipeline.EvictStaleBatches();
+
+		// Batches can only be added once the header before them is known, which is usually true of the lowest one.
+		std::sort(candidates.begin(), candidates.end());
+		for (const auto& candidate : candidates)
+		{
+			if (pipeline.m_terminate)
+			{
+				break;
+			}
+
+			if (pipeline.m_pBlockChainServer->GetBlockHeaderByHash(candidate.second) == nullptr)
+			{
+				continue;
+			}
+
+			PeerPtr pPeer = nullptr;
+			VerifiedHeadersPtr pVerified = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(pipeline.m_mutex);
+				auto iter = pipeline.m_batches.find(candidate.second);
+				if (iter == pipeline.m_batches.end())
+				{
+					continue;
+				}
+
+				pPeer = iter->second.m_peer;
+				pVerified = iter->second.m_pVerified;
+			}
+
+			try
+			{
+				const EBlockChainStatus status = pipeline.m_pBlockChainServer->AddVerifiedBlockHeaders(*pVerified);
+				if (status == EBlockChainStatus::INVALID)
+				{
+					pPeer->Ban(EBanReason::BadBlockHeader);
+				}
+			}
+			catch (std::exception& e)
+			{
+				LOG_ERROR_F("Exception ({}) caught while attempting to add headers from {}.", e.what(), pPeer);
+			}
+
+			pipeline.RemoveBatch(candidate.second);
+		}
+	}
+
+	LOG_TRACE("END");
+}
+
+void HeaderPipe::RemoveBatch(const Hash& previousHash)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_batches.erase(previousHash);
+}
+
+void HeaderPipe::EvictStaleBatches()
+{
+	const auto cutoff = std::chrono::steady_clock::now() - m_batchTimeout;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (auto iter = m_batches.begin(); iter != m_batches.end();)
+	{
+		if (iter->second.m_received < cutoff)
+		{
+			LOG_DEBUG_F("Evicting {} headers from {} that never connected.", iter->second.m_headers.size(), iter->second.m_peer);
+			iter = m_batches.erase(iter);
+		}
+		else
+		{
+			iter++;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Crypto/Hash.h>
+#include <P2P/Peer.h>
+#include <Core/Models/BlockHeader.h>
+#include <BlockChain/BlockChainServer.h>
+#include <unordered_map>
+#include <condition_variable>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <thread>
+
+// Forward Declarations
+class Config;
+
+//
+// Processes batches of headers received during header sync.
+// Batches may arrive before the headers they build on have been validated (or even received),
+// so they're held in a reorder buffer keyed by the hash of the header before them.
+// One thread verifies the cuckoo cycles of each batch as it arrives, while another
+// adds verified batches to the chain in order, once the header before them is known.
+//
+class HeaderPipe
+{
+public:
+	//
+	// Batches that still haven't connected to the chain after batchTimeout are evicted.
+	//
+	static std::shared_ptr<HeaderPipe> Create(
+		const Config& config,
+		IBlockChainServerPtr pBlockChainServer,
+		const std::chrono::milliseconds& batchTimeout = std::chrono::seconds(60)
+	);
+	~HeaderPipe();
+
+	//
+	// Queues the headers to be verified and added to the chain.
+	// Caller should ban peer if false is returned.
+	//
+	bool AddHeadersToProcess(PeerPtr pPeer, const std::vector<BlockHeaderPtr>& headers);
+
+	//
+	// Returns the last header that links to the sync chain through the queued batches,
+	// so the next batch can be requested before the queued ones are validated.
+	// Returns nullptr if no queued batch extends the sync chain.
+	//
+	BlockHeaderPtr GetDownloadTip() const;
+
+	//
+	// Returns true if no more batches will be accepted until the queued ones are processed.
+	//
+	bool IsFull() const;
+
+private:
+	HeaderPipe(const Config& config, IBlockChainServerPtr pBlockChainServer, const std::chrono::milliseconds& batchTimeout);
+
+	struct HeaderBatch
+	{
+		HeaderBatch(PeerPtr pPeer, const std::vector<BlockHeaderPtr>& headers)
+			: m_peer(pPeer), m_headers(headers), m_pVerified(nullptr), m_received(std::chrono::steady_clock::now())
+		{
+
+		}
+
+		PeerPtr m_peer;
+		std::vector<BlockHeaderPtr> m_headers;
+		VerifiedHeadersPtr m_pVerified;
+		std::chrono::steady_clock::time_point m_received;
+	};
+
+	static void Thread_VerifyHeaders(HeaderPipe& pipeline);
+	static void Thread_ProcessHeaders(HeaderPipe& pipeline);
+	void RemoveBatch(const Hash& previousHash);
+	void EvictStaleBatches();
+
+	const Config& m_config;
+	IBlockChainServerPtr m_pBlockChainServer;
+	std::chrono::milliseconds m_batchTimeout;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_batchAdded;
+	std::condition_variable m_batchVerified;
+	std::unordered_map<Hash, HeaderBatch> m_batches;
+
+	std::thread m_verifyThread;
+	std::thread m_processThread;
+	std::atomic_bool m_terminate;
+};
\ No newline at end of file
@@ -6,8 +6,10 @@
 #include <Infrastructure/Logger.h>
 #include <BlockChain/BlockChainServer.h>
 
+static const size_t MAX_QUEUED_TRANSACTIONS = 4096;
+
 TransactionPipe::TransactionPipe(const Config& config, ConnectionManagerPtr pConnectionManager, IBlockChainServerPtr pBlockChainServer)
-	: m_config(config), m_pConnectionManager(pConnectionManager), m_pBlockChainServer(pBlockChainServer), m_terminate(false)
+	: m_config(config), m_pConnectionManager(pConnectionManager), m_pBlockChainServer(pBlockChainServer), m_transactionsToProcess(MAX_QUEUED_TRANSACTIONS), m_terminate(false)
 {
 
 }
@@ -15,6 +17,7 @@ TransactionPipe::TransactionPipe(const Config& config, ConnectionManagerPtr pCon
 TransactionPipe::~TransactionPipe()
 {
 	m_terminate = true;
+	m_transactionsToProcess.close();
 
 	ThreadUtil::Join(m_transactionThread);
 }
@@ -34,38 +37,37 @@ void TransactionPipe::Thread_ProcessTransactions(TransactionPipe& pipeline)
 
 	while (!pipeline.m_terminate)
 	{
+		TxEntry txEntry;
+		if (!pipeline.m_transactionsToProcess.wait_pop(txEntry, std::chrono::milliseconds(100)))
+		{
+			continue;
+		}
+
 		try
 		{
-			std::unique_ptr<TxEntry> pTxEntry = pipeline.m_transactionsToProcess.copy_front();
-			if (pTxEntry != nullptr)
+			const EBlockChainStatus status = pipeline.m_pBlockChainServer->AddTransaction(txEntry.pTransaction, txEntry.poolType);
+			if (status == EBlockChainStatus::SUCCESS && txEntry.poolType == EPoolType::MEMPOOL)
 			{
-				const EBlockChainStatus status = pipeline.m_pBlockChainServer->AddTransaction(pTxEntry->pTransaction, pTxEntry->poolType);
-				if (status == EBlockChainStatus::SUCCESS && pTxEntry->poolType == EPoolType::MEMPOOL)
+				// Broacast TransactionKernelMsg
+				const std::vector<TransactionKernel>& kernels = txEntry.pTransaction->GetKernels();
+				for (auto& kernel : kernels)
 				{
-					// Broacast TransactionKernelMsg
-					const std::vector<TransactionKernel>& kernels = pTxEntry->pTransaction->GetKernels();
-					for (auto& kernel : kernels)
-					{
-						const TransactionKernelMessage message(kernel.GetHash());
-						pipeline.m_pConnectionManager->BroadcastMessage(message, pTxEntry->m_connectionId);
-					}
+					const TransactionKernelMessage message(kernel.GetHash());
+					pipeline.m_pConnectionManager->BroadcastMessage(message, txEntry.m_connectionId);
 				}
-				else if (status == EBlockChainStatus::INVALID)
-				{
-					pTxEntry->m_peer->Ban(EBanReason::BadTransaction);
-				}
-
-				pipeline.m_transactionsToProcess.pop_front(1);
 			}
-			else
+			else if (status == EBlockChainStatus::INVALID)
 			{
-				ThreadUtil::SleepFor(std::chrono::milliseconds(5), pipeline.m_terminate);
+				txEntry.m_peer->Ban(EBanReason::BadTransaction);
 			}
 		}
 		catch (std::exception& e)
 		{
 			LOG_ERROR_F("Exception caught: {}", e.what());
 		}
+
+		std::unique_lock<std::mutex> lock(pipeline.m_queuedMutex);
+		pipeline.m_queued.erase(txEntry.pTransaction->GetHash());
 	}
 
 	LOG_TRACE("END");
@@ -73,10 +75,24 @@ void TransactionPipe::Thread_ProcessTransactions(TransactionPipe& pipeline)
 
 bool TransactionPipe::AddTransactionToProcess(const uint64_t connectionId, PeerPtr pPeer, TransactionPtr pTransaction, const EPoolType poolType)
 {
-	std::function<bool(const TxEntry&, const TxEntry&)> comparator = [](const TxEntry& txEntry1, const TxEntry& txEntry2)
+	const Hash& hash = pTransaction->GetHash();
+
+	{
+		std::unique_lock<std::mutex> lock(m_queuedMutex);
+		if (!m_queued.insert(hash).second)
+		{
+			return false;
+		}
+	}
+
+	if (!m_transactionsToProcess.try_push(TxEntry(connectionId, pPeer, pTransaction, poolType)))
 	{
-		return txEntry1.pTransaction->GetHash() == txEntry2.pTransaction->GetHash();
-	};
+		LOG_DEBUG_F("Transaction queue full. Dropping {}", hash);
+
+		std::unique_lock<std::mutex> lock(m_queuedMutex);
+		m_queued.erase(hash);
+		return false;
+	}
 
-	return m_transactionsToProcess.push_back_unique(TxEntry(connectionId, pPeer, pTransaction, poolType), comparator);
+	return true;
 }
\ No newline at end of file
@@ -7,12 +7,13 @@
 #include <TxPool/PoolType.h>
 #include <Core/Models/Transaction.h>
 #include <BlockChain/BlockChainServer.h>
-#include <Common/ConcurrentQueue.h>
+#include <Common/MpscQueue.h>
 #include <string>
 #include <cstdint>
 #include <atomic>
 #include <thread>
-#include <deque>
+#include <unordered_set>
+#include <mutex>
 
 // Forward Declarations
 class Config;
@@ -41,6 +42,7 @@ private:
 	std::thread m_transactionThread;
 	struct TxEntry
 	{
+		TxEntry() = default;
 		TxEntry(const uint64_t connectionId, PeerPtr pPeer, TransactionPtr txn, const EPoolType type)
 			: m_connectionId(connectionId), m_peer(pPeer), pTransaction(txn), poolType(type)
 		{
@@ -53,7 +55,11 @@ private:
 		EPoolType poolType;
 	};
 
-	ConcurrentQueue<TxEntry> m_transactionsToProcess;
+	MpscQueue<TxEntry> m_transactionsToProcess;
+
+	// Hashes of the queued transactions, so duplicates are rejected without scanning the queue.
+	std::mutex m_queuedMutex;
+	std::unordered_set<Hash> m_queued;
 
 	std::atomic_bool m_terminate;
 };
\ No newline at end of file
@@ -46,7 +46,8 @@ std::shared_ptr<Seeder> Seeder::Create(
 	Locked<PeerManager> peerManager,
 	IBlockChainServerPtr pBlockChainServer,
 	std::shared_ptr<Pipeline> pPipeline,
-	SyncStatusConstPtr pSyncStatus)
+	SyncStatusConstPtr pSyncStatus,
+	std::shared_ptr<BlockDownloadScheduler> pBlockScheduler)
 {
 	auto pMessageProcessor = std::make_shared<MessageProcessor>(
 		pContext->GetConfig(),
@@ -54,7 +55,8 @@ std::shared_ptr<Seeder> Seeder::Create(
 		peerManager,
 		pBlockChainServer,
 		pPipeline,
-		pSyncStatus
+		pSyncStatus,
+		pBlockScheduler
 	);
 	std::shared_ptr<Seeder> pSeeder(new Seeder(
 		pContext,
@@ -134,7 +136,12 @@ void Seeder::Thread_Listener(Seeder& seeder)
 			// FUTURE: Always accept, but then send peers and immediately drop
 			if (seeder.m_connectionManager.GetNumberOfActiveConnections() < maximumConnections)
 			{
-				const bool connectionAdded = pSocket->Accept(seeder.m_pAsioContext, acceptor, seeder.m_terminate);
+				const bool connectionAdded = pSocket->Accept(
+					seeder.m_connectionManager.GetIOContext(),
+					*seeder.m_pAsioContext,
+					acceptor,
+					seeder.m_terminate
+				);
 				if (connectionAdded)
 				{
 					auto pPeer = seeder.m_peerManager.Write()->GetPeer(pSocket->GetIPAddress());
@@ -18,6 +18,7 @@
 class Connection;
 class PeerManager;
 class Pipeline;
+class BlockDownloadScheduler;
 
 class Seeder
 {
@@ -28,7 +29,8 @@ public:
 		Locked<PeerManager> peerManager,
 		IBlockChainServerPtr pBlockChainServer,
 		std::shared_ptr<Pipeline> pPipeline,
-		SyncStatusConstPtr pSyncStatus
+		SyncStatusConstPtr pSyncStatus,
+		std::shared_ptr<BlockDownloadScheduler> pBlockScheduler
 	);
 	~Seeder();
 
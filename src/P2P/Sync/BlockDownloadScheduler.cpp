@@ -0,0 +1,377 @@
+#include "BlockDownloadScheduler.h"
+
+#include <Infrastructure/Logger.h>
+#include <algorithm>
+#include <unordered_set>
+
+// Windows start small, and grow by 1 block for each block delivered (slow start) until the first timeout,
+// then by 1 block per window after that (congestion avoidance).
+static const double INITIAL_WINDOW = 4.0;
+static const double MIN_WINDOW = 1.0;
+static const double MAX_WINDOW = 64.0;
+
+// Windows stop growing once the round trip time is this much higher than the lowest seen for the peer,
+// since more blocks in flight would just wait in line behind the peer's bandwidth.
+static const double QUEUEING_FACTOR = 2.0;
+static const double MIN_QUEUEING_DELAY_MS = 250.0;
+
+// Until a peer has delivered a block, its requests use the same flat timeout that every request used to.
+static const std::chrono::seconds DEFAULT_TIMEOUT = std::chrono::seconds(10);
+static const std::chrono::seconds MIN_TIMEOUT = std::chrono::seconds(2);
+static const std::chrono::seconds MAX_TIMEOUT = std::chrono::seconds(30);
+static const double DEFAULT_RTT_MS = 1000.0;
+
+static const std::chrono::seconds DEPRIORITIZE_DURATION = std::chrono::seconds(60);
+
+// The lowest blocks needed hold up the rest of the sync. Once one of them has been waiting this many times longer than
+// another peer is expected to take, it's requested from that peer too.
+static const size_t STALL_WINDOW = 16;
+static const double STALL_FACTOR = 4.0;
+static const std::chrono::seconds MIN_STALL_TIME = std::chrono::seconds(1);
+
+static double ToMilliseconds(const BlockDownloadScheduler::Clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// RFC 6298
+BlockDownloadScheduler::Clock::duration BlockDownloadScheduler::PeerState::GetTimeout() const
+{
+	if (!hasRoundTripTime)
+	{
+		return DEFAULT_TIMEOUT;
+	}
+
+	const auto timeout = std::chrono::milliseconds((int64_t)(smoothedRttMs + (4.0 * rttVarianceMs)));
+	return (std::min)((std::max)(Clock::duration(timeout), Clock::duration(MIN_TIMEOUT)), Clock::duration(MAX_TIMEOUT));
+}
+
+double BlockDownloadScheduler::PeerState::GetExpectedRttMs() const
+{
+	return hasRoundTripTime ? smoothedRttMs : DEFAULT_RTT_MS;
+}
+
+size_t BlockDownloadScheduler::Schedule(
+	const std::vector<std::pair<uint64_t, Hash>>& blocksNeeded,
+	const std::vector<PeerPtr>& peers,
+	const SendRequest& sendRequest,
+	const Clock::time_point now)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	std::vector<PeerState*> candidates;
+	std::unordered_set<IPAddress> connected;
+	for (const PeerPtr& pPeer : peers)
+	{
+		candidates.push_back(&GetPeerState(pPeer));
+		connected.insert(pPeer->GetIPAddress());
+	}
+
+	// Expire requests to peers that disconnected or took too long.
+	for (auto iter = m_requests.begin(); iter != m_requests.end(); )
+	{
+		std::vector<Attempt>& attempts = iter->second.attempts;
+		for (auto attemptIter = attempts.begin(); attemptIter != attempts.end(); )
+		{
+			if (connected.find(attemptIter->ipAddress) != connected.end())
+			{
+				PeerState& peerState = m_peers.at(attemptIter->ipAddress);
+				if (now - attemptIter->requestedAt <= peerState.GetTimeout())
+				{
+					++attemptIter;
+					continue;
+				}
+
+				LOG_DEBUG_F("Request for block {} timed out from {}.", iter->first, peerState.pPeer);
+				OnLate(peerState, now);
+			}
+
+			ReleaseAttempt(*attemptIter);
+			attemptIter = attempts.erase(attemptIter);
+		}
+
+		iter = attempts.empty() ? m_requests.erase(iter) : std::next(iter);
+	}
+
+	size_t numSent = 0;
+
+	// Request stalled blocks at the front of the window from a faster peer.
+	for (size_t i = 0; i < (std::min)(STALL_WINDOW, blocksNeeded.size()); i++)
+	{
+		auto iter = m_requests.find(blocksNeeded[i].first);
+		if (iter == m_requests.end() || iter->second.rerequested || iter->second.attempts.size() != 1)
+		{
+			continue;
+		}
+
+		const Attempt attempt = iter->second.attempts.front();
+		PeerState* pBestPeer = FindBestPeer(candidates, &attempt.ipAddress, now);
+		if (pBestPeer == nullptr || pBestPeer->IsDeprioritized(now))
+		{
+			continue;
+		}
+
+		const auto stallTime = (std::max)(
+			Clock::duration(MIN_STALL_TIME),
+			Clock::duration(std::chrono::milliseconds((int64_t)(STALL_FACTOR * pBestPeer->GetExpectedRttMs())))
+		);
+		if (now - attempt.requestedAt <= stallTime)
+		{
+			continue;
+		}
+
+		if (Request(blocksNeeded[i].first, blocksNeeded[i].second, *pBestPeer, sendRequest, now))
+		{
+			PeerState& slowPeer = m_peers.at(attempt.ipAddress);
+			LOG_DEBUG_F("Block {} stalled on {}. Requesting from {}.", blocksNeeded[i].first, slowPeer.pPeer, pBestPeer->pPeer);
+			slowPeer.deprioritizedUntil = now + DEPRIORITIZE_DURATION;
+			m_requests.at(blocksNeeded[i].first).rerequested = true;
+			++numSent;
+		}
+	}
+
+	// Fill every peer's window, giving each block to the peer expected to deliver it soonest.
+	for (const auto& blockNeeded : blocksNeeded)
+	{
+		if (m_requests.find(blockNeeded.first) != m_requests.end())
+		{
+			continue;
+		}
+
+		PeerState* pBestPeer = FindBestPeer(candidates, nullptr, now);
+		if (pBestPeer == nullptr)
+		{
+			break;
+		}
+
+		if (Request(blockNeeded.first, blockNeeded.second, *pBestPeer, sendRequest, now))
+		{
+			++numSent;
+		}
+		else
+		{
+			candidates.erase(std::find(candidates.begin(), candidates.end(), pBestPeer));
+		}
+	}
+
+	return numSent;
+}
+
+void BlockDownloadScheduler::OnBlockReceived(
+	const IPAddress& ipAddress,
+	const uint64_t height,
+	const Hash& hash,
+	const size_t numBytes,
+	const Clock::time_point now)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = m_requests.find(height);
+	if (iter == m_requests.end() || iter->second.hash != hash)
+	{
+		return;
+	}
+
+	m_averageBlockBytes = m_averageBlockBytes == 0.0 ? numBytes : (0.9 * m_averageBlockBytes) + (0.1 * numBytes);
+
+	for (const Attempt& attempt : iter->second.attempts)
+	{
+		if (!(attempt.ipAddress == ipAddress))
+		{
+			continue;
+		}
+
+		PeerState& peerState = m_peers.at(ipAddress);
+		const double rttMs = ToMilliseconds(now - attempt.requestedAt);
+		if (!peerState.hasRoundTripTime)
+		{
+			peerState.hasRoundTripTime = true;
+			peerState.smoothedRttMs = rttMs;
+			peerState.rttVarianceMs = rttMs / 2.0;
+			peerState.minRttMs = rttMs;
+		}
+		else
+		{
+			peerState.rttVarianceMs = (0.75 * peerState.rttVarianceMs) + (0.25 * std::abs(peerState.smoothedRttMs - rttMs));
+			peerState.smoothedRttMs = (0.875 * peerState.smoothedRttMs) + (0.125 * rttMs);
+			peerState.minRttMs = (std::min)(peerState.minRttMs, rttMs);
+		}
+
+		// While requests are pipelined, the time since the previous delivery is how long this block took to transfer.
+		const auto transferStart = (std::max)(peerState.lastDelivery, attempt.requestedAt);
+		const double transferSeconds = ToMilliseconds(now - transferStart) / 1000.0;
+		if (transferSeconds > 0.0)
+		{
+			const double bytesPerSecond = numBytes / transferSeconds;
+			peerState.bytesPerSecond = peerState.bytesPerSecond == 0.0 ? bytesPerSecond : (0.75 * peerState.bytesPerSecond) + (0.25 * bytesPerSecond);
+		}
+		peerState.lastDelivery = now;
+
+		const bool queueing = peerState.smoothedRttMs > (QUEUEING_FACTOR * peerState.minRttMs)
+			&& (peerState.smoothedRttMs - peerState.minRttMs) > MIN_QUEUEING_DELAY_MS;
+		if (!queueing)
+		{
+			const double increase = peerState.window < peerState.slowStartThreshold ? 1.0 : (1.0 / peerState.window);
+			peerState.window = (std::min)(MAX_WINDOW, peerState.window + increase);
+		}
+	}
+
+	for (const Attempt& attempt : iter->second.attempts)
+	{
+		ReleaseAttempt(attempt);
+	}
+
+	m_requests.erase(iter);
+}
+
+void BlockDownloadScheduler::OnChainHeight(const uint64_t height)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto end = m_requests.upper_bound(height);
+	for (auto iter = m_requests.begin(); iter != end; iter++)
+	{
+		for (const Attempt& attempt : iter->second.attempts)
+		{
+			ReleaseAttempt(attempt);
+		}
+	}
+
+	m_requests.erase(m_requests.begin(), end);
+}
+
+size_t BlockDownloadScheduler::GetNumInFlight() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_requests.size();
+}
+
+bool BlockDownloadScheduler::GetPeerStats(const IPAddress& ipAddress, PeerStats& stats, const Clock::time_point now) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = m_peers.find(ipAddress);
+	if (iter == m_peers.end())
+	{
+		return false;
+	}
+
+	const PeerState& peerState = iter->second;
+	stats.window = peerState.window;
+	stats.inFlight = peerState.inFlight;
+	stats.roundTripTime = std::chrono::milliseconds((int64_t)peerState.GetExpectedRttMs());
+	stats.timeout = std::chrono::duration_cast<std::chrono::milliseconds>(peerState.GetTimeout());
+	stats.bytesPerSecond = peerState.bytesPerSecond;
+	stats.deprioritized = peerState.IsDeprioritized(now);
+	return true;
+}
+
+BlockDownloadScheduler::PeerState& BlockDownloadScheduler::GetPeerState(const PeerPtr& pPeer)
+{
+	auto iter = m_peers.find(pPeer->GetIPAddress());
+	if (iter != m_peers.end())
+	{
+		iter->second.pPeer = pPeer;
+		return iter->second;
+	}
+
+	PeerState peerState;
+	peerState.pPeer = pPeer;
+	peerState.window = INITIAL_WINDOW;
+	peerState.slowStartThreshold = MAX_WINDOW;
+	peerState.inFlight = 0;
+	peerState.hasRoundTripTime = false;
+	peerState.smoothedRttMs = 0.0;
+	peerState.rttVarianceMs = 0.0;
+	peerState.minRttMs = 0.0;
+	peerState.bytesPerSecond = 0.0;
+	return m_peers.emplace(pPeer->GetIPAddress(), std::move(peerState)).first->second;
+}
+
+void BlockDownloadScheduler::ReleaseAttempt(const Attempt& attempt)
+{
+	auto iter = m_peers.find(attempt.ipAddress);
+	if (iter != m_peers.end() && iter->second.inFlight > 0)
+	{
+		--iter->second.inFlight;
+	}
+}
+
+//
+// Halves the window at most once per timeout period, so a burst of timeouts from one slow round trip only counts once.
+//
+void BlockDownloadScheduler::OnLate(PeerState& peerState, const Clock::time_point now)
+{
+	if (now - peerState.lastDecrease >= peerState.GetTimeout())
+	{
+		peerState.slowStartThreshold = (std::max)(MIN_WINDOW, peerState.window / 2.0);
+		peerState.window = peerState.slowStartThreshold;
+		peerState.lastDecrease = now;
+	}
+
+	peerState.deprioritizedUntil = now + DEPRIORITIZE_DURATION;
+}
+
+//
+// Returns the peer with room in its window that should deliver one more block soonest.
+// Deprioritized peers are only used when every other peer's window is full.
+//
+BlockDownloadScheduler::PeerState* BlockDownloadScheduler::FindBestPeer(
+	const std::vector<PeerState*>& candidates,
+	const IPAddress* pExclude,
+	const Clock::time_point now) const
+{
+	PeerState* pBestPeer = nullptr;
+	bool bestDeprioritized = true;
+	double bestDeliveryMs = 0.0;
+
+	for (PeerState* pPeerState : candidates)
+	{
+		if (!pPeerState->HasFreeSlot() || (pExclude != nullptr && pPeerState->pPeer->GetIPAddress() == *pExclude))
+		{
+			continue;
+		}
+
+		// Latency plus the time to transfer everything queued ahead of the block.
+		// Until a transfer rate has been measured, the window's worth of blocks per round trip is used instead.
+		const double queued = (double)(pPeerState->inFlight + 1);
+		const double deliveryMs = pPeerState->bytesPerSecond > 0.0 && pPeerState->lastDelivery != Clock::time_point()
+			? pPeerState->minRttMs + (queued * 1000.0 * m_averageBlockBytes / pPeerState->bytesPerSecond)
+			: pPeerState->GetExpectedRttMs() * queued / pPeerState->window;
+
+		const bool deprioritized = pPeerState->IsDeprioritized(now);
+		if (pBestPeer == nullptr
+			|| (bestDeprioritized && !deprioritized)
+			|| (bestDeprioritized == deprioritized && deliveryMs < bestDeliveryMs))
+		{
+			pBestPeer = pPeerState;
+			bestDeprioritized = deprioritized;
+			bestDeliveryMs = deliveryMs;
+		}
+	}
+
+	return pBestPeer;
+}
+
+bool BlockDownloadScheduler::Request(
+	const uint64_t height,
+	const Hash& hash,
+	PeerState& peerState,
+	const SendRequest& sendRequest,
+	const Clock::time_point now)
+{
+	if (!sendRequest(peerState.pPeer, hash))
+	{
+		return false;
+	}
+
+	auto iter = m_requests.find(height);
+	if (iter == m_requests.end())
+	{
+		iter = m_requests.emplace(height, BlockRequest{ hash, {}, false }).first;
+	}
+
+	iter->second.attempts.push_back(Attempt{ peerState.pPeer->GetIPAddress(), now });
+	++peerState.inFlight;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <P2P/Peer.h>
+#include <Net/IPAddress.h>
+#include <Crypto/Hash.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//
+// Decides which peers to request blocks from during block sync.
+//
+// Each peer gets its own window of blocks in flight, sized much like a TCP congestion window:
+// it grows while the peer delivers on time, stops growing once the peer's round trip time shows requests are queueing up
+// behind its bandwidth, and is halved when a request times out. Timeouts come from each peer's measured round trip time,
+// and blocks go to whichever peer is expected to deliver them soonest.
+//
+// Late peers are deprioritized for a while instead of banned. Blocks at the front of the download window that are stuck
+// on a slow peer are requested again from another peer, without waiting for the slow peer to time out.
+//
+// Thread-safe. Schedule is called by the sync thread, and OnBlockReceived by the connections.
+//
+class BlockDownloadScheduler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using SendRequest = std::function<bool(const PeerPtr&, const Hash&)>;
+
+	struct PeerStats
+	{
+		double window;
+		size_t inFlight;
+		std::chrono::milliseconds roundTripTime;
+		std::chrono::milliseconds timeout;
+		double bytesPerSecond;
+		bool deprioritized;
+	};
+
+	//
+	// Expires late requests, re-requests stalled blocks, and then requests blocks from blocksNeeded
+	// (ordered by height) that aren't already in flight until every peer's window is full.
+	// sendRequest should return false if the request couldn't be sent.
+	// Returns the number of requests sent.
+	//
+	size_t Schedule(
+		const std::vector<std::pair<uint64_t, Hash>>& blocksNeeded,
+		const std::vector<PeerPtr>& peers,
+		const SendRequest& sendRequest,
+		const Clock::time_point now = Clock::now()
+	);
+
+	//
+	// Records delivery of a block. Blocks that weren't requested, including blocks at a requested height that don't
+	// match the requested hash (ie. from a fork), are ignored.
+	//
+	void OnBlockReceived(
+		const IPAddress& ipAddress,
+		const uint64_t height,
+		const Hash& hash,
+		const size_t numBytes,
+		const Clock::time_point now = Clock::now()
+	);
+
+	//
+	// Forgets requests for blocks that are already part of the chain, without penalizing the peers they were sent to.
+	//
+	void OnChainHeight(const uint64_t height);
+
+	size_t GetNumInFlight() const;
+	bool GetPeerStats(const IPAddress& ipAddress, PeerStats& stats, const Clock::time_point now = Clock::now()) const;
+
+private:
+	struct PeerState
+	{
+		PeerPtr pPeer;
+		double window;
+		double slowStartThreshold;
+		size_t inFlight;
+
+		bool hasRoundTripTime;
+		double smoothedRttMs;
+		double rttVarianceMs;
+		double minRttMs;
+
+		double bytesPerSecond;
+		Clock::time_point lastDelivery;
+		Clock::time_point lastDecrease;
+		Clock::time_point deprioritizedUntil;
+
+		Clock::duration GetTimeout() const;
+		double GetExpectedRttMs() const;
+		bool HasFreeSlot() const { return inFlight < (size_t)window; }
+		bool IsDeprioritized(const Clock::time_point now) const { return deprioritizedUntil > now; }
+	};
+
+	struct Attempt
+	{
+		IPAddress ipAddress;
+		Clock::time_point requestedAt;
+	};
+
+	struct BlockRequest
+	{
+		Hash hash;
+		std::vector<Attempt> attempts;
+		bool rerequested;
+	};
+
+	PeerState& GetPeerState(const PeerPtr& pPeer);
+	void ReleaseAttempt(const Attempt& attempt);
+	void OnLate(PeerState& peerState, const Clock::time_point now);
+	PeerState* FindBestPeer(
+		const std::vector<PeerState*>& candidates,
+		const IPAddress* pExclude,
+		const Clock::time_point now
+	) const;
+	bool Request(
+		const uint64_t height,
+		const Hash& hash,
+		PeerState& peerState,
+		const SendRequest& sendRequest,
+		const Clock::time_point now
+	);
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<IPAddress, PeerState> m_peers;
+	std::map<uint64_t, BlockRequest> m_requests;
+	double m_averageBlockBytes = 0.0;
+};
\ No newline at end of file
@@ -1,13 +1,12 @@
 #pragma once
 
+#include "BlockDownloadScheduler.h"
 #include "../ConnectionManager.h"
 #include "../Pipeline/Pipeline.h"
 
 #include <BlockChain/BlockChainServer.h>
 #include <chrono>
-#include <deque>
-#include <unordered_set>
-#include <unordered_map>
+#include <memory>
 #include <stdint.h>
 
 // Forward Declarations
@@ -19,31 +18,19 @@ public:
 	BlockSyncer(
 		std::weak_ptr<ConnectionManager> pConnectionManager,
 		IBlockChainServerPtr pBlockChainServer,
-		std::shared_ptr<Pipeline> pPipeline
+		std::shared_ptr<Pipeline> pPipeline,
+		std::shared_ptr<BlockDownloadScheduler> pScheduler
 	);
 
 	bool SyncBlocks(const SyncStatus& syncStatus, const bool startup);
 
 private:
-	bool IsBlockSyncDue(const SyncStatus& syncStatus);
 	bool RequestBlocks();
-	bool IsSlowPeer(PeerConstPtr pPeer) const { return m_slowPeers.find(pPeer->GetIPAddress()) != m_slowPeers.end(); }
 
 	std::weak_ptr<ConnectionManager> m_pConnectionManager;
 	IBlockChainServerPtr m_pBlockChainServer;
 	std::shared_ptr<Pipeline> m_pPipeline;
+	std::shared_ptr<BlockDownloadScheduler> m_pScheduler;
 
-	std::chrono::time_point<std::chrono::system_clock> m_timeout;
-	uint64_t m_lastHeight;
-	uint64_t m_highestRequested;
-
-	struct RequestedBlock
-	{
-		PeerPtr PEER;
-		uint64_t BLOCK_HEIGHT;
-		std::chrono::time_point<std::chrono::system_clock> TIMEOUT;
-		// TODO: Add retry?
-	};
-	std::unordered_map<uint64_t, RequestedBlock> m_requestedBlocks;
-	std::unordered_set<IPAddress> m_slowPeers;
+	std::chrono::steady_clock::time_point m_nextRequest;
 };
\ No newline at end of file
@@ -5,12 +5,13 @@
 #include <BlockChain/BlockChainServer.h>
 #include <Infrastructure/Logger.h>
 
-HeaderSyncer::HeaderSyncer(std::weak_ptr<ConnectionManager> pConnectionManager, IBlockChainServerPtr pBlockChainServer)
-	: m_pConnectionManager(pConnectionManager), m_pBlockChainServer(pBlockChainServer)
+HeaderSyncer::HeaderSyncer(std::weak_ptr<ConnectionManager> pConnectionManager, IBlockChainServerPtr pBlockChainServer, std::shared_ptr<HeaderPipe> pHeaderPipe)
+	: m_pConnectionManager(pConnectionManager), m_pBlockChainServer(pBlockChainServer), m_pHeaderPipe(pHeaderPipe)
 {
 	m_timeout = std::chrono::system_clock::now();
-	m_lastHeight = 0;
+	m_pRequestedTip = nullptr;
 	m_pPeer = nullptr;
+	m_nextPeer = 0;
 	m_retried = false;
 }
 
@@ -27,7 +28,15 @@ bool HeaderSyncer::SyncHeaders(const SyncStatus& syncStatus, const bool startup)
 
 	if (networkHeight >= (chainHeight + 5) || (startup && networkHeight > chainHeight))
 	{
-		if (IsHeaderSyncDue(syncStatus))
+		// Everything has been downloaded, and is just waiting to be validated.
+		BlockHeaderPtr pQueuedTip = m_pHeaderPipe->GetDownloadTip();
+		if (pQueuedTip != nullptr && pQueuedTip->GetHeight() >= networkHeight)
+		{
+			m_timeout = std::chrono::system_clock::now() + std::chrono::seconds(12);
+			return true;
+		}
+
+		if (IsHeaderSyncDue())
 		{
 			RequestHeaders(syncStatus);
 		}
@@ -41,18 +50,24 @@ bool HeaderSyncer::SyncHeaders(const SyncStatus& syncStatus, const bool startup)
 	return false;
 }
 
-bool HeaderSyncer::IsHeaderSyncDue(const SyncStatus& syncStatus)
+bool HeaderSyncer::IsHeaderSyncDue()
 {
 	if (m_pPeer == nullptr)
 	{
 		return true;
 	}
 
-	const uint64_t height = syncStatus.GetHeaderHeight();
-
-	// Check if headers were received, and we're ready to request next batch.
-	if (height >= (m_lastHeight + P2P::MAX_BLOCK_HEADERS - 1))
+	// The next batch is requested as soon as the previous one is received, rather than after it's validated.
+	BlockHeaderPtr pDownloadTip = GetDownloadTip();
+	if (pDownloadTip != nullptr && (m_pRequestedTip == nullptr || pDownloadTip->GetHash() != m_pRequestedTip->GetHash()))
 	{
+		if (m_pHeaderPipe->IsFull())
+		{
+			// Wait for the queued batches to be validated. This is not the peer's fault, so don't let it time out.
+			m_timeout = std::chrono::system_clock::now() + std::chrono::seconds(12);
+			return false;
+		}
+
 		LOG_TRACE("Headers received. Requesting next batch.");
 		m_retried = false;
 		return true;
@@ -95,27 +110,56 @@ bool HeaderSyncer::RequestHeaders(const SyncStatus& syncStatus)
 {
 	LOG_TRACE("Requesting headers.");
 
+	// Headers that are queued but not yet validated are used as the first locator, so peers send the batch after them.
+	BlockHeaderPtr pDownloadTip = GetDownloadTip();
 	std::vector<Hash> locators = BlockLocator(m_pBlockChainServer).GetLocators(syncStatus);
+	if (pDownloadTip != nullptr && (locators.empty() || locators.front() != pDownloadTip->GetHash()))
+	{
+		locators.insert(locators.begin(), pDownloadTip->GetHash());
+	}
 
 	const GetHeadersMessage getHeadersMessage(std::move(locators));
 
+	// Retries go to the same peer, so it can be banned if it still doesn't respond.
+	// Otherwise, requests rotate across the most-work peers.
+	auto pConnectionManager = m_pConnectionManager.lock();
+	if (!m_retried)
+	{
+		const std::vector<PeerPtr> mostWorkPeers = pConnectionManager->GetMostWorkPeers();
+		if (!mostWorkPeers.empty())
+		{
+			m_pPeer = mostWorkPeers[m_nextPeer++ % mostWorkPeers.size()];
+		}
+	}
+
 	bool messageSent = false;
 	if (m_pPeer != nullptr)
 	{
-		messageSent = m_pConnectionManager.lock()->SendMessageToPeer(getHeadersMessage, m_pPeer);
+		messageSent = pConnectionManager->SendMessageToPeer(getHeadersMessage, m_pPeer);
 	}
 	
 	if (!messageSent)
 	{
-		m_pPeer = m_pConnectionManager.lock()->SendMessageToMostWorkPeer(getHeadersMessage);
+		m_pPeer = pConnectionManager->SendMessageToMostWorkPeer(getHeadersMessage);
 	}
 
 	if (m_pPeer != nullptr)
 	{
 		LOG_TRACE("Headers requested.");
 		m_timeout = std::chrono::system_clock::now() + std::chrono::seconds(12);
-		m_lastHeight = syncStatus.GetHeaderHeight();
+		m_pRequestedTip = pDownloadTip;
 	}
 
 	return m_pPeer != nullptr;
+}
+
+BlockHeaderPtr HeaderSyncer::GetDownloadTip() const
+{
+	BlockHeaderPtr pDownloadTip = m_pHeaderPipe->GetDownloadTip();
+	if (pDownloadTip == nullptr)
+	{
+		pDownloadTip = m_pBlockChainServer->GetTipBlockHeader(EChainType::SYNC);
+	}
+
+	return pDownloadTip;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../ConnectionManager.h"
+#include "../Pipeline/HeaderPipe.h"
 
 #include <BlockChain/BlockChainServer.h>
 #include <chrono>
@@ -11,19 +12,22 @@ class SyncStatus;
 class HeaderSyncer
 {
 public:
-	HeaderSyncer(std::weak_ptr<ConnectionManager> pConnectionManager, IBlockChainServerPtr pBlockChainServer);
+	HeaderSyncer(std::weak_ptr<ConnectionManager> pConnectionManager, IBlockChainServerPtr pBlockChainServer, std::shared_ptr<HeaderPipe> pHeaderPipe);
 
 	bool SyncHeaders(const SyncStatus& syncStatus, const bool startup);
 
 private:
-	bool IsHeaderSyncDue(const SyncStatus& syncStatus);
+	bool IsHeaderSyncDue();
 	bool RequestHeaders(const SyncStatus& syncStatus);
+	BlockHeaderPtr GetDownloadTip() const;
 
 	std::weak_ptr<ConnectionManager> m_pConnectionManager;
 	IBlockChainServerPtr m_pBlockChainServer;
+	std::shared_ptr<HeaderPipe> m_pHeaderPipe;
 
 	std::chrono::time_point<std::chrono::system_clock> m_timeout;
-	uint64_t m_lastHeight;
+	BlockHeaderPtr m_pRequestedTip;
 	PeerPtr m_pPeer;
+	size_t m_nextPeer;
 	bool m_retried;
 };
\ No newline at end of file
@@ -15,11 +15,13 @@ Syncer::Syncer(
 	std::weak_ptr<ConnectionManager> pConnectionManager,
 	IBlockChainServerPtr pBlockChainServer,
 	std::shared_ptr<Pipeline> pPipeline,
-	SyncStatusPtr pSyncStatus)
+	SyncStatusPtr pSyncStatus,
+	std::shared_ptr<BlockDownloadScheduler> pBlockScheduler)
 	: m_pConnectionManager(pConnectionManager),
 	m_pBlockChainServer(pBlockChainServer),
 	m_pPipeline(pPipeline),
 	m_pSyncStatus(pSyncStatus),
+	m_pBlockScheduler(pBlockScheduler),
 	m_terminate(false)
 {
 
@@ -35,13 +37,15 @@ std::shared_ptr<Syncer> Syncer::Create(
 	std::weak_ptr<ConnectionManager> pConnectionManager,
 	IBlockChainServerPtr pBlockChainServer,
 	std::shared_ptr<Pipeline> pPipeline,
-	SyncStatusPtr pSyncStatus)
+	SyncStatusPtr pSyncStatus,
+	std::shared_ptr<BlockDownloadScheduler> pBlockScheduler)
 {
 	std::shared_ptr<Syncer> pSyncer = std::shared_ptr<Syncer>(new Syncer(
 		pConnectionManager,
 		pBlockChainServer,
 		pPipeline,
-		pSyncStatus
+		pSyncStatus,
+		pBlockScheduler
 	));
 	pSyncer->m_syncThread = std::thread(Thread_Sync, std::ref(*pSyncer));
 
@@ -53,9 +57,9 @@ void Syncer::Thread_Sync(Syncer& syncer)
 	ThreadManagerAPI::SetCurrentThreadName("SYNC");
 	LOG_DEBUG("BEGIN");
 
-	HeaderSyncer headerSyncer(syncer.m_pConnectionManager, syncer.m_pBlockChainServer);
+	HeaderSyncer headerSyncer(syncer.m_pConnectionManager, syncer.m_pBlockChainServer, syncer.m_pPipeline->GetHeaderPipe());
 	StateSyncer stateSyncer(syncer.m_pConnectionManager, syncer.m_pBlockChainServer);
-	BlockSyncer blockSyncer(syncer.m_pConnectionManager, syncer.m_pBlockChainServer, syncer.m_pPipeline);
+	BlockSyncer blockSyncer(syncer.m_pConnectionManager, syncer.m_pBlockChainServer, syncer.m_pPipeline, syncer.m_pBlockScheduler);
 	bool startup = true;
 
 	while (!syncer.m_terminate)
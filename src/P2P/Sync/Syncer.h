@@ -2,6 +2,7 @@
 
 #include "../ConnectionManager.h"
 #include "../Pipeline/Pipeline.h"
+#include "BlockDownloadScheduler.h"
 
 #include <P2P/SyncStatus.h>
 #include <BlockChain/BlockChainServer.h>
@@ -18,7 +19,8 @@ public:
 		std::weak_ptr<ConnectionManager> pConnectionManager,
 		IBlockChainServerPtr pBlockChainServer,
 		std::shared_ptr<Pipeline> pPipeline,
-		SyncStatusPtr pSyncStatus
+		SyncStatusPtr pSyncStatus,
+		std::shared_ptr<BlockDownloadScheduler> pBlockScheduler
 	);
 	~Syncer();
 
@@ -27,7 +29,8 @@ private:
 		std::weak_ptr<ConnectionManager> pConnectionManager,
 		IBlockChainServerPtr pBlockChainServer,
 		std::shared_ptr<Pipeline> pPipeline,
-		SyncStatusPtr pSyncStatus
+		SyncStatusPtr pSyncStatus,
+		std::shared_ptr<BlockDownloadScheduler> pBlockScheduler
 	);
 
 	static void Thread_Sync(Syncer& syncer);
@@ -37,6 +40,7 @@ private:
 	IBlockChainServerPtr m_pBlockChainServer;
 	std::shared_ptr<Pipeline> m_pPipeline;
 	SyncStatusPtr m_pSyncStatus;
+	std::shared_ptr<BlockDownloadScheduler> m_pBlockScheduler;
 
 	std::atomic<bool> m_terminate;
 	std::thread m_syncThread;
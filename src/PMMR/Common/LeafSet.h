@@ -29,13 +29,37 @@ public:
 	void Remove(const uint64_t leafIndex) { m_pBitmap->Unset(leafIndex); }
 	bool Contains(const uint64_t leafIndex) const { return m_pBitmap->IsSet(leafIndex); }
 
+	// Number of unspent leaves below leafIndex.
+	uint64_t Rank(const uint64_t leafIndex) const { return m_pBitmap->Rank(leafIndex); }
+
+	// Leaf index of the (rank + 1)th unspent leaf, or UINT64_MAX if there aren't that many.
+	uint64_t Select(const uint64_t rank) const { return m_pBitmap->Select(rank); }
+
+	// Up to maxLeaves unspent leaves in [startIndex, endIndex).
+	std::vector<uint64_t> GetUnspentLeaves(const uint64_t startIndex, const uint64_t endIndex, const uint64_t maxLeaves) const
+	{
+		return m_pBitmap->GetSetLeaves(startIndex, endIndex, maxLeaves);
+	}
+
 	void Rewind(const uint64_t numLeaves, const std::vector<uint64_t>& leavesToAdd) { m_pBitmap->Rewind(numLeaves, leavesToAdd); }
+	void Journal(CommitJournal& journal) const { m_pBitmap->Journal(journal); }
 	void Commit() { m_pBitmap->Commit(); }
 	void Rollback() noexcept { m_pBitmap->Rollback(); }
-	void Snapshot(const Hash& blockHash)
+
+	//
+	// Writes the leafset, as it was when the MMR contained numLeaves leaves, to a Roaring bitmap file.
+	// The leaves spent since then are passed in as leavesToAdd, so the bitmap is never copied or rewound.
+	//
+	void Snapshot(const fs::path& path, const uint64_t numLeaves, const std::vector<uint64_t>& leavesToAdd) const
 	{
-		std::string path = m_path.u8string() + "." + HASH::ShortHash(blockHash);
-		Roaring snapshotBitmap = m_pBitmap->ToRoaring();
+		Roaring snapshotBitmap = m_pBitmap->ToRoaring(numLeaves);
+		for (const uint64_t leafIndex : leavesToAdd)
+		{
+			if (leafIndex < numLeaves)
+			{
+				snapshotBitmap.add((uint32_t)(MMRUtil::GetPMMRIndex(leafIndex) + 1));
+			}
+		}
 
 		const size_t numBytes = snapshotBitmap.getSizeInBytes();
 		std::vector<unsigned char> bytes(numBytes);
@@ -45,7 +69,7 @@ public:
 			throw std::exception(); // TODO: Handle this.
 		}
 
-		FileUtil::SafeWriteToFile(FileUtil::ToPath(path), bytes);
+		FileUtil::SafeWriteToFile(path, bytes);
 	}
 
 	Hash Root(const uint64_t numOutputs) const
@@ -55,19 +79,20 @@ public:
 		pHashFile->Rewind(0);
 
 		size_t index = 0;
-		std::vector<uint8_t> bytes(128);
 		const uint64_t numChunks = (numOutputs + 1023) / 1024;
+		std::vector<std::vector<unsigned char>> chunks(numChunks, std::vector<unsigned char>(128));
 		for (size_t i = 0; i < numChunks; i++)
 		{
 			for (size_t j = 0; j < 128; j++)
 			{
-				bytes[j] = m_pBitmap->GetByte(index++);
+				chunks[i][j] = m_pBitmap->GetByte(index++);
 			}
-
-			MMRHashUtil::AddHashes(pHashFile, bytes, nullptr);
 		}
 
-		return MMRHashUtil::Root(pHashFile, pHashFile->GetSize(), nullptr);
+		PeakCache peakCache;
+		MMRHashUtil::AddHashes(pHashFile, chunks, nullptr, peakCache);
+
+		return MMRHashUtil::Root(pHashFile, pHashFile->GetSize(), nullptr, peakCache);
 	}
 
 private:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Crypto/Hash.h>
+#include <Core/File/CommitJournal.h>
 #include <stdint.h>
 #include <memory>
 
@@ -30,6 +31,11 @@ public:
 	//
 	virtual std::vector<Hash> GetLastLeafHashes(const uint64_t numHashes) const = 0;
 
+	//
+	// Records the file writes the next Commit() will perform.
+	//
+	virtual void Journal(CommitJournal& journal) const = 0;
+
 	//
 	// Flushes all working changes to disk.
 	//
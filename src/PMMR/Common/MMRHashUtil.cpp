@@ -3,7 +3,14 @@
 #include "LeafSet.h"
 
 #include <Crypto/Crypto.h>
-#include <Core/Serialization/Serializer.h>
+#include <Crypto/Blake2bHasher.h>
+#include <Core/Exceptions/TxHashSetException.h>
+#include <Common/Util/StringUtil.h>
+#include <Common/WorkStealingPool.h>
+#include <algorithm>
+
+// Hashes are only worth spreading across threads in ranges of at least this many nodes.
+static constexpr size_t MIN_HASHES_PER_CHUNK = 64;
 
 void MMRHashUtil::AddHashes(
 	std::shared_ptr<HashFile> pHashFile,
@@ -70,6 +77,255 @@ Hash MMRHashUtil::Root(
 	return hash;
 }
 
+void MMRHashUtil::AddHashes(
+	std::shared_ptr<HashFile> pHashFile,
+	const std::vector<unsigned char>& serializedLeaf,
+	std::shared_ptr<const PruneList> pPruneList,
+	PeakCache& peakCache)
+{
+	// Calculate next position
+	uint64_t position = pHashFile->GetSize();
+	if (pPruneList != nullptr)
+	{
+		position += pPruneList->GetTotalShift();
+	}
+
+	if (!peakCache.IsValid() || peakCache.GetSize() != position)
+	{
+		LoadPeaks(pHashFile, position, pPruneList, peakCache);
+		if (!peakCache.IsValid())
+		{
+			AddHashes(pHashFile, serializedLeaf, pPruneList);
+			return;
+		}
+	}
+
+	// Add in the new leaf hash
+	const Hash leafHash = HashLeafWithIndex(serializedLeaf, position);
+	pHashFile->AddData(leafHash);
+	peakCache.Push(position, leafHash);
+
+	// Add parent hashes. The left sibling of each new node is always the previous peak.
+	while (MMRUtil::GetHeight(position + 1) > 0)
+	{
+		const std::pair<uint64_t, Hash> right = peakCache.Pop();
+		const std::pair<uint64_t, Hash> left = peakCache.Pop();
+
+		++position;
+
+		const Hash parentHash = HashParentWithIndex(left.second, right.second, position);
+		pHashFile->AddData(parentHash);
+		peakCache.Push(position, parentHash);
+	}
+}
+
+void MMRHashUtil::AddHashes(
+	std::shared_ptr<HashFile> pHashFile,
+	const std::vector<std::vector<unsigned char>>& serializedLeaves,
+	std::shared_ptr<const PruneList> pPruneList,
+	PeakCache& peakCache)
+{
+	if (serializedLeaves.empty())
+	{
+		return;
+	}
+
+	// Calculate first position
+	uint64_t firstPosition = pHashFile->GetSize();
+	if (pPruneList != nullptr)
+	{
+		firstPosition += pPruneList->GetTotalShift();
+	}
+
+	if (!peakCache.IsValid() || peakCache.GetSize() != firstPosition)
+	{
+		LoadPeaks(pHashFile, firstPosition, pPruneList, peakCache);
+		if (!peakCache.IsValid())
+		{
+			for (const std::vector<unsigned char>& serializedLeaf : serializedLeaves)
+			{
+				AddHashes(pHashFile, serializedLeaf, pPruneList);
+			}
+
+			return;
+		}
+	}
+
+	// Determine the position of every new node, grouped by height.
+	std::vector<std::vector<uint64_t>> levels(1);
+	levels[0].reserve(serializedLeaves.size());
+
+	uint64_t nextPosition = firstPosition;
+	for (size_t i = 0; i < serializedLeaves.size(); i++)
+	{
+		levels[0].push_back(nextPosition++);
+
+		uint64_t height = MMRUtil::GetHeight(nextPosition);
+		while (height > 0)
+		{
+			if (levels.size() <= height)
+			{
+				levels.resize(height + 1);
+			}
+
+			levels[height].push_back(nextPosition++);
+			height = MMRUtil::GetHeight(nextPosition);
+		}
+	}
+
+	// New hashes are written directly to the buffer that gets appended to the hash file.
+	// Children below firstPosition are always peaks of the MMR before the batch.
+	std::vector<unsigned char> bytes((nextPosition - firstPosition) * 32);
+	auto getHash = [&bytes, &peakCache, firstPosition](const uint64_t position) -> const unsigned char* {
+		if (position >= firstPosition)
+		{
+			return bytes.data() + ((position - firstPosition) * 32);
+		}
+
+		const Hash* pPeakHash = peakCache.Find(position);
+		if (pPeakHash == nullptr)
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Peak not found at mmr index {}", position));
+		}
+
+		return pPeakHash->data();
+	};
+
+	// Each range is hashed several messages at a time (see Crypto::Blake2bMulti).
+	// The messages for a range are serialized into a single buffer, so nothing is allocated per node.
+	WorkStealingPool::GetShared().ParallelFor(levels[0].size(), MIN_HASHES_PER_CHUNK, [&levels, &bytes, &serializedLeaves, firstPosition](const size_t begin, const size_t end) {
+		size_t totalLength = 0;
+		for (size_t i = begin; i < end; i++)
+		{
+			totalLength += 8 + serializedLeaves[i].size();
+		}
+
+		std::vector<unsigned char> messages(totalLength);
+		std::vector<const unsigned char*> pMessages(end - begin);
+		std::vector<size_t> messageLengths(end - begin);
+		std::vector<unsigned char*> pOutputs(end - begin);
+
+		unsigned char* pMessage = messages.data();
+		for (size_t i = begin; i < end; i++)
+		{
+			const std::vector<unsigned char>& serializedLeaf = serializedLeaves[i];
+			WriteU64(pMessage, levels[0][i]);
+			std::copy(serializedLeaf.cbegin(), serializedLeaf.cend(), pMessage + 8);
+
+			pMessages[i - begin] = pMessage;
+			messageLengths[i - begin] = 8 + serializedLeaf.size();
+			pOutputs[i - begin] = bytes.data() + ((levels[0][i] - firstPosition) * 32);
+			pMessage += 8 + serializedLeaf.size();
+		}
+
+		Crypto::Blake2bMulti(pMessages.data(), messageLengths.data(), pOutputs.data(), end - begin);
+	});
+
+	for (size_t height = 1; height < levels.size(); height++)
+	{
+		const std::vector<uint64_t>& level = levels[height];
+		WorkStealingPool::GetShared().ParallelFor(level.size(), MIN_HASHES_PER_CHUNK, [&level, &bytes, &getHash, height, firstPosition](const size_t begin, const size_t end) {
+			std::vector<unsigned char> messages((end - begin) * PARENT_MESSAGE_SIZE);
+			std::vector<const unsigned char*> pMessages(end - begin);
+			std::vector<size_t> messageLengths(end - begin, PARENT_MESSAGE_SIZE);
+			std::vector<unsigned char*> pOutputs(end - begin);
+
+			for (size_t i = begin; i < end; i++)
+			{
+				const uint64_t position = level[i];
+				unsigned char* pMessage = messages.data() + ((i - begin) * PARENT_MESSAGE_SIZE);
+				WriteParentMessage(pMessage, getHash(position - ((uint64_t)1 << height)), getHash(position - 1), position);
+
+				pMessages[i - begin] = pMessage;
+				pOutputs[i - begin] = bytes.data() + ((position - firstPosition) * 32);
+			}
+
+			Crypto::Blake2bMulti(pMessages.data(), messageLengths.data(), pOutputs.data(), end - begin);
+		});
+	}
+
+	pHashFile->AddData(bytes);
+
+	// Update the peaks
+	std::array<uint64_t, 64> peakIndices;
+	const size_t numPeaks = MMRUtil::GetPeakIndices(nextPosition, peakIndices);
+
+	std::vector<std::pair<uint64_t, Hash>> peaks;
+	peaks.reserve(numPeaks);
+	for (size_t i = 0; i < numPeaks; i++)
+	{
+		peaks.emplace_back(peakIndices[i], Hash(getHash(peakIndices[i])));
+	}
+
+	peakCache.Load(nextPosition, std::move(peaks));
+}
+
+Hash MMRHashUtil::Root(
+	std::shared_ptr<const HashFile> pHashFile,
+	const uint64_t size,
+	std::shared_ptr<const PruneList> pPruneList,
+	const PeakCache& peakCache)
+{
+	if (size == 0)
+	{
+		return ZERO_HASH;
+	}
+
+	if (!peakCache.IsValid() || size > peakCache.GetSize())
+	{
+		return Root(pHashFile, size, pPruneList);
+	}
+
+	// Peaks of an earlier size that are also peaks of the cached size are taken from the cache.
+	std::array<uint64_t, 64> peakIndices;
+	const size_t numPeaks = MMRUtil::GetPeakIndices(size, peakIndices);
+
+	Hash hash = ZERO_HASH;
+	for (size_t i = numPeaks; i > 0; i--)
+	{
+		const uint64_t peakIndex = peakIndices[i - 1];
+		const Hash* pCachedHash = peakCache.Find(peakIndex);
+		const Hash peakHash = pCachedHash != nullptr ? *pCachedHash : pHashFile->GetDataAt(GetShiftedIndex(peakIndex, pPruneList));
+		if (peakHash != ZERO_HASH)
+		{
+			if (hash == ZERO_HASH)
+			{
+				hash = peakHash;
+			}
+			else
+			{
+				hash = HashParentWithIndex(peakHash, hash, size);
+			}
+		}
+	}
+
+	return hash;
+}
+
+void MMRHashUtil::LoadPeaks(
+	std::shared_ptr<const HashFile> pHashFile,
+	const uint64_t size,
+	std::shared_ptr<const PruneList> pPruneList,
+	PeakCache& peakCache)
+{
+	std::array<uint64_t, 64> peakIndices;
+	const size_t numPeaks = MMRUtil::GetPeakIndices(size, peakIndices);
+	if (numPeaks == 0 && size > 0)
+	{
+		peakCache.Reset();
+		return;
+	}
+
+	std::vector<std::pair<uint64_t, Hash>> peaks;
+	peaks.reserve(numPeaks);
+	for (size_t i = 0; i < numPeaks; i++)
+	{
+		peaks.emplace_back(peakIndices[i], pHashFile->GetDataAt(GetShiftedIndex(peakIndices[i], pPruneList)));
+	}
+
+	peakCache.Load(size, std::move(peaks));
+}
+
 Hash MMRHashUtil::GetHashAt(
 	std::shared_ptr<const HashFile> pHashFile,
 	const uint64_t mmrIndex,
@@ -142,17 +398,62 @@ std::vector<Hash> MMRHashUtil::GetLastLeafHashes(
 
 Hash MMRHashUtil::HashLeafWithIndex(const std::vector<unsigned char>& serializedLeaf, const uint64_t mmrIndex)
 {
-	Serializer hashSerializer;
-	hashSerializer.Append<uint64_t>(mmrIndex);
-	hashSerializer.AppendByteVector(serializedLeaf);
-	return Crypto::Blake2b(hashSerializer.GetBytes());
+	return Blake2bHasher()
+		.WriteU64(mmrIndex)
+		.Write(serializedLeaf.data(), serializedLeaf.size())
+		.Finalize();
 }
 
 Hash MMRHashUtil::HashParentWithIndex(const Hash& leftChild, const Hash& rightChild, const uint64_t parentIndex)
 {
-	Serializer serializer;
-	serializer.Append<uint64_t>(parentIndex);
-	serializer.AppendBigInteger<32>(leftChild);
-	serializer.AppendBigInteger<32>(rightChild);
-	return Crypto::Blake2b(serializer.GetBytes());
+	return Blake2bHasher()
+		.WriteU64(parentIndex)
+		.Write(leftChild.data(), 32)
+		.Write(rightChild.data(), 32)
+		.Finalize();
+}
+
+std::vector<Hash> MMRHashUtil::HashParentsWithIndex(
+	const std::vector<Hash>& leftChildren,
+	const std::vector<Hash>& rightChildren,
+	const std::vector<uint64_t>& parentIndices)
+{
+	const size_t count = parentIndices.size();
+
+	std::vector<Hash> hashes(count);
+	std::vector<unsigned char> messages(count * PARENT_MESSAGE_SIZE);
+	std::vector<const unsigned char*> pMessages(count);
+	std::vector<size_t> messageLengths(count, PARENT_MESSAGE_SIZE);
+	std::vector<unsigned char*> pOutputs(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		unsigned char* pMessage = messages.data() + (i * PARENT_MESSAGE_SIZE);
+		WriteParentMessage(pMessage, leftChildren[i].data(), rightChildren[i].data(), parentIndices[i]);
+
+		pMessages[i] = pMessage;
+		pOutputs[i] = hashes[i].data();
+	}
+
+	Crypto::Blake2bMulti(pMessages.data(), messageLengths.data(), pOutputs.data(), count);
+
+	return hashes;
+}
+
+void MMRHashUtil::WriteU64(unsigned char* pOutput, const uint64_t value)
+{
+	for (size_t i = 0; i < 8; i++)
+	{
+		pOutput[i] = (unsigned char)(value >> (56 - (8 * i)));
+	}
+}
+
+void MMRHashUtil::WriteParentMessage(
+	unsigned char* pOutput,
+	const unsigned char* pLeftChild,
+	const unsigned char* pRightChild,
+	const uint64_t parentIndex)
+{
+	WriteU64(pOutput, parentIndex);
+	std::copy(pLeftChild, pLeftChild + 32, pOutput + 8);
+	std::copy(pRightChild, pRightChild + 32, pOutput + 40);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "HashFile.h"
 #include "PruneList.h"
+#include "PeakCache.h"
 
 #include <Crypto/Hash.h>
 #include <Core/Traits/Lockable.h>
@@ -25,6 +26,43 @@ public:
 		std::shared_ptr<const PruneList> pPruneList
 	);
 
+	//
+	// Same as AddHashes/Root above, but using the in-memory peaks instead of reading them from the hash file.
+	// The peaks are loaded from the hash file first if the cache is invalid, or doesn't match the size of the MMR.
+	//
+	static void AddHashes(
+		std::shared_ptr<HashFile> pHashFile,
+		const std::vector<unsigned char>& serializedLeaf,
+		std::shared_ptr<const PruneList> pPruneList,
+		PeakCache& peakCache
+	);
+
+	static Hash Root(
+		std::shared_ptr<const HashFile> pHashFile,
+		const uint64_t size,
+		std::shared_ptr<const PruneList> pPruneList,
+		const PeakCache& peakCache
+	);
+
+	//
+	// Appends a batch of leaves, producing exactly the same hashes as calling AddHashes for each leaf in order.
+	// The leaf hashes, and then each level of parent hashes, are calculated in parallel,
+	// and all of the new hashes are appended to the hash file in MMR order with a single write.
+	//
+	static void AddHashes(
+		std::shared_ptr<HashFile> pHashFile,
+		const std::vector<std::vector<unsigned char>>& serializedLeaves,
+		std::shared_ptr<const PruneList> pPruneList,
+		PeakCache& peakCache
+	);
+
+	static void LoadPeaks(
+		std::shared_ptr<const HashFile> pHashFile,
+		const uint64_t size,
+		std::shared_ptr<const PruneList> pPruneList,
+		PeakCache& peakCache
+	);
+
 	static Hash GetHashAt(
 		std::shared_ptr<const HashFile> pHashFile,
 		const uint64_t mmrIndex,
@@ -40,7 +78,27 @@ public:
 
 	static Hash HashParentWithIndex(const Hash& leftChild, const Hash& rightChild, const uint64_t parentIndex);
 
+	//
+	// Same as calling HashParentWithIndex for each parent, but hashes several parents at a time using SIMD when available.
+	//
+	static std::vector<Hash> HashParentsWithIndex(
+		const std::vector<Hash>& leftChildren,
+		const std::vector<Hash>& rightChildren,
+		const std::vector<uint64_t>& parentIndices
+	);
+
 private:
 	static Hash HashLeafWithIndex(const std::vector<unsigned char>& serializedLeaf, const uint64_t mmrIndex);
+
+	// Parent hashes are taken over the big-endian parent index followed by both children.
+	static const size_t PARENT_MESSAGE_SIZE = 8 + 32 + 32;
+
+	static void WriteU64(unsigned char* pOutput, const uint64_t value);
+	static void WriteParentMessage(
+		unsigned char* pOutput,
+		const unsigned char* pLeftChild,
+		const unsigned char* pRightChild,
+		const uint64_t parentIndex
+	);
 	static uint64_t GetShiftedIndex(const uint64_t mmrIndex, std::shared_ptr<const PruneList> pPruneList);
 };
\ No newline at end of file
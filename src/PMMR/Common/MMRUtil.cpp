@@ -114,6 +114,35 @@ std::vector<uint64_t> MMRUtil::GetPeakIndices(const uint64_t size)
 	return peakIndices;
 }
 
+size_t MMRUtil::GetPeakIndices(const uint64_t size, std::array<uint64_t, 64>& peakIndices)
+{
+	size_t numPeaks = 0;
+	if (size > 0)
+	{
+		uint64_t peakSize = BitUtil::FillOnesToRight(size);
+		uint64_t numLeft = size;
+		uint64_t sumPrevPeaks = 0;
+		while (peakSize != 0)
+		{
+			if (numLeft >= peakSize)
+			{
+				peakIndices[numPeaks++] = sumPrevPeaks + peakSize - 1;
+				sumPrevPeaks += peakSize;
+				numLeft -= peakSize;
+			}
+
+			peakSize >>= 1;
+		}
+
+		if (numLeft > 0)
+		{
+			return 0;
+		}
+	}
+
+	return numPeaks;
+}
+
 std::vector<uint64_t> MMRUtil::GetPeakSizes(const uint64_t size)
 {
 	std::vector<uint64_t> peakSizes;
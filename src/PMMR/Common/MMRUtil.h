@@ -1,7 +1,9 @@
 #pragma once
 
 #include <stdint.h>
+#include <cstddef>
 #include <vector>
+#include <array>
 
 class MMRUtil
 {
@@ -12,6 +14,9 @@ public:
 	static uint64_t GetLeftChildIndex(const uint64_t mmrIndex, const uint64_t height);
 	static uint64_t GetRightChildIndex(const uint64_t mmrIndex);
 	static std::vector<uint64_t> GetPeakIndices(const uint64_t size);
+
+	// Non-allocating version of GetPeakIndices. Returns the number of peaks written, or 0 if size is not a valid MMR size.
+	static size_t GetPeakIndices(const uint64_t size, std::array<uint64_t, 64>& peakIndices);
 	static uint64_t GetNumNodes(const uint64_t mmrIndex);
 	static uint64_t GetNumLeaves(const uint64_t lastMMRIndex);
 	static bool IsLeaf(const uint64_t mmrIndex);
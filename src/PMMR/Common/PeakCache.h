@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Crypto/Hash.h>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+//
+// In-memory copy of the peaks of an MMR of a given size, kept up to date as hashes are appended.
+// Roots at that size can then be calculated without reading the hash file.
+// Peaks are ordered by position, so the peaks of an earlier size that are also peaks of this size can be found with a binary search.
+//
+// The cache is reloaded when the MMR is rewound, and reset (then reloaded by the next append) when it's rolled back.
+//
+class PeakCache
+{
+public:
+	PeakCache() : m_valid(false), m_size(0) { }
+
+	bool IsValid() const noexcept { return m_valid; }
+	uint64_t GetSize() const noexcept { return m_size; }
+	const std::vector<std::pair<uint64_t, Hash>>& GetPeaks() const noexcept { return m_peaks; }
+
+	void Reset() noexcept
+	{
+		m_valid = false;
+		m_size = 0;
+		m_peaks.clear();
+	}
+
+	void Load(const uint64_t size, std::vector<std::pair<uint64_t, Hash>>&& peaks)
+	{
+		m_valid = true;
+		m_size = size;
+		m_peaks = std::move(peaks);
+	}
+
+	void Push(const uint64_t position, const Hash& hash)
+	{
+		m_peaks.emplace_back(position, hash);
+		m_size = position + 1;
+	}
+
+	std::pair<uint64_t, Hash> Pop()
+	{
+		std::pair<uint64_t, Hash> peak = std::move(m_peaks.back());
+		m_peaks.pop_back();
+		return peak;
+	}
+
+	//
+	// Returns the cached hash at the given position, if it's one of the cached peaks.
+	//
+	const Hash* Find(const uint64_t position) const noexcept
+	{
+		size_t low = 0;
+		size_t high = m_peaks.size();
+		while (low < high)
+		{
+			const size_t mid = low + ((high - low) / 2);
+			if (m_peaks[mid].first < position)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+
+		if (low < m_peaks.size() && m_peaks[low].first == position)
+		{
+			return &m_peaks[low].second;
+		}
+
+		return nullptr;
+	}
+
+private:
+	bool m_valid;
+	uint64_t m_size;
+	std::vector<std::pair<uint64_t, Hash>> m_peaks;
+};
\ No newline at end of file
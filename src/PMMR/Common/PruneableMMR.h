@@ -30,7 +30,7 @@ public:
 		m_pPruneList(pPruneList),
 		m_pDataFile(pDataFile)
 	{
-
+		MMRHashUtil::LoadPeaks(m_pHashFile, GetSize(), m_pPruneList, m_peakCache);
 	}
 
 	virtual ~PruneableMMR() = default;
@@ -50,7 +50,7 @@ public:
 		m_pDataFile->AddData(serializer.GetBytes());
 
 		// Add hashes
-		MMRHashUtil::AddHashes(m_pHashFile, serializer.GetBytes(), m_pPruneList);
+		MMRHashUtil::AddHashes(m_pHashFile, serializer.GetBytes(), m_pPruneList, m_peakCache);
 	}
 
 	void Remove(const uint64_t mmrIndex)
@@ -81,11 +81,35 @@ public:
 		m_pHashFile->Rewind(size - m_pPruneList->GetShift(size - 1));
 		m_pDataFile->Rewind(MMRUtil::GetNumLeaves(size - 1) - m_pPruneList->GetLeafShift(size - 1));
 		m_pLeafSet->Rewind(MMRUtil::GetNumLeaves(size - 1), leavesToAdd);
+		MMRHashUtil::LoadPeaks(m_pHashFile, GetSize(), m_pPruneList, m_peakCache);
+	}
+
+	//
+	// Returns the leaf indices of up to maxLeaves unspent leaves, starting at startLeafIndex.
+	// Only leaves below endLeafIndex (and within the MMR) are considered.
+	//
+	std::vector<uint64_t> GetUnspentLeaves(const uint64_t startLeafIndex, const uint64_t maxLeaves, const uint64_t endLeafIndex = UINT64_MAX) const
+	{
+		const uint64_t size = GetSize();
+		if (size == 0)
+		{
+			return std::vector<uint64_t>{};
+		}
+
+		return m_pLeafSet->GetUnspentLeaves(startLeafIndex, (std::min)(endLeafIndex, MMRUtil::GetNumLeaves(size - 1)), maxLeaves);
+	}
+
+	//
+	// Writes the leafset, as of the given MMR size, to a Roaring bitmap file.
+	//
+	void SnapshotLeafSet(const fs::path& path, const uint64_t size, const std::vector<uint64_t>& leavesToAdd) const
+	{
+		m_pLeafSet->Snapshot(path, MMRUtil::GetNumLeaves(size - 1), leavesToAdd);
 	}
 
 	Hash Root(const uint64_t size) const final
 	{
-		return MMRHashUtil::Root(m_pHashFile, size, m_pPruneList);
+		return MMRHashUtil::Root(m_pHashFile, size, m_pPruneList, m_peakCache);
 	}
 
 	Hash UBMTRoot(const uint64_t size) const
@@ -155,6 +179,58 @@ public:
 		return std::unique_ptr<DATA_TYPE>(nullptr);
 	}
 
+	//
+	// Appends up to maxLeaves unspent leaves below endLeafIndex, starting at startLeafIndex, to 'leaves' as (leafIndex, data) pairs.
+	// Consecutive unspent leaves are stored contiguously in the data file, so the prune shift is calculated
+	// and the data is read once per run of leaves, rather than once per leaf.
+	// Returns the number of leaves appended.
+	//
+	size_t GetRange(const uint64_t startLeafIndex, const uint64_t maxLeaves, std::vector<std::pair<uint64_t, DATA_TYPE>>& leaves, const uint64_t endLeafIndex = UINT64_MAX) const
+	{
+		const std::vector<uint64_t> leafIndices = GetUnspentLeaves(startLeafIndex, maxLeaves, endLeafIndex);
+		leaves.reserve(leaves.size() + leafIndices.size());
+
+		std::vector<unsigned char> data;
+		size_t runStart = 0;
+		while (runStart < leafIndices.size())
+		{
+			size_t runEnd = runStart + 1;
+			while (runEnd < leafIndices.size() && leafIndices[runEnd] == leafIndices[runEnd - 1] + 1)
+			{
+				++runEnd;
+			}
+
+			const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(leafIndices[runStart]);
+			const uint64_t shiftedIndex = leafIndices[runStart] - m_pPruneList->GetLeafShift(mmrIndex);
+			const size_t runLength = runEnd - runStart;
+			m_pDataFile->GetDataRange(shiftedIndex, runLength, data);
+
+			ByteBuffer byteBuffer(data);
+			for (size_t i = 0; i < runLength; i++)
+			{
+				leaves.emplace_back(leafIndices[runStart + i], DATA_TYPE::Deserialize(byteBuffer));
+				if (byteBuffer.GetRemainingSize() != (runLength - i - 1) * DATA_SIZE)
+				{
+					throw TXHASHSET_EXCEPTION(StringUtil::Format("Invalid data at mmr index {}", MMRUtil::GetPMMRIndex(leafIndices[runStart + i])));
+				}
+			}
+
+			runStart = runEnd;
+		}
+
+		return leafIndices.size();
+	}
+
+	void Journal(CommitJournal& journal) const final
+	{
+		if (IsDirty())
+		{
+			m_pHashFile->Journal(journal);
+			m_pDataFile->Journal(journal);
+			m_pLeafSet->Journal(journal);
+		}
+	}
+
 	void Commit() final
 	{
 		if (IsDirty())
@@ -175,6 +251,7 @@ public:
 			m_pHashFile->Rollback();
 			m_pDataFile->Rollback();
 			m_pLeafSet->Rollback();
+			m_peakCache.Reset();
 			SetDirty(false);
 		}
 	}
@@ -184,4 +261,5 @@ private:
 	std::shared_ptr<LeafSet> m_pLeafSet;
 	std::shared_ptr<PruneList> m_pPruneList;
 	std::shared_ptr<DataFile<DATA_SIZE>> m_pDataFile;
+	PeakCache m_peakCache;
 };
\ No newline at end of file
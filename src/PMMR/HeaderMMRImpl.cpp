@@ -9,7 +9,8 @@
 HeaderMMR::HeaderMMR(std::shared_ptr<Locked<HashFile>> pHashFile)
 	: m_pLockedHashFile(pHashFile)
 {
-
+	auto pReader = m_pLockedHashFile->Read();
+	MMRHashUtil::LoadPeaks(pReader.GetShared(), pReader->GetSize(), nullptr, m_peakCache);
 }
 
 std::shared_ptr<HeaderMMR> HeaderMMR::Load(const fs::path& path)
@@ -19,6 +20,14 @@ std::shared_ptr<HeaderMMR> HeaderMMR::Load(const fs::path& path)
 	return std::make_shared<HeaderMMR>(HeaderMMR(locked));
 }
 
+void HeaderMMR::Journal(CommitJournal& journal) const
+{
+	if (IsDirty())
+	{
+		m_batchDataOpt.value().hashFile->Journal(journal);
+	}
+}
+
 void HeaderMMR::Commit()
 {
 	if (IsDirty())
@@ -36,6 +45,7 @@ void HeaderMMR::Rollback() noexcept
 	{
 		LOG_DEBUG("Discarding changes.");
 		m_batchDataOpt.value().hashFile->Rollback();
+		m_peakCache.Reset();
 		SetDirty(false);
 	}
 }
@@ -47,6 +57,7 @@ void HeaderMMR::Rewind(const uint64_t size)
 	{
 		LOG_DEBUG_F("Rewinding to height {} - {} hashes", size, mmrSize);
 		m_batchDataOpt.value().hashFile->Rewind(mmrSize);
+		MMRHashUtil::LoadPeaks(m_batchDataOpt.value().hashFile.GetShared(), mmrSize, nullptr, m_peakCache);
 		SetDirty(true);
 	}
 }
@@ -61,7 +72,29 @@ void HeaderMMR::AddHeader(const BlockHeader& header)
 	const std::vector<unsigned char> serializedHeader = serializer.GetBytes();
 
 	// Add hashes
-	MMRHashUtil::AddHashes(m_batchDataOpt.value().hashFile.GetShared(), serializedHeader, nullptr);
+	MMRHashUtil::AddHashes(m_batchDataOpt.value().hashFile.GetShared(), serializedHeader, nullptr, m_peakCache);
+	SetDirty(true);
+}
+
+void HeaderMMR::AddHeaders(const std::vector<BlockHeaderPtr>& headers)
+{
+	if (headers.empty())
+	{
+		return;
+	}
+
+	LOG_TRACE_F("Adding {} headers at height {} - MMR size {}", headers.size(), headers.front()->GetHeight(), m_batchDataOpt.value().hashFile->GetSize());
+
+	std::vector<std::vector<unsigned char>> serializedHeaders;
+	serializedHeaders.reserve(headers.size());
+	for (const BlockHeaderPtr& pHeader : headers)
+	{
+		Serializer serializer;
+		pHeader->GetProofOfWork().SerializeCycle(serializer);
+		serializedHeaders.emplace_back(serializer.GetBytes());
+	}
+
+	MMRHashUtil::AddHashes(m_batchDataOpt.value().hashFile.GetShared(), serializedHeaders, nullptr, m_peakCache);
 	SetDirty(true);
 }
 
@@ -71,11 +104,11 @@ Hash HeaderMMR::Root(const uint64_t lastHeight) const
 
 	if (m_batchDataOpt.has_value())
 	{
-		return MMRHashUtil::Root(m_batchDataOpt.value().hashFile.GetShared(), position, nullptr);
+		return MMRHashUtil::Root(m_batchDataOpt.value().hashFile.GetShared(), position, nullptr, m_peakCache);
 	}
 	else
 	{
-		return MMRHashUtil::Root(m_pLockedHashFile->Read().GetShared(), position, nullptr);
+		return MMRHashUtil::Root(m_pLockedHashFile->Read().GetShared(), position, nullptr, m_peakCache);
 	}
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common/HashFile.h"
+#include "Common/PeakCache.h"
 
 #include <PMMR/HeaderMMR.h>
 #include <Core/Models/BlockHeader.h>
@@ -13,9 +14,11 @@ public:
 	static std::shared_ptr<HeaderMMR> Load(const fs::path& path);
 
 	virtual void AddHeader(const BlockHeader& header) override final;
+	virtual void AddHeaders(const std::vector<BlockHeaderPtr>& headers) override final;
 	virtual Hash Root(const uint64_t lastHeight) const override final;
 	virtual void Rewind(const uint64_t size) override final;
 
+	virtual void Journal(CommitJournal& journal) const override final;
 	virtual void Commit() override final;
 	virtual void Rollback() noexcept override final;
 
@@ -23,6 +26,7 @@ private:
 	HeaderMMR(std::shared_ptr<Locked<HashFile>> pHashFile);
 
 	std::shared_ptr<Locked<HashFile>> m_pLockedHashFile;
+	PeakCache m_peakCache;
 
 	virtual void OnInitWrite() override final
 	{
@@ -10,7 +10,7 @@ KernelMMR::KernelMMR(std::shared_ptr<HashFile> pHashFile, std::shared_ptr<DataFi
 	: m_pHashFile(pHashFile),
 	m_pDataFile(pDataFile)
 {
-
+	MMRHashUtil::LoadPeaks(m_pHashFile, m_pHashFile->GetSize(), nullptr, m_peakCache);
 }
 
 std::shared_ptr<KernelMMR> KernelMMR::Load(const fs::path& txHashSetPath, const FullBlock& genesisBlock)
@@ -30,7 +30,7 @@ std::shared_ptr<KernelMMR> KernelMMR::Load(const fs::path& txHashSetPath, const
 
 Hash KernelMMR::Root(const uint64_t size) const
 {
-	return MMRHashUtil::Root(m_pHashFile, size, nullptr);
+	return MMRHashUtil::Root(m_pHashFile, size, nullptr, m_peakCache);
 }
 
 std::unique_ptr<TransactionKernel> KernelMMR::GetKernelAt(const uint64_t mmrIndex) const
@@ -51,6 +51,29 @@ std::unique_ptr<TransactionKernel> KernelMMR::GetKernelAt(const uint64_t mmrInde
 	return std::unique_ptr<TransactionKernel>(nullptr);
 }
 
+size_t KernelMMR::GetKernels(const uint64_t startLeafIndex, const uint64_t maxKernels, std::vector<TransactionKernel>& kernels) const
+{
+	const uint64_t numKernels = m_pDataFile->GetSize();
+	if (startLeafIndex >= numKernels)
+	{
+		return 0;
+	}
+
+	const uint64_t count = (std::min)(maxKernels, numKernels - startLeafIndex);
+
+	std::vector<unsigned char> data;
+	m_pDataFile->GetDataRange(startLeafIndex, count, data);
+
+	kernels.reserve(kernels.size() + count);
+	ByteBuffer byteBuffer(data);
+	for (uint64_t i = 0; i < count; i++)
+	{
+		kernels.emplace_back(TransactionKernel::Deserialize(byteBuffer));
+	}
+
+	return (size_t)count;
+}
+
 std::vector<Hash> KernelMMR::GetLastLeafHashes(const uint64_t numHashes) const
 {
 	return MMRHashUtil::GetLastLeafHashes(m_pHashFile, nullptr, nullptr, numHashes);
@@ -60,9 +83,16 @@ bool KernelMMR::Rewind(const uint64_t size)
 {
 	m_pHashFile->Rewind(size);
 	m_pDataFile->Rewind(MMRUtil::GetNumLeaves(size - 1));
+	MMRHashUtil::LoadPeaks(m_pHashFile, m_pHashFile->GetSize(), nullptr, m_peakCache);
 	return true;
 }
 
+void KernelMMR::Journal(CommitJournal& journal) const
+{
+	m_pHashFile->Journal(journal);
+	m_pDataFile->Journal(journal);
+}
+
 void KernelMMR::Commit()
 {
 	m_pHashFile->Commit();
@@ -73,6 +103,7 @@ void KernelMMR::Rollback() noexcept
 {
 	m_pHashFile->Rollback();
 	m_pDataFile->Rollback();
+	m_peakCache.Reset();
 }
 
 void KernelMMR::ApplyKernel(const TransactionKernel& kernel)
@@ -83,5 +114,5 @@ void KernelMMR::ApplyKernel(const TransactionKernel& kernel)
 	m_pDataFile->AddData(serializer.GetBytes());
 
 	// Add hashes
-	MMRHashUtil::AddHashes(m_pHashFile, serializer.GetBytes(), nullptr);
+	MMRHashUtil::AddHashes(m_pHashFile, serializer.GetBytes(), nullptr, m_peakCache);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Common/MMR.h"
 #include "Common/HashFile.h"
+#include "Common/PeakCache.h"
 
 #include <Core/File/DataFile.h>
 #include <Core/Models/TransactionKernel.h>
@@ -20,6 +21,12 @@ public:
 	virtual ~KernelMMR() = default;
 
 	std::unique_ptr<TransactionKernel> GetKernelAt(const uint64_t mmrIndex) const;
+
+	//
+	// Appends up to maxKernels kernels, starting at startLeafIndex, to 'kernels' using a single read.
+	// Returns the number of kernels appended.
+	//
+	size_t GetKernels(const uint64_t startLeafIndex, const uint64_t maxKernels, std::vector<TransactionKernel>& kernels) const;
 	bool Rewind(const uint64_t size);
 
 	virtual Hash Root(const uint64_t size) const override final;
@@ -27,6 +34,7 @@ public:
 	virtual std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const override final { return std::make_unique<Hash>(m_pHashFile->GetDataAt(mmrIndex)); }
 	virtual std::vector<Hash> GetLastLeafHashes(const uint64_t numHashes) const override final;
 
+	virtual void Journal(CommitJournal& journal) const override final;
 	virtual void Commit() override final;
 	virtual void Rollback() noexcept override final;
 
@@ -37,4 +45,5 @@ private:
 
 	mutable std::shared_ptr<HashFile> m_pHashFile;
 	mutable std::shared_ptr<DataFile<KERNEL_SIZE>> m_pDataFile;
+	PeakCache m_peakCache;
 };
\ No newline at end of file
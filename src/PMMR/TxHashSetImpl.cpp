@@ -285,30 +285,27 @@ std::vector<Hash> TxHashSet::GetLastRangeProofHashes(const uint64_t numberOfRang
 OutputRange TxHashSet::GetOutputsByLeafIndex(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t maxNumOutputs) const
 {
 	const uint64_t outputSize = m_pOutputPMMR->GetSize();
-	
-	uint64_t leafIndex = startIndex;
+
+	// Spent leaves are skipped using the leafset's rank index, and each run of consecutive unspent leaves is read at once.
+	std::vector<std::pair<uint64_t, OutputIdentifier>> identifiers;
+	std::vector<std::pair<uint64_t, RangeProof>> rangeProofs;
+	m_pOutputPMMR->GetRange(startIndex, maxNumOutputs, identifiers);
+	m_pRangeProofPMMR->GetRange(startIndex, identifiers.size(), rangeProofs);
+
 	std::vector<OutputDTO> outputs;
-	outputs.reserve(maxNumOutputs);
-	while (outputs.size() < maxNumOutputs)
+	outputs.reserve(identifiers.size());
+	for (size_t i = 0; i < identifiers.size(); i++)
 	{
-		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(leafIndex++);
-		if (mmrIndex >= outputSize)
-		{
-			break;
-		}
+		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(identifiers[i].first);
 
-		std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetAt(mmrIndex);
-		if (pOutput != nullptr)
+		std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->GetOutputPosition(identifiers[i].second.GetCommitment());
+		if (i >= rangeProofs.size() || rangeProofs[i].first != identifiers[i].first
+			|| pOutputPosition == nullptr || pOutputPosition->GetMMRIndex() != mmrIndex)
 		{
-			std::unique_ptr<RangeProof> pRangeProof = m_pRangeProofPMMR->GetAt(mmrIndex);
-			std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->GetOutputPosition(pOutput->GetCommitment());
-			if (pRangeProof == nullptr || pOutputPosition == nullptr || pOutputPosition->GetMMRIndex() != mmrIndex)
-			{
-				throw TXHASHSET_EXCEPTION(StringUtil::Format("Failed to build OutputDTO at index {}", mmrIndex));
-			}
-
-			outputs.emplace_back(OutputDTO(false, *pOutput, *pOutputPosition, *pRangeProof));
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Failed to build OutputDTO at index {}", mmrIndex));
 		}
+
+		outputs.emplace_back(OutputDTO(false, identifiers[i].second, *pOutputPosition, rangeProofs[i].second));
 	}
 
 	const uint64_t maxLeafIndex = MMRUtil::GetNumLeaves(outputSize - 1);
@@ -373,6 +370,42 @@ void TxHashSet::Rewind(std::shared_ptr<IBlockDB> pBlockDB, const BlockHeader& he
 	m_pRangeProofPMMR->Rewind(header.GetOutputMMRSize(), leavesToAdd);
 }
 
+void TxHashSet::SnapshotLeafSets(std::shared_ptr<const IBlockDB> pBlockDB, const BlockHeader& header, const fs::path& snapshotDir) const
+{
+	std::vector<uint64_t> leavesToAdd;
+
+	BlockHeaderPtr pBlockHeader = m_pBlockHeader;
+	while (*pBlockHeader != header)
+	{
+		if (pBlockHeader->GetHeight() <= header.GetHeight())
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("{} is not an ancestor of {}", header, *m_pBlockHeader));
+		}
+
+		for (const auto& spent : pBlockDB->GetSpentPositions(pBlockHeader->GetHash()))
+		{
+			leavesToAdd.push_back(MMRUtil::GetLeafIndex(spent.second.GetMMRIndex()));
+		}
+
+		pBlockHeader = pBlockDB->GetBlockHeader(pBlockHeader->GetPreviousBlockHash());
+		if (pBlockHeader == nullptr)
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Header not found while rewinding to {}", header));
+		}
+	}
+
+	const std::string fileName = StringUtil::Format("pmmr_leaf.bin.{}", header.ShortHash());
+	m_pOutputPMMR->SnapshotLeafSet(snapshotDir / "output" / fileName, header.GetOutputMMRSize(), leavesToAdd);
+	m_pRangeProofPMMR->SnapshotLeafSet(snapshotDir / "rangeproof" / fileName, header.GetOutputMMRSize(), leavesToAdd);
+}
+
+void TxHashSet::Journal(CommitJournal& journal) const
+{
+	m_pKernelMMR->Journal(journal);
+	m_pOutputPMMR->Journal(journal);
+	m_pRangeProofPMMR->Journal(journal);
+}
+
 void TxHashSet::Commit()
 {
 	std::vector<std::thread> threads;
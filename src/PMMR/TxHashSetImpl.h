@@ -38,6 +38,14 @@ public:
 	std::vector<OutputDTO> GetOutputsByMMRIndex(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t lastIndex) const final;
 
 	void Rewind(std::shared_ptr<IBlockDB> pBlockDB, const BlockHeader& header) final;
+	//
+	// Writes the output and rangeproof leafsets, as of the given header, to pmmr_leaf.bin.<hash> files in snapshotDir.
+	// The leaves spent since that header are read from the spent positions stored for each block,
+	// so neither the full blocks nor the leafset bitmaps need to be read or rewound.
+	//
+	void SnapshotLeafSets(std::shared_ptr<const IBlockDB> pBlockDB, const BlockHeader& header, const fs::path& snapshotDir) const;
+
+	void Journal(CommitJournal& journal) const final;
 	void Commit() final;
 	void Rollback() noexcept final;
 	void Compact() final;
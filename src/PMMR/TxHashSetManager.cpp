@@ -7,6 +7,7 @@
 #include <Common/Util/FileUtil.h>
 #include <Common/Util/StringUtil.h>
 #include <Core/File/FileRemover.h>
+#include <Core/Exceptions/TxHashSetException.h>
 #include <Infrastructure/Logger.h>
 
 #include <filesystem.h>
@@ -95,7 +96,8 @@ fs::path TxHashSetManager::SaveSnapshot(std::shared_ptr<IBlockDB> pBlockDB, Bloc
 {
 	if (m_pTxHashSet == nullptr)
 	{
-		throw std::exception();
+		LOG_ERROR_F("Can't snapshot {}: TxHashSet is not open", *pHeader);
+		throw TXHASHSET_EXCEPTION_F("Can't snapshot {}: TxHashSet is not open", *pHeader);
 	}
 
 	fs::path snapshotDir = fs::temp_directory_path() / "Snapshots" / pHeader->ShortHash();
@@ -106,42 +108,49 @@ fs::path TxHashSetManager::SaveSnapshot(std::shared_ptr<IBlockDB> pBlockDB, Bloc
 
 	try
 	{
-		BlockHeaderPtr pFlushedHeader = nullptr;
-
+		auto pTxHashSet = std::dynamic_pointer_cast<const TxHashSet>(m_pTxHashSet);
+		if (pTxHashSet == nullptr)
 		{
-			// Copy to Snapshots/Hash // TODO: If already exists, just use that.
-			FileUtil::CopyDirectory(m_config.GetNodeConfig().GetTxHashSetPath(), snapshotDir);
+			LOG_ERROR_F("Can't snapshot {}: TxHashSet is not file-backed", *pHeader);
+			throw TXHASHSET_EXCEPTION_F("Can't snapshot {}: TxHashSet is not file-backed", *pHeader);
+		}
 
-			pFlushedHeader = m_pTxHashSet->GetFlushedBlockHeader();
+		// Copy only the hash, data, and prune list files. The leafsets are reconstructed separately.
+		const fs::path txHashSetPath = m_config.GetNodeConfig().GetTxHashSetPath();
+		for (const std::string folder : { "kernel", "output", "rangeproof" })
+		{
+			FileUtil::CreateDirectories(snapshotDir / folder);
+			for (const std::string file : { "pmmr_hash.bin", "pmmr_data.bin", "pmmr_prun.bin" })
+			{
+				if (FileUtil::Exists(txHashSetPath / folder / file))
+				{
+					fs::copy_file(txHashSetPath / folder / file, snapshotDir / folder / file, fs::copy_options::overwrite_existing);
+				}
+			}
 		}
 
 		{
 			const FullBlock& genesisBlock = m_config.GetEnvironment().GetGenesisBlock();
 
-			// Load Snapshot TxHashSet
+			// Rewind the copied hash and data files. With no leaves to add back, this only truncates them.
 			auto pKernelMMR = KernelMMR::Load(snapshotDir, genesisBlock);
-			auto pOutputPMMR = OutputPMMR::Load(snapshotDir, genesisBlock);
-			auto pRangeProofPMMR = RangeProofPMMR::Load(snapshotDir, genesisBlock);
-			TxHashSet snapshotTxHashSet(m_config, pKernelMMR, pOutputPMMR, pRangeProofPMMR, pFlushedHeader);
+			pKernelMMR->Rewind(pHeader->GetKernelMMRSize());
+			pKernelMMR->Commit();
 
-			// Rewind Snapshot TxHashSet
-			snapshotTxHashSet.Rewind(pBlockDB, *pHeader);
+			auto pOutputPMMR = OutputPMMR::Load(snapshotDir, genesisBlock);
+			pOutputPMMR->Rewind(pHeader->GetOutputMMRSize(), {});
+			pOutputPMMR->Commit();
 
-			// Flush Snapshot TxHashSet
-			snapshotTxHashSet.Commit();
+			auto pRangeProofPMMR = RangeProofPMMR::Load(snapshotDir, genesisBlock);
+			pRangeProofPMMR->Rewind(pHeader->GetOutputMMRSize(), {});
+			pRangeProofPMMR->Commit();
 		}
 
-		// Rename pmmr_leaf files
-		const std::string newFileName = StringUtil::Format("pmmr_leaf.bin.{}", pHeader->ShortHash());
-		FileUtil::RenameFile(
-			snapshotDir / "output" / "pmmr_leaf.bin",
-			snapshotDir / "output" / newFileName
-		);
-
-		FileUtil::RenameFile(
-			snapshotDir / "rangeproof" / "pmmr_leaf.bin",
-			snapshotDir / "rangeproof" / newFileName
-		);
+		// Remove the empty leafset bitmaps created while loading, and write the leafsets as of the snapshot header.
+		FileUtil::RemoveFile(snapshotDir / "output" / "pmmr_leafset.bin");
+		FileUtil::RemoveFile(snapshotDir / "rangeproof" / "pmmr_leafset.bin");
+
+		pTxHashSet->SnapshotLeafSets(pBlockDB, *pHeader, snapshotDir);
 
 		// Create Zip
 		const std::vector<fs::path> pathsToZip = {
@@ -147,35 +147,69 @@ bool TxHashSetValidator::ValidateSizes(TxHashSet& txHashSet, const BlockHeader&
 // TODO: This probably belongs in MMRHashUtil.
 bool TxHashSetValidator::ValidateMMRHashes(std::shared_ptr<const MMR> pMMR) const
 {
+	// Parents are checked in batches so they can be hashed several at a time.
+	const size_t BATCH_SIZE = 1024;
+
 	try
 	{
+		std::vector<Hash> parentHashes;
+		std::vector<Hash> leftHashes;
+		std::vector<Hash> rightHashes;
+		std::vector<uint64_t> parentIndices;
+
+		auto validateBatch = [&parentHashes, &leftHashes, &rightHashes, &parentIndices]() -> bool {
+			const std::vector<Hash> expectedHashes = MMRHashUtil::HashParentsWithIndex(leftHashes, rightHashes, parentIndices);
+			for (size_t j = 0; j < expectedHashes.size(); j++)
+			{
+				if (parentHashes[j] != expectedHashes[j])
+				{
+					LOG_ERROR_F("Invalid parent hash at index ({})", parentIndices[j]);
+					return false;
+				}
+			}
+
+			parentHashes.clear();
+			leftHashes.clear();
+			rightHashes.clear();
+			parentIndices.clear();
+			return true;
+		};
+
 		const uint64_t size = pMMR->GetSize();
 		for (uint64_t i = 0; i < size; i++)
 		{
 			const uint64_t height = MMRUtil::GetHeight(i);
 			if (height > 0)
 			{
-				const std::unique_ptr<Hash> pParentHash = pMMR->GetHashAt(i);
+				std::unique_ptr<Hash> pParentHash = pMMR->GetHashAt(i);
 				if (pParentHash != nullptr)
 				{
 					const uint64_t leftIndex = MMRUtil::GetLeftChildIndex(i, height);
-					const std::unique_ptr<Hash> pLeftHash = pMMR->GetHashAt(leftIndex);
+					std::unique_ptr<Hash> pLeftHash = pMMR->GetHashAt(leftIndex);
 
 					const uint64_t rightIndex = MMRUtil::GetRightChildIndex(i);
-					const std::unique_ptr<Hash> pRightHash = pMMR->GetHashAt(rightIndex);
+					std::unique_ptr<Hash> pRightHash = pMMR->GetHashAt(rightIndex);
 
 					if (pLeftHash != nullptr && pRightHash != nullptr)
 					{
-						const Hash expectedHash = MMRHashUtil::HashParentWithIndex(*pLeftHash, *pRightHash, i);
-						if (*pParentHash != expectedHash)
+						parentHashes.emplace_back(std::move(*pParentHash));
+						leftHashes.emplace_back(std::move(*pLeftHash));
+						rightHashes.emplace_back(std::move(*pRightHash));
+						parentIndices.push_back(i);
+
+						if (parentIndices.size() == BATCH_SIZE && !validateBatch())
 						{
-							LOG_ERROR_F("Invalid parent hash at index ({})", i);
 							return false;
 						}
 					}
 				}
 			}
 		}
+
+		if (!validateBatch())
+		{
+			return false;
+		}
 	}
 	catch (...)
 	{
@@ -217,28 +251,45 @@ BlockSums TxHashSetValidator::ValidateKernelSums(TxHashSet& txHashSet, const Blo
 	// Calculate overage
 	const int64_t overage = 0 - (Consensus::REWARD * (1 + blockHeader.GetHeight()));
 
+	// Outputs and kernels are read in batches, with 1 read per run of consecutive leaves.
+	const uint64_t BATCH_SIZE = 1000;
+
 	// Determine output commitments
 	std::shared_ptr<const OutputPMMR> pOutputPMMR = txHashSet.GetOutputPMMR();
 	std::vector<Commitment> outputCommitments;
-	for (uint64_t i = 0; i < blockHeader.GetOutputMMRSize(); i++)
+	std::vector<std::pair<uint64_t, OutputIdentifier>> outputs;
+	const uint64_t numOutputs = blockHeader.GetOutputMMRSize() > 0 ? MMRUtil::GetNumLeaves(blockHeader.GetOutputMMRSize() - 1) : 0;
+	uint64_t nextLeafIndex = 0;
+	while (nextLeafIndex < numOutputs && pOutputPMMR->GetRange(nextLeafIndex, BATCH_SIZE, outputs, numOutputs) > 0)
 	{
-		std::unique_ptr<OutputIdentifier> pOutput = pOutputPMMR->GetAt(i);
-		if (pOutput != nullptr)
+		nextLeafIndex = outputs.back().first + 1;
+		for (const auto& output : outputs)
 		{
-			outputCommitments.push_back(pOutput->GetCommitment());
+			outputCommitments.push_back(output.second.GetCommitment());
 		}
+
+		outputs.clear();
 	}
 
 	// Determine kernel excess commitments
 	std::shared_ptr<const KernelMMR> pKernelMMR = txHashSet.GetKernelMMR();
+	const uint64_t numKernels = blockHeader.GetKernelMMRSize() > 0 ? MMRUtil::GetNumLeaves(blockHeader.GetKernelMMRSize() - 1) : 0;
 	std::vector<Commitment> excessCommitments;
-	for (uint64_t i = 0; i < blockHeader.GetKernelMMRSize(); i++)
+	std::vector<TransactionKernel> kernels;
+	while (excessCommitments.size() < numKernels)
 	{
-		std::unique_ptr<TransactionKernel> pKernel = pKernelMMR->GetKernelAt(i);
-		if (pKernel != nullptr)
+		const uint64_t maxKernels = (std::min)(BATCH_SIZE, numKernels - excessCommitments.size());
+		if (pKernelMMR->GetKernels(excessCommitments.size(), maxKernels, kernels) == 0)
+		{
+			break;
+		}
+
+		for (const TransactionKernel& kernel : kernels)
 		{
-			excessCommitments.push_back(pKernel->GetExcessCommitment());
+			excessCommitments.push_back(kernel.GetExcessCommitment());
 		}
+
+		kernels.clear();
 	}
 
 	return KernelSumValidator::ValidateKernelSums(
@@ -258,41 +309,37 @@ bool TxHashSetValidator::ValidateRangeProofs(TxHashSet& txHashSet, SyncStatus& s
 	size_t i = 0;
 	LOG_INFO("BEGIN");
 	const uint64_t outputMMRSize = txHashSet.GetOutputPMMR()->GetSize();
-	for (uint64_t mmrIndex = 0; mmrIndex < outputMMRSize; mmrIndex++)
+
+	std::vector<std::pair<uint64_t, OutputIdentifier>> outputs;
+	std::vector<std::pair<uint64_t, RangeProof>> proofs;
+	uint64_t nextLeafIndex = 0;
+	while (txHashSet.GetOutputPMMR()->GetRange(nextLeafIndex, 1000, outputs) > 0)
 	{
-		std::unique_ptr<OutputIdentifier> pOutput = txHashSet.GetOutputPMMR()->GetAt(mmrIndex);
-		if (pOutput != nullptr)
+		txHashSet.GetRangeProofPMMR()->GetRange(nextLeafIndex, outputs.size(), proofs);
+		for (size_t j = 0; j < outputs.size(); j++)
 		{
-			std::unique_ptr<RangeProof> pRangeProof = txHashSet.GetRangeProofPMMR()->GetAt(mmrIndex);
-			if (pRangeProof == nullptr)
+			if (j >= proofs.size() || proofs[j].first != outputs[j].first)
 			{
-				LOG_ERROR_F("No rangeproof found at mmr index ({})", mmrIndex);
+				LOG_ERROR_F("No rangeproof found at mmr index ({})", MMRUtil::GetPMMRIndex(outputs[j].first));
 				return false;
 			}
 
-			rangeProofs.emplace_back(std::make_pair(pOutput->GetCommitment(), *pRangeProof));
+			rangeProofs.emplace_back(std::make_pair(outputs[j].second.GetCommitment(), std::move(proofs[j].second)));
 			++i;
-
-			if (rangeProofs.size() >= 1000)
-			{
-				if (!Crypto::VerifyRangeProofs(rangeProofs))
-				{
-					return false;
-				}
-
-				rangeProofs.clear();
-
-				syncStatus.UpdateProcessingStatus((uint8_t)(40 + ((30.0 * mmrIndex) / outputMMRSize)));
-			}
 		}
-	}
 
-	if (!rangeProofs.empty())
-	{
 		if (!Crypto::VerifyRangeProofs(rangeProofs))
 		{
 			return false;
 		}
+
+		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(outputs.back().first);
+		nextLeafIndex = outputs.back().first + 1;
+		rangeProofs.clear();
+		outputs.clear();
+		proofs.clear();
+
+		syncStatus.UpdateProcessingStatus((uint8_t)(40 + ((30.0 * mmrIndex) / outputMMRSize)));
 	}
 
 	LOG_INFO_F("SUCCESS ({})", i);
@@ -304,33 +351,18 @@ bool TxHashSetValidator::ValidateKernelSignatures(const KernelMMR& kernelMMR, Sy
 	std::vector<TransactionKernel> kernels;
 
 	const uint64_t mmrSize = kernelMMR.GetSize();
-	for (uint64_t i = 0; i < mmrSize; i++)
-	{
-		std::unique_ptr<TransactionKernel> pKernel = kernelMMR.GetKernelAt(i);
-		if (pKernel != nullptr)
-		{
-			kernels.push_back(*pKernel);
-
-			if (kernels.size() >= 2000)
-			{
-				if (!KernelSignatureValidator::VerifyKernelSignatures(kernels))
-				{
-					return false;
-				}
-
-				kernels.clear();
-
-				syncStatus.UpdateProcessingStatus((uint8_t)(70 + ((30.0 * i) / mmrSize)));
-			}
-		}
-	}
-
-	if (!kernels.empty())
+	uint64_t nextLeafIndex = 0;
+	while (kernelMMR.GetKernels(nextLeafIndex, 2000, kernels) > 0)
 	{
 		if (!KernelSignatureValidator::VerifyKernelSignatures(kernels))
 		{
 			return false;
 		}
+
+		nextLeafIndex += kernels.size();
+		kernels.clear();
+
+		syncStatus.UpdateProcessingStatus((uint8_t)(70 + ((30.0 * MMRUtil::GetPMMRIndex(nextLeafIndex)) / mmrSize)));
 	}
 
 	return true;
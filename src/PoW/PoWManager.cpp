@@ -16,4 +16,24 @@ bool PoWManager::IsPoWValid(const BlockHeader& header, const BlockHeader& previo
 	}
 
 	return PoWValidator(m_config, m_pBlockDB).IsPoWValid(header, previousHeader);
+}
+
+bool PoWManager::IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const
+{
+	if (m_config.GetEnvironment().IsAutomatedTesting())
+	{
+		return true;
+	}
+
+	return PoWValidator(m_config, m_pBlockDB).IsDifficultyValid(header, previousHeader);
+}
+
+bool PoWManager::IsCycleValid(const BlockHeader& header) const
+{
+	if (m_config.GetEnvironment().IsAutomatedTesting())
+	{
+		return true;
+	}
+
+	return PoWValidator(m_config, m_pBlockDB).IsCycleValid(header);
 }
\ No newline at end of file
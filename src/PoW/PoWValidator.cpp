@@ -17,6 +17,11 @@ PoWValidator::PoWValidator(const Config& config, std::shared_ptr<const IBlockDB>
 }
 
 bool PoWValidator::IsPoWValid(const BlockHeader& header, const BlockHeader& previousHeader) const
+{
+	return IsDifficultyValid(header, previousHeader) && IsCycleValid(header);
+}
+
+bool PoWValidator::IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const
 {
 	// Validate Total Difficulty
 	if (header.GetTotalDifficulty() <= previousHeader.GetTotalDifficulty())
@@ -47,6 +52,11 @@ bool PoWValidator::IsPoWValid(const BlockHeader& header, const BlockHeader& prev
 		return false;
 	}
 
+	return true;
+}
+
+bool PoWValidator::IsCycleValid(const BlockHeader& header) const
+{
 	const ProofOfWork& proofOfWork = header.GetProofOfWork();
 	const EPoWType powType = PoWUtil(m_config).DeterminePoWType(header.GetVersion(), proofOfWork.GetEdgeBits());
 	if (powType == EPoWType::CUCKAROO)
@@ -93,6 +93,22 @@ int ServerAPI::GetStatus_Handler(struct mg_connection* conn, void* pNodeContext)
 	const uint64_t headerHeight = pServer->m_pBlockChainServer->GetHeight(EChainType::CANDIDATE);
 	statusNode["header_height"] = headerHeight;
 
+	const PruningStats pruningStats = pServer->m_pBlockChainServer->GetPruningStats();
+	Json::Value pruningNode;
+	pruningNode["pruned_height"] = pruningStats.prunedHeight;
+	pruningNode["blocks_pruned"] = pruningStats.blocksPruned;
+	pruningNode["bytes_reclaimed"] = pruningStats.bytesReclaimed;
+	statusNode["pruning"] = pruningNode;
+
+	const OrphanPoolStats orphanStats = pServer->m_pBlockChainServer->GetOrphanPoolStats();
+	Json::Value orphansNode;
+	orphansNode["count"] = orphanStats.numOrphans;
+	orphansNode["bytes"] = orphanStats.numBytes;
+	orphansNode["max_bytes"] = orphanStats.maxBytes;
+	orphansNode["evicted"] = orphanStats.numEvicted;
+	orphansNode["rejected"] = orphanStats.numRejected;
+	statusNode["orphans"] = orphansNode;
+
 	return HTTPUtil::BuildSuccessResponse(conn, statusNode.toStyledString());
 }
 
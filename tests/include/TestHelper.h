@@ -6,12 +6,12 @@
 class TestHelper
 {
 public:
-	static ConfigPtr GetTestConfig()
+	static ConfigPtr GetTestConfig(const Json::Value& json = Json::Value())
 	{
 		ConfigPtr pConfig = Config::Default(EEnvironmentType::AUTOMATED_TESTING);
 
 		FileUtil::RemoveFile(pConfig->GetDataDirectory());
 
-		return Config::Default(EEnvironmentType::AUTOMATED_TESTING);
+		return Config::Load(json, EEnvironmentType::AUTOMATED_TESTING);
 	}
 };
\ No newline at end of file
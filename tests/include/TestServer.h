@@ -15,9 +15,8 @@ class TestServer
 public:
 	using Ptr = std::shared_ptr<TestServer>;
 
-	static TestServer::Ptr Create()
+	static TestServer::Ptr Create(const ConfigPtr& pConfig = TestHelper::GetTestConfig())
 	{
-		ConfigPtr pConfig = TestHelper::GetTestConfig();
 		IDatabasePtr pDatabase = DatabaseAPI::OpenDatabase(*pConfig);
 		auto pTxHashSetManager = std::make_shared<Locked<TxHashSetManager>>(std::make_shared<TxHashSetManager>(*pConfig));
 		ITransactionPoolPtr pTxPool = TxPoolAPI::CreateTransactionPool(*pConfig);
@@ -0,0 +1,78 @@
+#include <catch.hpp>
+
+#include <TestServer.h>
+#include <TestChain.h>
+#include <TxBuilder.h>
+
+#include <BlockChain/BlockPruner.h>
+#include <Config/ConfigProps.h>
+#include <Consensus/BlockTime.h>
+
+static Json::Value CreatePruningJSON(const uint32_t marginBlocks, const uint32_t batchSize)
+{
+	Json::Value pruningJSON;
+	pruningJSON[ConfigProps::Pruning::ENABLED] = true;
+	pruningJSON[ConfigProps::Pruning::MARGIN_BLOCKS] = marginBlocks;
+	pruningJSON[ConfigProps::Pruning::BATCH_SIZE] = batchSize;
+
+	Json::Value json;
+	json[ConfigProps::Pruning::PRUNING] = pruningJSON;
+	return json;
+}
+
+TEST_CASE("BlockPruner::GetNextBatch - Horizon boundary")
+{
+	const PruningConfig config(CreatePruningJSON(10, 100));
+	const uint64_t horizon = Consensus::CUT_THROUGH_HORIZON;
+
+	// Nothing is prunable until the chain is more than a horizon plus the margin tall.
+	REQUIRE_FALSE(BlockPruner::GetNextBatch(config, 5, 0).has_value());
+	REQUIRE_FALSE(BlockPruner::GetNextBatch(config, horizon, 0).has_value());
+	REQUIRE_FALSE(BlockPruner::GetNextBatch(config, horizon + 10, 0).has_value());
+
+	// One block past the boundary makes exactly the first block prunable.
+	REQUIRE(BlockPruner::GetNextBatch(config, horizon + 11, 0) == std::make_pair<uint64_t, uint64_t>(1, 1));
+	REQUIRE_FALSE(BlockPruner::GetNextBatch(config, horizon + 11, 1).has_value());
+
+	// Batches are capped at the batch size, and the last one ends right at the boundary.
+	const uint64_t confirmedHeight = horizon + 10 + 250;
+	REQUIRE(BlockPruner::GetNextBatch(config, confirmedHeight, 0) == std::make_pair<uint64_t, uint64_t>(1, 100));
+	REQUIRE(BlockPruner::GetNextBatch(config, confirmedHeight, 200) == std::make_pair<uint64_t, uint64_t>(201, 250));
+	REQUIRE_FALSE(BlockPruner::GetNextBatch(config, confirmedHeight, 250).has_value());
+}
+
+TEST_CASE("BlockPruner - GetStats")
+{
+	SECTION("Disabled")
+	{
+		TestServer::Ptr pTestServer = TestServer::Create();
+
+		const PruningStats stats = pTestServer->GetBlockChainServer()->GetPruningStats();
+		REQUIRE(stats.prunedHeight == 0);
+		REQUIRE(stats.blocksPruned == 0);
+		REQUIRE(stats.bytesReclaimed == 0);
+	}
+
+	SECTION("Enabled")
+	{
+		// Resumes from the height persisted by a previous run.
+		ConfigPtr pConfig = TestHelper::GetTestConfig(CreatePruningJSON(0, 100));
+		FileUtil::WriteTextToFile(pConfig->GetNodeConfig().GetChainPath() / "pruned_height.txt", "42");
+
+		TestServer::Ptr pTestServer = TestServer::Create(pConfig);
+		KeyChain keyChain = KeyChain::FromRandom(*pTestServer->GetConfig());
+		TxBuilder txBuilder(keyChain);
+		auto pBlockChainServer = pTestServer->GetBlockChainServer();
+
+		TestChain chain(pTestServer, keyChain);
+		MinedBlock block_a = chain.AddNextBlock({ txBuilder.BuildCoinbaseTx(KeyChainPath({ 0, 1 })) });
+		REQUIRE(pBlockChainServer->AddBlock(block_a.block) == EBlockChainStatus::SUCCESS);
+
+		// The chain is nowhere near the horizon, so nothing new is pruned.
+		const PruningStats stats = pBlockChainServer->GetPruningStats();
+		REQUIRE(stats.prunedHeight == 42);
+		REQUIRE(stats.blocksPruned == 0);
+		REQUIRE(stats.bytesReclaimed == 0);
+		REQUIRE(pBlockChainServer->GetBlockByHash(block_a.block.GetHash()) != nullptr);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <catch.hpp>
+
+#include <Config/Config.h>
+#include <PoW/PoWManager.h>
+
+static BlockHeader WithNonce(const BlockHeader& header, const uint64_t nonce)
+{
+	return BlockHeader(
+		header.GetVersion(),
+		header.GetHeight(),
+		header.GetTimestamp(),
+		Hash(header.GetPreviousHash()),
+		Hash(header.GetPreviousRoot()),
+		Hash(header.GetOutputRoot()),
+		Hash(header.GetRangeProofRoot()),
+		Hash(header.GetKernelRoot()),
+		BlindingFactor(header.GetTotalKernelOffset()),
+		header.GetOutputMMRSize(),
+		header.GetKernelMMRSize(),
+		header.GetTotalDifficulty(),
+		header.GetScalingDifficulty(),
+		nonce,
+		ProofOfWork(header.GetProofOfWork())
+	);
+}
+
+//
+// Header sync checks cycles up front (in parallel, out of order) and the difficulty later, once the previous headers are known.
+// Each check must catch what it's responsible for without relying on the other.
+//
+TEST_CASE("PoW - Cycle and difficulty are validated separately")
+{
+	// Automated testing skips PoW validation, so use the real mainnet genesis header.
+	ConfigPtr pConfig = Config::Default(EEnvironmentType::MAINNET);
+	const BlockHeaderPtr& pGenesis = pConfig->GetEnvironment().GetGenesisHeader();
+
+	// Neither check below reads the previous headers from the block DB.
+	const PoWManager powManager(*pConfig, nullptr);
+
+	SECTION("Valid cycle, invalid difficulty")
+	{
+		REQUIRE(powManager.IsCycleValid(*pGenesis));
+
+		// Total difficulty doesn't increase, which fails before the block DB is needed.
+		REQUIRE_FALSE(powManager.IsDifficultyValid(*pGenesis, *pGenesis));
+		REQUIRE_FALSE(powManager.IsPoWValid(*pGenesis, *pGenesis));
+	}
+
+	SECTION("Invalid cycle")
+	{
+		// The nonce is part of the pre-PoW, so changing it invalidates the cycle without changing the difficulty.
+		const BlockHeader tampered = WithNonce(*pGenesis, pGenesis->GetNonce() + 1);
+		REQUIRE(tampered.GetTotalDifficulty() == pGenesis->GetTotalDifficulty());
+		REQUIRE_FALSE(powManager.IsCycleValid(tampered));
+	}
+}
\ No newline at end of file
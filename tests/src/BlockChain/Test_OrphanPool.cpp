@@ -0,0 +1,218 @@
+#include <catch.hpp>
+
+#include <BlockChain/OrphanPool/OrphanPool.h>
+
+// The block hash only covers the proof of work, so each block gets its own proof nonces.
+// Kernels are only added to control the block's size; they're never validated by the pool.
+static FullBlock CreateBlock(const uint64_t height, const size_t numKernels = 0)
+{
+	static uint64_t nextProofNonce = 1;
+
+	std::vector<uint64_t> proofNonces(42, 0);
+	proofNonces[0] = nextProofNonce++;
+
+	auto pHeader = std::make_shared<BlockHeader>(
+		(uint16_t)2,
+		height,
+		(int64_t)height * 60,
+		Hash::ValueOf((unsigned char)height),
+		Hash(),
+		Hash(),
+		Hash(),
+		Hash(),
+		BlindingFactor(Hash()),
+		0,
+		0,
+		height,
+		1,
+		0,
+		ProofOfWork(29, std::move(proofNonces))
+	);
+
+	std::vector<TransactionKernel> kernels;
+	for (size_t i = 0; i < numKernels; i++)
+	{
+		kernels.emplace_back(TransactionKernel(EKernelFeatures::DEFAULT_KERNEL, 0, 0, Commitment(), Signature(CBigInteger<64>())));
+	}
+
+	return FullBlock(pHeader, TransactionBody({}, {}, std::move(kernels)));
+}
+
+static const uint64_t CONFIRMED_HEIGHT = 10; // So the next block to be confirmed is at height 11.
+
+TEST_CASE("OrphanPool - Evicts furthest from the chain first")
+{
+	const uint64_t blockSize = CreateBlock(0).GetSerializedSize();
+	OrphanPool orphanPool(4 * blockSize, 4 * blockSize);
+
+	const FullBlock block12 = CreateBlock(12);
+	const FullBlock block13 = CreateBlock(13);
+	const FullBlock block20 = CreateBlock(20);
+	const FullBlock block9 = CreateBlock(9);
+	for (const FullBlock& block : { block12, block13, block20, block9 })
+	{
+		REQUIRE(orphanPool.AddOrphanBlock(block, CONFIRMED_HEIGHT));
+	}
+
+	// Height 9 is at or below the confirmed height, so it can never connect.
+	const FullBlock block11 = CreateBlock(11);
+	REQUIRE(orphanPool.AddOrphanBlock(block11, CONFIRMED_HEIGHT));
+	REQUIRE_FALSE(orphanPool.IsOrphan(9, block9.GetHash()));
+
+	// Height 20 is the furthest from 11.
+	const FullBlock block11b = CreateBlock(11);
+	REQUIRE(orphanPool.AddOrphanBlock(block11b, CONFIRMED_HEIGHT));
+	REQUIRE_FALSE(orphanPool.IsOrphan(20, block20.GetHash()));
+	REQUIRE(orphanPool.IsOrphan(13, block13.GetHash()));
+
+	const FullBlock block12b = CreateBlock(12);
+	REQUIRE(orphanPool.AddOrphanBlock(block12b, CONFIRMED_HEIGHT));
+	REQUIRE_FALSE(orphanPool.IsOrphan(13, block13.GetHash()));
+
+	// Among orphans at the same height, the oldest goes first.
+	const FullBlock block12c = CreateBlock(12);
+	REQUIRE(orphanPool.AddOrphanBlock(block12c, CONFIRMED_HEIGHT));
+	REQUIRE_FALSE(orphanPool.IsOrphan(12, block12.GetHash()));
+
+	for (const FullBlock& block : { block11, block11b, block12b, block12c })
+	{
+		REQUIRE(orphanPool.IsOrphan(block.GetHeight(), block.GetHash()));
+	}
+
+	const OrphanPoolStats stats = orphanPool.GetStats();
+	REQUIRE(stats.numOrphans == 4);
+	REQUIRE(stats.numEvicted == 4);
+	REQUIRE(stats.numRejected == 0);
+	REQUIRE(stats.numBytes == 4 * blockSize);
+}
+
+TEST_CASE("OrphanPool - Evicts stale orphans first as the chain moves")
+{
+	const uint64_t blockSize = CreateBlock(0).GetSerializedSize();
+	OrphanPool orphanPool(3 * blockSize, 3 * blockSize);
+
+	// Height 1 is further from 11 than height 30 is, but it's below the confirmed height, so it goes first.
+	const FullBlock block1 = CreateBlock(1);
+	const FullBlock block12 = CreateBlock(12);
+	const FullBlock block30 = CreateBlock(30);
+	for (const FullBlock& block : { block1, block12, block30 })
+	{
+		REQUIRE(orphanPool.AddOrphanBlock(block, CONFIRMED_HEIGHT));
+	}
+
+	const FullBlock block13 = CreateBlock(13);
+	REQUIRE(orphanPool.AddOrphanBlock(block13, CONFIRMED_HEIGHT));
+	REQUIRE_FALSE(orphanPool.IsOrphan(1, block1.GetHash()));
+
+	// Once the chain reaches height 12, the orphan there is stale, so it goes before height 30.
+	const FullBlock block14 = CreateBlock(14);
+	REQUIRE(orphanPool.AddOrphanBlock(block14, 12));
+	REQUIRE_FALSE(orphanPool.IsOrphan(12, block12.GetHash()));
+	REQUIRE(orphanPool.IsOrphan(30, block30.GetHash()));
+
+	// If the chain is rewound, the orphans above it are live again, and height 30 is the furthest.
+	const FullBlock block11 = CreateBlock(11);
+	REQUIRE(orphanPool.AddOrphanBlock(block11, CONFIRMED_HEIGHT));
+	REQUIRE_FALSE(orphanPool.IsOrphan(30, block30.GetHash()));
+
+	for (const FullBlock& block : { block11, block13, block14 })
+	{
+		REQUIRE(orphanPool.IsOrphan(block.GetHeight(), block.GetHash()));
+	}
+
+	REQUIRE(orphanPool.GetStats().numEvicted == 3);
+}
+
+TEST_CASE("OrphanPool - Rejects blocks further than everything in the pool")
+{
+	const uint64_t blockSize = CreateBlock(0).GetSerializedSize();
+	OrphanPool orphanPool(2 * blockSize, 2 * blockSize);
+
+	const FullBlock block12 = CreateBlock(12);
+	const FullBlock block13 = CreateBlock(13);
+	REQUIRE(orphanPool.AddOrphanBlock(block12, CONFIRMED_HEIGHT));
+	REQUIRE(orphanPool.AddOrphanBlock(block13, CONFIRMED_HEIGHT));
+
+	const FullBlock block20 = CreateBlock(20);
+	REQUIRE_FALSE(orphanPool.AddOrphanBlock(block20, CONFIRMED_HEIGHT));
+	REQUIRE_FALSE(orphanPool.IsOrphan(20, block20.GetHash()));
+
+	// Blocks bigger than the whole pool are turned away without evicting anything.
+	const FullBlock hugeBlock = CreateBlock(11, 100);
+	REQUIRE(hugeBlock.GetSerializedSize() > 2 * blockSize);
+	REQUIRE_FALSE(orphanPool.AddOrphanBlock(hugeBlock, CONFIRMED_HEIGHT));
+
+	REQUIRE(orphanPool.IsOrphan(12, block12.GetHash()));
+	REQUIRE(orphanPool.IsOrphan(13, block13.GetHash()));
+
+	const OrphanPoolStats stats = orphanPool.GetStats();
+	REQUIRE(stats.numEvicted == 0);
+	REQUIRE(stats.numRejected == 2);
+}
+
+TEST_CASE("OrphanPool - Per-source quota")
+{
+	const uint64_t blockSize = CreateBlock(0).GetSerializedSize();
+	OrphanPool orphanPool(4 * blockSize, 2 * blockSize);
+
+	const FullBlock block30 = CreateBlock(30);
+	const FullBlock block12 = CreateBlock(12);
+	const FullBlock block15 = CreateBlock(15);
+	REQUIRE(orphanPool.AddOrphanBlock(block30, CONFIRMED_HEIGHT, "B"));
+	REQUIRE(orphanPool.AddOrphanBlock(block12, CONFIRMED_HEIGHT, "A"));
+	REQUIRE(orphanPool.AddOrphanBlock(block15, CONFIRMED_HEIGHT, "A"));
+
+	// A is at its quota, so its own furthest orphan is evicted, even though B's is further and the pool has room.
+	const FullBlock block13 = CreateBlock(13);
+	REQUIRE(orphanPool.AddOrphanBlock(block13, CONFIRMED_HEIGHT, "A"));
+	REQUIRE_FALSE(orphanPool.IsOrphan(15, block15.GetHash()));
+	REQUIRE(orphanPool.IsOrphan(30, block30.GetHash()));
+
+	// A can't push out its own closer orphans to make room for a further one.
+	const FullBlock block14 = CreateBlock(14);
+	REQUIRE_FALSE(orphanPool.AddOrphanBlock(block14, CONFIRMED_HEIGHT, "A"));
+
+	// Blocks without a source have no quota.
+	const FullBlock block16 = CreateBlock(16);
+	REQUIRE(orphanPool.AddOrphanBlock(block16, CONFIRMED_HEIGHT));
+
+	for (const FullBlock& block : { block30, block12, block13, block16 })
+	{
+		REQUIRE(orphanPool.IsOrphan(block.GetHeight(), block.GetHash()));
+	}
+
+	const OrphanPoolStats stats = orphanPool.GetStats();
+	REQUIRE(stats.numEvicted == 1);
+	REQUIRE(stats.numRejected == 1);
+}
+
+TEST_CASE("OrphanPool - Rejected blocks don't evict anything")
+{
+	const uint64_t smallSize = CreateBlock(0).GetSerializedSize();
+	const uint64_t largeSize = CreateBlock(0, 20).GetSerializedSize();
+	REQUIRE(largeSize > smallSize);
+
+	// Full, with A's small orphan furthest from the chain.
+	OrphanPool orphanPool(smallSize + 2 * largeSize, largeSize);
+	const FullBlock block20 = CreateBlock(20);
+	const FullBlock block12 = CreateBlock(12, 20);
+	const FullBlock block12b = CreateBlock(12, 20);
+	REQUIRE(orphanPool.AddOrphanBlock(block20, CONFIRMED_HEIGHT, "A"));
+	REQUIRE(orphanPool.AddOrphanBlock(block12, CONFIRMED_HEIGHT, "B"));
+	REQUIRE(orphanPool.AddOrphanBlock(block12b, CONFIRMED_HEIGHT, "C"));
+
+	// Evicting A's orphan would be enough for A's quota, but not for the pool,
+	// and everything else is closer than the new block, so it's rejected and A's orphan stays.
+	const FullBlock block15 = CreateBlock(15, 20);
+	REQUIRE_FALSE(orphanPool.AddOrphanBlock(block15, CONFIRMED_HEIGHT, "A"));
+
+	for (const FullBlock& block : { block20, block12, block12b })
+	{
+		REQUIRE(orphanPool.IsOrphan(block.GetHeight(), block.GetHash()));
+	}
+
+	const OrphanPoolStats stats = orphanPool.GetStats();
+	REQUIRE(stats.numEvicted == 0);
+	REQUIRE(stats.numRejected == 1);
+	REQUIRE(stats.numBytes == smallSize + 2 * largeSize);
+}
\ No newline at end of file
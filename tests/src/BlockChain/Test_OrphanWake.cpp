@@ -0,0 +1,95 @@
+#include <catch.hpp>
+
+#include <TestServer.h>
+#include <TestChain.h>
+#include <TxBuilder.h>
+
+#include <BlockChain/BlockChainServer.h>
+#include <chrono>
+
+// Long enough that a wait only finishes early if the chain signals it.
+static const std::chrono::milliseconds WAKE_TIMEOUT = std::chrono::seconds(10);
+
+static std::chrono::milliseconds TimeWait(IBlockChainServer* pBlockChainServer, const std::chrono::milliseconds& timeout, bool& ready)
+{
+	const auto start = std::chrono::steady_clock::now();
+	ready = pBlockChainServer->WaitForOrphanBlock(timeout);
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+}
+
+//
+// a - b
+//
+// 1. header_a, header_b
+// 2. block_b (orphan, missing parent)
+// 3. block_a (wakes the orphan processor)
+//
+TEST_CASE("Orphan wake - parent applied")
+{
+	TestServer::Ptr pTestServer = TestServer::Create();
+	KeyChain keyChain = KeyChain::FromRandom(*pTestServer->GetConfig());
+	TxBuilder txBuilder(keyChain);
+	auto pBlockChainServer = pTestServer->GetBlockChainServer();
+
+	TestChain chain(pTestServer, keyChain);
+	MinedBlock block_a = chain.AddNextBlock({ txBuilder.BuildCoinbaseTx(KeyChainPath({ 0, 1 })) });
+	MinedBlock block_b = chain.AddNextBlock({ txBuilder.BuildCoinbaseTx(KeyChainPath({ 0, 2 })) });
+
+	bool ready = false;
+
+	// Nothing has been signalled, so the wait times out.
+	TimeWait(pBlockChainServer, std::chrono::milliseconds(10), ready);
+	REQUIRE_FALSE(ready);
+
+	REQUIRE(pBlockChainServer->AddBlockHeaders({ block_a.block.GetHeader(), block_b.block.GetHeader() }) == EBlockChainStatus::SUCCESS);
+	REQUIRE(pBlockChainServer->AddBlock(block_b.block) == EBlockChainStatus::ORPHANED);
+	REQUIRE(pBlockChainServer->AddBlock(block_a.block) == EBlockChainStatus::SUCCESS);
+
+	REQUIRE(TimeWait(pBlockChainServer, WAKE_TIMEOUT, ready) < WAKE_TIMEOUT / 2);
+	REQUIRE(ready);
+
+	REQUIRE(pBlockChainServer->ProcessNextOrphanBlock());
+	REQUIRE(pBlockChainServer->GetHeight(EChainType::CONFIRMED) == 2);
+	REQUIRE(pBlockChainServer->GetTipBlockHeader(EChainType::CONFIRMED)->GetHash() == block_b.block.GetHash());
+}
+
+//
+// a - b - c
+//
+// 1. block_a
+// 2. block_c (orphan, missing parent and header)
+// 3. block_b (orphan can't connect, since header_c isn't on the candidate chain)
+// 4. header_c (wakes the orphan processor)
+//
+TEST_CASE("Orphan wake - header added")
+{
+	TestServer::Ptr pTestServer = TestServer::Create();
+	KeyChain keyChain = KeyChain::FromRandom(*pTestServer->GetConfig());
+	TxBuilder txBuilder(keyChain);
+	auto pBlockChainServer = pTestServer->GetBlockChainServer();
+
+	TestChain chain(pTestServer, keyChain);
+	MinedBlock block_a = chain.AddNextBlock({ txBuilder.BuildCoinbaseTx(KeyChainPath({ 0, 1 })) });
+	MinedBlock block_b = chain.AddNextBlock({ txBuilder.BuildCoinbaseTx(KeyChainPath({ 0, 2 })) });
+	MinedBlock block_c = chain.AddNextBlock({ txBuilder.BuildCoinbaseTx(KeyChainPath({ 0, 3 })) });
+
+	REQUIRE(pBlockChainServer->AddBlock(block_a.block) == EBlockChainStatus::SUCCESS);
+	REQUIRE(pBlockChainServer->AddBlock(block_c.block) == EBlockChainStatus::ORPHANED);
+	REQUIRE(pBlockChainServer->AddBlock(block_b.block) == EBlockChainStatus::SUCCESS);
+
+	// block_c is queued but can't connect yet, so nothing is signalled and the wait times out.
+	bool ready = false;
+	const auto timeout = std::chrono::milliseconds(200);
+	REQUIRE(TimeWait(pBlockChainServer, timeout, ready) >= timeout);
+	REQUIRE_FALSE(ready);
+	REQUIRE_FALSE(pBlockChainServer->ProcessNextOrphanBlock());
+
+	REQUIRE(pBlockChainServer->AddBlockHeader(block_c.block.GetHeader()) == EBlockChainStatus::SUCCESS);
+
+	REQUIRE(TimeWait(pBlockChainServer, WAKE_TIMEOUT, ready) < WAKE_TIMEOUT / 2);
+	REQUIRE(ready);
+
+	REQUIRE(pBlockChainServer->ProcessNextOrphanBlock());
+	REQUIRE(pBlockChainServer->GetHeight(EChainType::CONFIRMED) == 3);
+	REQUIRE(pBlockChainServer->GetTipBlockHeader(EChainType::CONFIRMED)->GetHash() == block_c.block.GetHash());
+}
\ No newline at end of file
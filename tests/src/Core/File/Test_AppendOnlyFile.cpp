@@ -0,0 +1,60 @@
+#include <catch.hpp>
+
+#include <Core/File/AppendOnlyFile.h>
+#include <Core/File/FileRemover.h>
+
+TEST_CASE("AppendOnlyFile::GetView")
+{
+	const fs::path path = fs::temp_directory_path() / "append_only_view.bin";
+	FileUtil::RemoveFile(path);
+	FileRemover remover(path);
+
+	{
+		AppendOnlyFile file(path);
+		file.Load();
+		file.Append({ 1, 2, 3, 4 });
+		REQUIRE(file.Flush());
+
+		// Committed bytes are returned straight from the mapping.
+		const unsigned char* pView = file.GetView(1, 3);
+		REQUIRE(pView != nullptr);
+		REQUIRE(std::vector<unsigned char>(pView, pView + 3) == std::vector<unsigned char>({ 2, 3, 4 }));
+
+		// Ranges touching pending bytes have no view.
+		file.Append({ 5, 6 });
+		REQUIRE(file.GetView(2, 3) == nullptr);
+		REQUIRE(file.GetView(4, 1) == nullptr);
+		REQUIRE(file.GetView(0, 4) != nullptr);
+
+		// Rewound bytes are no longer visible, even though they're still mapped.
+		REQUIRE(file.Rewind(2));
+		REQUIRE(file.GetView(0, 3) == nullptr);
+		REQUIRE(file.GetView(0, 2) != nullptr);
+	}
+}
+
+TEST_CASE("AppendOnlyFile::Flush after WriteAhead")
+{
+	const fs::path path = fs::temp_directory_path() / "append_only_write_ahead.bin";
+	FileUtil::RemoveFile(path);
+	FileRemover remover(path);
+
+	AppendOnlyFile file(path);
+	file.Load();
+	file.Append({ 1, 2 });
+	REQUIRE(file.Flush());
+
+	file.Append({ 3, 4 });
+
+	CommitJournal journal;
+	file.Journal(journal);
+	journal.WriteAhead();
+
+	// The appends are already on disk, so Flush must not write them again.
+	REQUIRE(file.Flush());
+	REQUIRE(file.GetSize() == 4);
+
+	std::vector<unsigned char> bytes;
+	REQUIRE(FileUtil::ReadFile(path, bytes));
+	REQUIRE(bytes == std::vector<unsigned char>({ 1, 2, 3, 4 }));
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+
+#include <Core/File/CommitJournal.h>
+
+TEST_CASE("CommitJournal::Apply")
+{
+	const fs::path appendPath = fs::temp_directory_path() / "journal_append.bin";
+	const fs::path bitmapPath = fs::temp_directory_path() / "journal_bitmap.bin";
+	FileUtil::SafeWriteToFile(appendPath, { 1, 2, 3, 4, 5 });
+	FileUtil::SafeWriteToFile(bitmapPath, { 0, 0, 0, 0 });
+
+	CommitJournal journal;
+	journal.AddAppend(appendPath, 3, { 9, 9 });
+	journal.AddWrite(bitmapPath, 1, { 0xff, 0x0f });
+	journal.AddWrite(bitmapPath, 5, { 0x80 });
+	REQUIRE(journal.GetNumWrites() == 3);
+	REQUIRE_FALSE(journal.HasWritesAhead());
+	REQUIRE(journal.HasPostCommitWrites());
+
+	// Replaying the same journal more than once must produce the same files.
+	const std::vector<unsigned char> serialized = journal.Serialized();
+	ByteBuffer byteBuffer(serialized);
+	CommitJournal deserialized = CommitJournal::Deserialize(byteBuffer);
+	deserialized.Apply();
+	deserialized.Apply();
+
+	std::vector<unsigned char> appendBytes;
+	REQUIRE(FileUtil::ReadFile(appendPath, appendBytes));
+	REQUIRE(appendBytes == std::vector<unsigned char>({ 1, 2, 3, 9, 9 }));
+
+	std::vector<unsigned char> bitmapBytes;
+	REQUIRE(FileUtil::ReadFile(bitmapPath, bitmapBytes));
+	REQUIRE(bitmapBytes == std::vector<unsigned char>({ 0, 0xff, 0x0f, 0, 0, 0x80 }));
+
+	FileUtil::RemoveFile(appendPath);
+	FileUtil::RemoveFile(bitmapPath);
+}
+
+TEST_CASE("CommitJournal::WriteAhead")
+{
+	const fs::path path = fs::temp_directory_path() / "journal_write_ahead.bin";
+	FileUtil::SafeWriteToFile(path, { 1, 2, 3 });
+
+	CommitJournal journal;
+	journal.AddWriteAhead(path, 3, { 4, 5 });
+	REQUIRE(journal.HasWritesAhead());
+	REQUIRE_FALSE(journal.HasPostCommitWrites());
+
+	// Appends written ahead are never serialized, only their sizes.
+	const std::vector<unsigned char> serialized = journal.Serialized();
+	ByteBuffer byteBuffer(serialized);
+	CommitJournal deserialized = CommitJournal::Deserialize(byteBuffer);
+
+	journal.WriteAhead();
+
+	std::vector<unsigned char> bytes;
+	REQUIRE(FileUtil::ReadFile(path, bytes));
+	REQUIRE(bytes == std::vector<unsigned char>({ 1, 2, 3, 4, 5 }));
+
+	// Bytes left beyond the committed size (ie. by a later, interrupted write-ahead) are truncated by Apply.
+	journal.AddWriteAhead(path, 5, { 6 });
+	journal.WriteAhead();
+	deserialized.Apply();
+	REQUIRE(FileUtil::ReadFile(path, bytes));
+	REQUIRE(bytes == std::vector<unsigned char>({ 1, 2, 3, 4, 5 }));
+
+	// A commit that never happened is undone by Revert, any number of times.
+	deserialized.Revert();
+	deserialized.Revert();
+	REQUIRE(FileUtil::ReadFile(path, bytes));
+	REQUIRE(bytes == std::vector<unsigned char>({ 1, 2, 3 }));
+
+	// Applying a journal whose written-ahead bytes are missing must fail, rather than silently lose them.
+	REQUIRE_THROWS_AS(deserialized.Apply(), FileException);
+
+	FileUtil::RemoveFile(path);
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include <catch.hpp>
+
+#include <Core/File/DataFile.h>
+#include <Core/File/FileRemover.h>
+
+TEST_CASE("DataFile::GetDataRange")
+{
+	const fs::path path = fs::temp_directory_path() / "data_range.bin";
+	FileUtil::RemoveFile(path);
+	FileRemover remover(path);
+
+	auto pDataFile = DataFile<2>::Load(path);
+	pDataFile->AddData({ 0, 1 });
+	pDataFile->AddData({ 2, 3 });
+	pDataFile->Commit();
+
+	// Pending entries are read from the buffer, and ranges can span both the committed file and the buffer.
+	pDataFile->AddData({ 4, 5 });
+	pDataFile->AddData({ 6, 7 });
+
+	std::vector<unsigned char> data;
+	pDataFile->GetDataRange(0, 4, data);
+	REQUIRE(data == std::vector<unsigned char>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+
+	pDataFile->GetDataRange(1, 2, data);
+	REQUIRE(data == std::vector<unsigned char>({ 2, 3, 4, 5 }));
+
+	pDataFile->GetDataRange(3, 1, data);
+	REQUIRE(data == std::vector<unsigned char>({ 6, 7 }));
+
+	REQUIRE_THROWS_AS(pDataFile->GetDataRange(3, 2, data), FileException);
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include <catch.hpp>
+
+#include <Core/Serialization/Serializer.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Models/Transaction.h>
+#include <Config/Genesis.h>
+
+TEST_CASE("Serializer::Append")
+{
+	Serializer serializer;
+	serializer.Append<uint8_t>(0x01);
+	serializer.Append<uint16_t>(0x0203);
+	serializer.Append<uint32_t>(0x04050607);
+	serializer.Append<uint64_t>(0x08090A0B0C0D0E0FULL);
+	serializer.Append<int64_t>(-2);
+	serializer.AppendLittleEndian<uint32_t>(0x04050607);
+
+	const std::vector<unsigned char> expected = {
+		0x01,
+		0x02, 0x03,
+		0x04, 0x05, 0x06, 0x07,
+		0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+		0x07, 0x06, 0x05, 0x04
+	};
+	REQUIRE(serializer.GetBytes() == expected);
+
+	ByteBuffer byteBuffer(serializer.GetBytes());
+	REQUIRE(byteBuffer.ReadU8() == 0x01);
+	REQUIRE(byteBuffer.ReadU16() == 0x0203);
+	REQUIRE(byteBuffer.ReadU32() == 0x04050607);
+	REQUIRE(byteBuffer.ReadU64() == 0x08090A0B0C0D0E0FULL);
+	REQUIRE(byteBuffer.Read64() == -2);
+}
+
+TEST_CASE("Serializer - Caller-provided buffer")
+{
+	std::vector<unsigned char> buffer;
+	buffer.reserve(64);
+	buffer.push_back(0xAA);
+	const unsigned char* pData = buffer.data();
+
+	Serializer serializer(std::move(buffer));
+	serializer.Append<uint32_t>(1);
+
+	std::vector<unsigned char> released = serializer.Release();
+	REQUIRE(released == std::vector<unsigned char>({ 0xAA, 0x00, 0x00, 0x00, 0x01 }));
+	REQUIRE(released.data() == pData);
+	REQUIRE(serializer.size() == 0);
+}
+
+TEST_CASE("GetSerializedSize")
+{
+	for (const FullBlock& block : { Genesis::MAINNET_GENESIS, Genesis::FLOONET_GENESIS })
+	{
+		Serializer serializer;
+		block.Serialize(serializer);
+		REQUIRE(block.GetSerializedSize() == serializer.size());
+		REQUIRE(block.GetHeader()->GetSerializedSize() == block.GetHeader()->Serialized().size());
+
+		const Transaction transaction(BlindingFactor(Hash::ValueOf(1)), TransactionBody(block.GetTransactionBody()));
+		Serializer txSerializer;
+		transaction.Serialize(txSerializer);
+		REQUIRE(transaction.GetSerializedSize() == txSerializer.size());
+	}
+}
\ No newline at end of file
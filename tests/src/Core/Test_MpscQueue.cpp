@@ -0,0 +1,92 @@
+#include <catch.hpp>
+
+#include <Common/MpscQueue.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE("MpscQueue is bounded and FIFO")
+{
+	MpscQueue<std::unique_ptr<int>> queue(3);
+	REQUIRE(queue.capacity() == 4);
+
+	for (int i = 0; i < 4; i++)
+	{
+		REQUIRE(queue.try_push(std::make_unique<int>(i)));
+	}
+
+	// Full, so the item is left with the caller.
+	std::unique_ptr<int> pExtra = std::make_unique<int>(4);
+	REQUIRE_FALSE(queue.try_push(std::move(pExtra)));
+	REQUIRE(pExtra != nullptr);
+
+	std::unique_ptr<int> pItem;
+	for (int i = 0; i < 4; i++)
+	{
+		REQUIRE(queue.try_pop(pItem));
+		REQUIRE(*pItem == i);
+	}
+
+	REQUIRE_FALSE(queue.try_pop(pItem));
+	REQUIRE(queue.try_push(std::move(pExtra)));
+	REQUIRE(queue.try_pop(pItem));
+	REQUIRE(*pItem == 4);
+}
+
+TEST_CASE("MpscQueue multiple producers")
+{
+	const size_t numProducers = 4;
+	const size_t itemsPerProducer = 20000;
+
+	MpscQueue<std::pair<size_t, size_t>> queue(64);
+
+	std::vector<std::thread> producers;
+	for (size_t producer = 0; producer < numProducers; producer++)
+	{
+		producers.emplace_back([&queue, producer, itemsPerProducer] {
+			for (size_t i = 0; i < itemsPerProducer; i++)
+			{
+				std::pair<size_t, size_t> item(producer, i);
+				while (!queue.try_push(std::move(item)))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	// Each producer's items must arrive exactly once, in the order they were pushed.
+	std::vector<size_t> nextExpected(numProducers, 0);
+	size_t numReceived = 0;
+	while (numReceived < numProducers * itemsPerProducer)
+	{
+		std::pair<size_t, size_t> item;
+		REQUIRE(queue.wait_pop(item, std::chrono::seconds(10)));
+		REQUIRE(item.second == nextExpected[item.first]);
+		nextExpected[item.first]++;
+		numReceived++;
+	}
+
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+}
+
+TEST_CASE("MpscQueue close wakes the consumer")
+{
+	MpscQueue<int> queue(8);
+
+	std::thread closer([&queue] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		queue.close();
+	});
+
+	const auto start = std::chrono::steady_clock::now();
+	int item = 0;
+	REQUIRE_FALSE(queue.wait_pop(item, std::chrono::seconds(10)));
+	REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+	REQUIRE_FALSE(queue.try_push(1));
+
+	closer.join();
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <catch.hpp>
+
+#include <Common/WorkStealingPool.h>
+#include <chrono>
+#include <set>
+
+TEST_CASE("WorkStealingPool runs every task")
+{
+	std::atomic<size_t> numRun = 0;
+	std::mutex mutex;
+	std::condition_variable done;
+
+	const size_t numTasks = 1000;
+	{
+		WorkStealingPool pool(4);
+		REQUIRE(pool.GetNumThreads() == 4);
+
+		for (size_t i = 0; i < numTasks; i++)
+		{
+			pool.Submit([&] {
+				if (++numRun == numTasks)
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					done.notify_all();
+				}
+			});
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		REQUIRE(done.wait_for(lock, std::chrono::seconds(10), [&] { return numRun == numTasks; }));
+	}
+
+	REQUIRE(numRun == numTasks);
+}
+
+TEST_CASE("WorkStealingPool idle workers steal")
+{
+	// All tasks are submitted from a single worker, so they land in its deque.
+	// They block until several threads are running them at once, which requires the other workers to steal.
+	const size_t numThreads = 4;
+	WorkStealingPool pool(numThreads);
+
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::set<std::thread::id> threadIds;
+	size_t numFinished = 0;
+
+	pool.Submit([&] {
+		for (size_t i = 0; i < numThreads; i++)
+		{
+			pool.Submit([&] {
+				std::unique_lock<std::mutex> lock(mutex);
+				threadIds.insert(std::this_thread::get_id());
+				changed.notify_all();
+				changed.wait_for(lock, std::chrono::seconds(10), [&] { return threadIds.size() >= 2; });
+				numFinished++;
+				changed.notify_all();
+			});
+		}
+	});
+
+	std::unique_lock<std::mutex> lock(mutex);
+	REQUIRE(changed.wait_for(lock, std::chrono::seconds(10), [&] { return numFinished == numThreads; }));
+	REQUIRE(threadIds.size() >= 2);
+}
+
+TEST_CASE("WorkStealingPool survives throwing tasks")
+{
+	WorkStealingPool pool(2);
+
+	std::atomic_bool ran = false;
+	pool.Submit([] { throw std::runtime_error("failure"); });
+	pool.Submit([&] { ran = true; });
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (!ran && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	REQUIRE(ran);
+}
+
+TEST_CASE("WorkStealingPool::ParallelFor")
+{
+	WorkStealingPool pool(4);
+
+	// Every index is visited exactly once.
+	std::vector<std::atomic<int>> visits(10000);
+	pool.ParallelFor(visits.size(), 16, [&visits](const size_t begin, const size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			visits[i]++;
+		}
+	});
+	REQUIRE(std::all_of(visits.cbegin(), visits.cend(), [](const std::atomic<int>& numVisits) { return numVisits == 1; }));
+
+	// Exceptions are rethrown on the calling thread.
+	REQUIRE_THROWS_AS(
+		pool.ParallelFor(1000, 1, [](const size_t begin, const size_t) {
+			if (begin > 0)
+			{
+				throw std::runtime_error("failure");
+			}
+		}),
+		std::runtime_error
+	);
+
+	// Loops nested inside tasks on the same pool complete, even with every worker busy.
+	std::atomic<size_t> numNested = 0;
+	pool.ParallelFor(8, 1, [&pool, &numNested](const size_t begin, const size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			pool.ParallelFor(100, 1, [&numNested](const size_t innerBegin, const size_t innerEnd) {
+				numNested += innerEnd - innerBegin;
+			});
+		}
+	});
+	REQUIRE(numNested == 800);
+}
\ No newline at end of file
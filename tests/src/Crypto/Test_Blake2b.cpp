@@ -0,0 +1,106 @@
+#include <catch.hpp>
+
+#include <Crypto/Crypto.h>
+#include <Crypto/Blake2bHasher.h>
+#include <chrono>
+
+static std::vector<std::vector<unsigned char>> GenerateInputs(const size_t count, const size_t length)
+{
+	std::vector<std::vector<unsigned char>> inputs;
+	for (size_t i = 0; i < count; i++)
+	{
+		std::vector<unsigned char> input(length);
+		for (size_t j = 0; j < length; j++)
+		{
+			input[j] = (unsigned char)((i * 31) + (j * 7) + length);
+		}
+
+		inputs.emplace_back(std::move(input));
+	}
+
+	return inputs;
+}
+
+TEST_CASE("Blake2bMulti matches Blake2b")
+{
+	// Covers empty messages, messages that fill the last lane group partially, and messages too long for a single block.
+	for (size_t length = 0; length <= 200; length++)
+	{
+		for (size_t count = 1; count <= 9; count++)
+		{
+			const std::vector<std::vector<unsigned char>> inputs = GenerateInputs(count, length);
+			const std::vector<CBigInteger<32>> hashes = Crypto::Blake2bMulti(inputs);
+
+			REQUIRE(hashes.size() == count);
+			for (size_t i = 0; i < count; i++)
+			{
+				REQUIRE(hashes[i] == Crypto::Blake2b(inputs[i]));
+			}
+		}
+	}
+
+	// Messages of different lengths in the same batch
+	std::vector<std::vector<unsigned char>> mixed;
+	for (size_t length : { 40, 72, 8, 129, 104, 0, 64, 128 })
+	{
+		mixed.push_back(GenerateInputs(1, length).front());
+	}
+
+	const std::vector<CBigInteger<32>> mixedHashes = Crypto::Blake2bMulti(mixed);
+	for (size_t i = 0; i < mixed.size(); i++)
+	{
+		REQUIRE(mixedHashes[i] == Crypto::Blake2b(mixed[i]));
+	}
+
+	REQUIRE(Crypto::Blake2bMulti({}).empty());
+}
+
+TEST_CASE("Blake2bHasher matches Blake2b")
+{
+	const std::vector<unsigned char> input = GenerateInputs(1, 300).front();
+
+	// Written in uneven pieces that cross block boundaries
+	Blake2bHasher hasher;
+	size_t written = 0;
+	for (size_t pieceLength = 1; written < input.size(); pieceLength += 37)
+	{
+		const size_t length = (std::min)(pieceLength, input.size() - written);
+		hasher.Write(input.data() + written, length);
+		written += length;
+	}
+
+	REQUIRE(hasher.Finalize() == Crypto::Blake2b(input));
+
+	// WriteU64 is big-endian
+	const std::vector<unsigned char> expected = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xAB };
+	const unsigned char last = 0xAB;
+	REQUIRE(hasher.Reset().WriteU64(0x0102030405060708ULL).Write(&last, 1).Finalize() == Crypto::Blake2b(expected));
+}
+
+// Run with "[.benchmark]" to compare the throughput of the scalar and multi-buffer paths for MMR-sized messages.
+TEST_CASE("Blake2bMulti Throughput", "[.benchmark]")
+{
+	const size_t numHashes = 1000000;
+
+	for (size_t length : { 40, 72 })
+	{
+		const std::vector<std::vector<unsigned char>> inputs = GenerateInputs(numHashes, length);
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<CBigInteger<32>> scalarHashes;
+		scalarHashes.reserve(numHashes);
+		for (const auto& input : inputs)
+		{
+			scalarHashes.emplace_back(Crypto::Blake2b(input));
+		}
+		const auto scalarMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		const std::vector<CBigInteger<32>> multiHashes = Crypto::Blake2bMulti(inputs);
+		const auto multiMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+		REQUIRE(scalarHashes == multiHashes);
+
+		WARN(length << "-byte messages: scalar " << scalarMs << "ms, multi " << multiMs << "ms");
+	}
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <catch.hpp>
+
+#include <Database/BlockStore/BlockFiles.h>
+#include <Core/File/FileRemover.h>
+#include <fstream>
+
+// The block hash only covers the proof of work, so each block gets its own proof nonces.
+static FullBlock CreateBlock(const uint64_t height)
+{
+	static uint64_t nextProofNonce = 1;
+
+	std::vector<uint64_t> proofNonces(42, 0);
+	proofNonces[0] = nextProofNonce++;
+
+	auto pHeader = std::make_shared<BlockHeader>(
+		(uint16_t)2,
+		height,
+		(int64_t)height * 60,
+		Hash::ValueOf((unsigned char)height),
+		Hash(),
+		Hash(),
+		Hash(),
+		Hash(),
+		BlindingFactor(Hash()),
+		0,
+		0,
+		height,
+		1,
+		0,
+		ProofOfWork(29, std::move(proofNonces))
+	);
+
+	return FullBlock(pHeader, TransactionBody());
+}
+
+TEST_CASE("BlockFiles - Torn record is truncated on open")
+{
+	const fs::path directory = fs::temp_directory_path() / "block_files_torn";
+	FileUtil::RemoveFile(directory);
+	FileRemover remover(directory);
+
+	const FullBlock block1 = CreateBlock(1);
+	const FullBlock block2 = CreateBlock(2);
+	const FullBlock block3 = CreateBlock(3);
+
+	std::vector<BlockLocation> locations;
+	{
+		auto pBlockFiles = BlockFiles::Open(directory);
+		locations.push_back(pBlockFiles->Append(block1));
+		locations.push_back(pBlockFiles->Append(block2));
+		pBlockFiles->Commit();
+	}
+
+	const fs::path path = directory / "blk00000.dat";
+	const uint64_t goodSize = FileUtil::GetFileSize(path);
+	REQUIRE(goodSize == locations.back().GetOffset() + locations.back().GetSize());
+
+	// Simulate a crash mid-flush: a record header promising more bytes than were written.
+	{
+		Serializer torn;
+		torn.Append<uint64_t>(3);
+		torn.Append<uint32_t>(1000);
+		torn.AppendByteVector(std::vector<unsigned char>(5, 0xAB));
+
+		std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::app);
+		file.write((const char*)torn.data(), torn.size());
+	}
+	REQUIRE(FileUtil::GetFileSize(path) == goodSize + BlockFiles::RECORD_HEADER_SIZE + 5);
+
+	{
+		auto pBlockFiles = BlockFiles::Open(directory);
+		REQUIRE(FileUtil::GetFileSize(path) == goodSize);
+
+		// New appends land right after the last complete record.
+		locations.push_back(pBlockFiles->Append(block3));
+		pBlockFiles->Commit();
+		REQUIRE(locations.back().GetOffset() == goodSize + BlockFiles::RECORD_HEADER_SIZE);
+
+		REQUIRE(pBlockFiles->Read(locations[0])->GetHash() == block1.GetHash());
+		REQUIRE(pBlockFiles->Read(locations[1])->GetHash() == block2.GetHash());
+		REQUIRE(pBlockFiles->Read(locations[2])->GetHash() == block3.GetHash());
+	}
+
+	// Reopening an intact file leaves it untouched.
+	const uint64_t finalSize = FileUtil::GetFileSize(path);
+	{
+		auto pBlockFiles = BlockFiles::Open(directory);
+		REQUIRE(FileUtil::GetFileSize(path) == finalSize);
+		REQUIRE(pBlockFiles->Read(locations[2])->GetHash() == block3.GetHash());
+	}
+}
+
+TEST_CASE("BlockFiles - Pruning reads stop at a torn record")
+{
+	const fs::path directory = fs::temp_directory_path() / "block_files_prune_torn";
+	FileUtil::RemoveFile(directory);
+	FileRemover remover(directory);
+
+	const FullBlock block1 = CreateBlock(10);
+	const FullBlock block2 = CreateBlock(11);
+	{
+		auto pBlockFiles = BlockFiles::Open(directory);
+		pBlockFiles->Append(block1);
+		pBlockFiles->Append(block2);
+		pBlockFiles->Commit();
+	}
+
+	// A torn record at the end of an older file, followed by a newer (empty) file.
+	{
+		Serializer torn;
+		torn.Append<uint64_t>(500);
+		torn.Append<uint32_t>(1000);
+
+		std::ofstream file(directory / "blk00000.dat", std::ios::out | std::ios::binary | std::ios::app);
+		file.write((const char*)torn.data(), torn.size());
+	}
+	std::ofstream(directory / "blk00001.dat", std::ios::out | std::ios::binary).close();
+
+	auto pBlockFiles = BlockFiles::Open(directory);
+	REQUIRE(pBlockFiles->GetBlockHashes(0) == std::vector<Hash>({ block1.GetHash(), block2.GetHash() }));
+
+	// The torn record's height is never counted, so the file is prunable as soon as both blocks are below the horizon.
+	REQUIRE(pBlockFiles->GetFilesBelow(11).empty());
+	REQUIRE(pBlockFiles->GetFilesBelow(12) == std::vector<uint32_t>({ 0 }));
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include <catch.hpp>
+
+#include <Database/RocksDB/RocksDBFactory.h>
+#include <Database/DatabaseException.h>
+#include <Core/Models/OutputLocation.h>
+#include <Core/File/FileRemover.h>
+#include <Common/Util/StringUtil.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
+
+static std::shared_ptr<RocksDB> OpenTestDB(const fs::path& dbPath)
+{
+	std::vector<rocksdb::ColumnFamilyDescriptor> tableNames = {
+		rocksdb::ColumnFamilyDescriptor(),
+		rocksdb::ColumnFamilyDescriptor("ROWS", rocksdb::ColumnFamilyOptions())
+	};
+
+	return RocksDBFactory::Open(dbPath, tableNames);
+}
+
+static std::string RowKey(const uint64_t i)
+{
+	return StringUtil::Format("row_{:06}", i);
+}
+
+TEST_CASE("RocksDB::DeleteAll - Inside transaction")
+{
+	const fs::path dbPath = fs::temp_directory_path() / "rocksdb_delete_all";
+	FileUtil::RemoveFile(dbPath);
+	FileRemover remover(dbPath);
+
+	std::shared_ptr<RocksDB> pDB = OpenTestDB(dbPath);
+
+	const uint64_t numRows = 1000;
+	for (uint64_t i = 0; i < numRows; i++)
+	{
+		pDB->Put("ROWS", DBEntry<OutputLocation>(RowKey(i), OutputLocation(i, i)));
+	}
+
+	// The clear is a range deletion on the base DB, not a row-by-row walk buffered in the transaction.
+	// It's visible immediately, and a rollback doesn't bring the rows back.
+	{
+		pDB->OnInitWrite();
+
+		rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+		rocksdb::get_perf_context()->Reset();
+		pDB->DeleteAll("ROWS");
+		REQUIRE(rocksdb::get_perf_context()->internal_key_skipped_count < numRows);
+		rocksdb::SetPerfLevel(rocksdb::PerfLevel::kDisable);
+
+		REQUIRE(pDB->Get<OutputLocation>("ROWS", RowKey(0)) == nullptr);
+		REQUIRE(pDB->Get<OutputLocation>("ROWS", RowKey(numRows - 1)) == nullptr);
+
+		pDB->Rollback();
+		pDB->OnEndWrite();
+	}
+
+	REQUIRE(pDB->Get<OutputLocation>("ROWS", RowKey(0)) == nullptr);
+	REQUIRE(pDB->Get<OutputLocation>("ROWS", RowKey(numRows / 2)) == nullptr);
+
+	// Rows written by the transaction after the clear survive the commit.
+	pDB->Put("ROWS", DBEntry<OutputLocation>(RowKey(1), OutputLocation(1, 1)));
+	{
+		pDB->OnInitWrite();
+		pDB->DeleteAll("ROWS");
+		pDB->Put("ROWS", DBEntry<OutputLocation>(RowKey(2), OutputLocation(2, 2)));
+		pDB->Commit();
+		pDB->OnEndWrite();
+	}
+
+	REQUIRE(pDB->Get<OutputLocation>("ROWS", RowKey(1)) == nullptr);
+	auto pLocation = pDB->Get<OutputLocation>("ROWS", RowKey(2));
+	REQUIRE(pLocation != nullptr);
+	REQUIRE(pLocation->GetMMRIndex() == 2);
+
+	// Clearing a table the transaction already wrote to would conflict with the range tombstone, so it's refused.
+	{
+		pDB->OnInitWrite();
+		pDB->Put("ROWS", DBEntry<OutputLocation>(RowKey(3), OutputLocation(3, 3)));
+		REQUIRE_THROWS_AS(pDB->DeleteAll("ROWS"), DatabaseException);
+		pDB->Rollback();
+		pDB->OnEndWrite();
+	}
+
+	REQUIRE(pDB->Get<OutputLocation>("ROWS", RowKey(2)) != nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include <catch.hpp>
+
+#include <Net/BufferPool.h>
+
+TEST_CASE("BufferPool reuses released buffers")
+{
+	BufferPoolPtr pPool = BufferPool::Create(1024 * 1024);
+
+	const unsigned char* pData = nullptr;
+	{
+		BufferPool::Buffer pBuffer = pPool->Acquire(5000);
+		REQUIRE(pBuffer->size() == 5000);
+		REQUIRE(pBuffer->capacity() == 8 * 1024);
+		pData = pBuffer->data();
+	}
+
+	REQUIRE(pPool->GetPooledBytes() == 8 * 1024);
+
+	// Any size in the same class gets the same buffer back
+	BufferPool::Buffer pBuffer = pPool->Acquire(6000);
+	REQUIRE(pBuffer->size() == 6000);
+	REQUIRE(pBuffer->data() == pData);
+	REQUIRE(pPool->GetPooledBytes() == 0);
+
+	// Smaller sizes use a different class
+	BufferPool::Buffer pSmall = pPool->Acquire(0);
+	REQUIRE(pSmall->empty());
+	REQUIRE(pSmall->capacity() == BufferPool::MIN_CLASS_SIZE);
+	REQUIRE(pSmall->data() != pData);
+}
+
+TEST_CASE("BufferPool limits pooled bytes")
+{
+	BufferPoolPtr pPool = BufferPool::Create(8 * 1024);
+
+	{
+		BufferPool::Buffer pBuffer1 = pPool->Acquire(4096);
+		BufferPool::Buffer pBuffer2 = pPool->Acquire(4096);
+		BufferPool::Buffer pBuffer3 = pPool->Acquire(4096);
+	}
+
+	REQUIRE(pPool->GetPooledBytes() == 8 * 1024);
+
+	// Too large to pool
+	{
+		BufferPool::Buffer pLarge = pPool->Acquire(64 * 1024 * 1024);
+		REQUIRE(pLarge->size() == 64 * 1024 * 1024);
+	}
+
+	REQUIRE(pPool->GetPooledBytes() == 8 * 1024);
+
+	// Buffers can outlive their pool
+	BufferPool::Buffer pOrphan = pPool->Acquire(100);
+	pPool.reset();
+	pOrphan.reset();
+
+	BufferPool::Buffer pWrapped = BufferPool::Wrap({ 1, 2, 3 });
+	REQUIRE(pWrapped->size() == 3);
+}
\ No newline at end of file
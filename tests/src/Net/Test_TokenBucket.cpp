@@ -0,0 +1,39 @@
+#include <catch.hpp>
+
+#include <Net/TokenBucket.h>
+#include <Net/RateCounter.h>
+
+TEST_CASE("TokenBucket")
+{
+	// Unlimited
+	TokenBucket unlimited(0, 0);
+	REQUIRE_FALSE(unlimited.IsLimited());
+	REQUIRE(unlimited.Consume(1000000).count() == 0);
+
+	// Bursts up to the capacity are allowed without waiting.
+	TokenBucket bucket(1000, 1000);
+	REQUIRE(bucket.IsLimited());
+	REQUIRE(bucket.Consume(600).count() == 0);
+	REQUIRE(bucket.Consume(400).count() == 0);
+
+	// Going into debt returns the time needed to pay it back.
+	const auto delay = bucket.Consume(500).count();
+	REQUIRE(delay > 400);
+	REQUIRE(delay <= 500);
+}
+
+TEST_CASE("RateCounter")
+{
+	RateCounter counter;
+	counter.AddSent(100, 1);
+	counter.AddSent(50, 0);
+	counter.AddReceived(10, 1);
+	counter.AddReceived(20, 1);
+
+	REQUIRE(counter.GetSentInLastMinute().messages == 1);
+	REQUIRE(counter.GetSentInLastMinute().bytes == 150);
+	REQUIRE(counter.GetReceivedInLastMinute().messages == 2);
+	REQUIRE(counter.GetReceivedInLastMinute().bytes == 30);
+	REQUIRE(counter.GetTotalSent().bytes == 150);
+	REQUIRE(counter.GetTotalReceived().messages == 2);
+}
\ No newline at end of file
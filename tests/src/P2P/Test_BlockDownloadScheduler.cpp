@@ -0,0 +1,387 @@
+#include <catch.hpp>
+
+#include <P2P/Sync/BlockDownloadScheduler.h>
+#include <algorithm>
+#include <map>
+#include <set>
+
+using Clock = BlockDownloadScheduler::Clock;
+
+static PeerPtr CreatePeer(const uint8_t id)
+{
+	return std::make_shared<Peer>(IPAddress::CreateV4({ 10, 0, 0, id }));
+}
+
+// The height is stored in the last 8 bytes of each block's hash, so requests can be traced back to heights.
+static Hash HashOf(const uint64_t height)
+{
+	std::vector<unsigned char> bytes(32, 0);
+	for (size_t i = 0; i < 8; i++)
+	{
+		bytes[31 - i] = (unsigned char)(height >> (8 * i));
+	}
+
+	return Hash(bytes);
+}
+
+static uint64_t HeightOf(const Hash& hash)
+{
+	uint64_t height = 0;
+	for (size_t i = 24; i < 32; i++)
+	{
+		height = (height << 8) | hash[i];
+	}
+
+	return height;
+}
+
+static std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t first, const uint64_t last, const std::set<uint64_t>& received = {})
+{
+	std::vector<std::pair<uint64_t, Hash>> blocksNeeded;
+	for (uint64_t height = first; height <= last; height++)
+	{
+		if (received.find(height) == received.end())
+		{
+			blocksNeeded.emplace_back(height, HashOf(height));
+		}
+	}
+
+	return blocksNeeded;
+}
+
+struct RequestLog
+{
+	std::multimap<uint64_t, IPAddress> requests;
+
+	BlockDownloadScheduler::SendRequest Sender()
+	{
+		return [this](const PeerPtr& pPeer, const Hash& hash)
+		{
+			requests.emplace(HeightOf(hash), pPeer->GetIPAddress());
+			return true;
+		};
+	}
+
+	size_t Count(const PeerPtr& pPeer) const
+	{
+		return std::count_if(
+			requests.cbegin(),
+			requests.cend(),
+			[&pPeer](const auto& request) { return request.second == pPeer->GetIPAddress(); }
+		);
+	}
+
+	bool WasRequested(const uint64_t height, const PeerPtr& pPeer) const
+	{
+		auto range = requests.equal_range(height);
+		return std::any_of(range.first, range.second, [&pPeer](const auto& request) { return request.second == pPeer->GetIPAddress(); });
+	}
+};
+
+TEST_CASE("BlockDownloadScheduler - Windows")
+{
+	const Clock::time_point start = Clock::now();
+	PeerPtr pPeerA = CreatePeer(1);
+	PeerPtr pPeerB = CreatePeer(2);
+
+	BlockDownloadScheduler scheduler;
+	RequestLog log;
+
+	// New peers start with 4 blocks each.
+	REQUIRE(scheduler.Schedule(GetBlocksNeeded(1, 20), { pPeerA, pPeerB }, log.Sender(), start) == 8);
+	REQUIRE(log.Count(pPeerA) == 4);
+	REQUIRE(log.Count(pPeerB) == 4);
+	REQUIRE(scheduler.GetNumInFlight() == 8);
+
+	// Nothing more is requested until blocks arrive.
+	REQUIRE(scheduler.Schedule(GetBlocksNeeded(1, 20), { pPeerA, pPeerB }, log.Sender(), start) == 0);
+
+	// Each on-time delivery frees a slot and grows the window.
+	std::set<uint64_t> received;
+	for (uint64_t height = 1; height <= 8; height++)
+	{
+		if (log.WasRequested(height, pPeerB))
+		{
+			scheduler.OnBlockReceived(pPeerB->GetIPAddress(), height, HashOf(height), 1000, start + std::chrono::milliseconds(100));
+			received.insert(height);
+		}
+	}
+
+	BlockDownloadScheduler::PeerStats stats;
+	REQUIRE(scheduler.GetPeerStats(pPeerB->GetIPAddress(), stats, start));
+	REQUIRE(stats.window == 8.0);
+	REQUIRE(stats.inFlight == 0);
+	REQUIRE(stats.roundTripTime == std::chrono::milliseconds(100));
+
+	REQUIRE(scheduler.Schedule(GetBlocksNeeded(1, 20, received), { pPeerA, pPeerB }, log.Sender(), start + std::chrono::milliseconds(100)) == 8);
+	REQUIRE(log.Count(pPeerB) == 12);
+
+	// Blocks that made it into the chain some other way release their slots.
+	scheduler.OnChainHeight(20);
+	REQUIRE(scheduler.GetNumInFlight() == 0);
+	REQUIRE(scheduler.GetPeerStats(pPeerA->GetIPAddress(), stats, start));
+	REQUIRE(stats.inFlight == 0);
+}
+
+TEST_CASE("BlockDownloadScheduler - Timeouts")
+{
+	const Clock::time_point start = Clock::now();
+	PeerPtr pPeerA = CreatePeer(1);
+	PeerPtr pPeerB = CreatePeer(2);
+
+	BlockDownloadScheduler scheduler;
+	RequestLog log;
+
+	REQUIRE(scheduler.Schedule(GetBlocksNeeded(1, 4), { pPeerA }, log.Sender(), start) == 4);
+
+	// Peer B joins after A's requests time out. A's window is halved and B gets the blocks first, but A isn't banned.
+	const Clock::time_point later = start + std::chrono::seconds(11);
+	RequestLog retries;
+	REQUIRE(scheduler.Schedule(GetBlocksNeeded(1, 4), { pPeerA, pPeerB }, retries.Sender(), later) == 4);
+	REQUIRE(retries.Count(pPeerB) == 4);
+	REQUIRE(retries.Count(pPeerA) == 0);
+
+	BlockDownloadScheduler::PeerStats stats;
+	REQUIRE(scheduler.GetPeerStats(pPeerA->GetIPAddress(), stats, later));
+	REQUIRE(stats.window == 2.0);
+	REQUIRE(stats.inFlight == 0);
+	REQUIRE(stats.deprioritized);
+	REQUIRE_FALSE(pPeerA->IsBanned());
+
+	// Late blocks are still accepted, but don't count as round trip samples.
+	scheduler.OnBlockReceived(pPeerA->GetIPAddress(), 1, HashOf(1), 1000, later);
+	REQUIRE(scheduler.GetNumInFlight() == 3);
+	REQUIRE(scheduler.GetPeerStats(pPeerB->GetIPAddress(), stats, later));
+	REQUIRE(stats.inFlight == 3);
+
+	// Deprioritized peers are still used once everyone else is full.
+	RequestLog overflow;
+	REQUIRE(scheduler.Schedule(GetBlocksNeeded(2, 10), { pPeerA, pPeerB }, overflow.Sender(), later) == 3);
+	REQUIRE(overflow.Count(pPeerB) == 1);
+	REQUIRE(overflow.Count(pPeerA) == 2);
+}
+
+TEST_CASE("BlockDownloadScheduler - Stalls")
+{
+	const Clock::time_point start = Clock::now();
+	PeerPtr pSlowPeer = CreatePeer(1);
+	PeerPtr pFastPeer = CreatePeer(2);
+
+	BlockDownloadScheduler scheduler;
+	RequestLog log;
+
+	REQUIRE(scheduler.Schedule(GetBlocksNeeded(1, 8), { pSlowPeer, pFastPeer }, log.Sender(), start) == 8);
+	REQUIRE(log.WasRequested(1, pSlowPeer));
+
+	std::set<uint64_t> received;
+	for (uint64_t height = 1; height <= 8; height++)
+	{
+		if (log.WasRequested(height, pFastPeer))
+		{
+			scheduler.OnBlockReceived(pFastPeer->GetIPAddress(), height, HashOf(height), 1000, start + std::chrono::milliseconds(100));
+			received.insert(height);
+		}
+	}
+
+	// The slow peer hasn't timed out yet, but is holding up the front of the window.
+	const Clock::time_point later = start + std::chrono::seconds(2);
+	RequestLog retries;
+	scheduler.Schedule(GetBlocksNeeded(1, 8, received), { pSlowPeer, pFastPeer }, retries.Sender(), later);
+	REQUIRE(retries.WasRequested(1, pFastPeer));
+	REQUIRE_FALSE(retries.WasRequested(1, pSlowPeer));
+
+	BlockDownloadScheduler::PeerStats stats;
+	REQUIRE(scheduler.GetPeerStats(pSlowPeer->GetIPAddress(), stats, later));
+	REQUIRE(stats.deprioritized);
+	REQUIRE(stats.window == 4.0);
+	REQUIRE(stats.inFlight == 4);
+
+	// A different block at the requested height (ie. from a fork) doesn't complete the request.
+	scheduler.OnBlockReceived(pFastPeer->GetIPAddress(), 1, HashOf(1000), 1000, later + std::chrono::milliseconds(100));
+	REQUIRE(scheduler.GetPeerStats(pSlowPeer->GetIPAddress(), stats, later));
+	REQUIRE(stats.inFlight == 4);
+
+	// Whichever copy arrives first completes the request for both peers.
+	scheduler.OnBlockReceived(pFastPeer->GetIPAddress(), 1, HashOf(1), 1000, later + std::chrono::milliseconds(100));
+	REQUIRE(scheduler.GetPeerStats(pSlowPeer->GetIPAddress(), stats, later));
+	REQUIRE(stats.inFlight == 3);
+}
+
+//
+// Simulated peers with fixed latency and bandwidth, which serve block requests one at a time in the order received.
+//
+class SimulatedNetwork
+{
+public:
+	struct PeerProfile
+	{
+		std::chrono::milliseconds latency;
+		double bytesPerSecond;
+		bool unresponsive;
+	};
+
+	SimulatedNetwork(const std::vector<PeerProfile>& profiles, const size_t blockBytes)
+		: m_profiles(profiles), m_blockBytes(blockBytes), m_now(Clock::now())
+	{
+		for (size_t i = 0; i < profiles.size(); i++)
+		{
+			m_peers.push_back(CreatePeer((uint8_t)(i + 1)));
+			m_busyUntil.push_back(m_now);
+		}
+	}
+
+	const std::vector<PeerPtr>& GetPeers() const { return m_peers; }
+	Clock::time_point GetNow() const { return m_now; }
+	void Advance(const std::chrono::milliseconds duration) { m_now += duration; }
+
+	bool Send(const PeerPtr& pPeer, const uint64_t height)
+	{
+		const size_t index = std::find(m_peers.begin(), m_peers.end(), pPeer) - m_peers.begin();
+		const PeerProfile& profile = m_profiles[index];
+		if (profile.unresponsive)
+		{
+			return true;
+		}
+
+		const auto transfer = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_blockBytes / profile.bytesPerSecond));
+		const Clock::time_point start = (std::max)(m_now + (profile.latency / 2), m_busyUntil[index]);
+		m_busyUntil[index] = start + transfer;
+		m_deliveries.emplace(m_busyUntil[index] + (profile.latency / 2), std::make_pair(index, height));
+		return true;
+	}
+
+	// Returns the deliveries up to now, in the order they arrive.
+	std::vector<std::tuple<Clock::time_point, PeerPtr, uint64_t>> Receive()
+	{
+		std::vector<std::tuple<Clock::time_point, PeerPtr, uint64_t>> delivered;
+		while (!m_deliveries.empty() && m_deliveries.begin()->first <= m_now)
+		{
+			auto iter = m_deliveries.begin();
+			delivered.emplace_back(iter->first, m_peers[iter->second.first], iter->second.second);
+			m_deliveries.erase(iter);
+		}
+
+		return delivered;
+	}
+
+private:
+	std::vector<PeerProfile> m_profiles;
+	size_t m_blockBytes;
+	Clock::time_point m_now;
+	std::vector<PeerPtr> m_peers;
+	std::vector<Clock::time_point> m_busyUntil;
+	std::multimap<Clock::time_point, std::pair<size_t, uint64_t>> m_deliveries;
+};
+
+//
+// Downloads numBlocks over the simulated network, checking every 100ms like BlockSyncer does, and returns the simulated time taken.
+// If adaptive is false, the previous scheduling is used instead: batches of 16 blocks per peer, round-robin,
+// requested once fewer than 15 blocks are in flight, with a flat 10 second timeout after which the peer is banned.
+//
+static std::chrono::milliseconds SimulateSync(SimulatedNetwork& network, const uint64_t numBlocks, const size_t blockBytes, const bool adaptive)
+{
+	const Clock::time_point start = network.GetNow();
+
+	BlockDownloadScheduler scheduler;
+	std::set<uint64_t> received;
+	uint64_t chainHeight = 0;
+
+	std::vector<PeerPtr> peers = network.GetPeers();
+	std::map<uint64_t, std::pair<PeerPtr, Clock::time_point>> fixedRequests;
+
+	while (chainHeight < numBlocks && network.GetNow() - start < std::chrono::hours(1))
+	{
+		network.Advance(std::chrono::milliseconds(100));
+
+		for (const auto& delivery : network.Receive())
+		{
+			received.insert(std::get<2>(delivery));
+			scheduler.OnBlockReceived(std::get<1>(delivery)->GetIPAddress(), std::get<2>(delivery), HashOf(std::get<2>(delivery)), blockBytes, std::get<0>(delivery));
+			fixedRequests.erase(std::get<2>(delivery));
+		}
+
+		while (received.find(chainHeight + 1) != received.end())
+		{
+			++chainHeight;
+		}
+
+		const auto blocksNeeded = GetBlocksNeeded(chainHeight + 1, (std::min)(numBlocks, chainHeight + 1024), received);
+		if (adaptive)
+		{
+			scheduler.OnChainHeight(chainHeight);
+			scheduler.Schedule(
+				blocksNeeded,
+				peers,
+				[&network](const PeerPtr& pPeer, const Hash& hash) { return network.Send(pPeer, HeightOf(hash)); },
+				network.GetNow()
+			);
+			continue;
+		}
+
+		bool due = fixedRequests.size() < 15;
+		for (auto iter = fixedRequests.begin(); iter != fixedRequests.end(); )
+		{
+			if (iter->second.second + std::chrono::seconds(10) < network.GetNow())
+			{
+				peers.erase(std::remove(peers.begin(), peers.end(), iter->second.first), peers.end());
+				iter = fixedRequests.erase(iter);
+				due = true;
+			}
+			else
+			{
+				++iter;
+			}
+		}
+
+		if (!due || peers.empty())
+		{
+			continue;
+		}
+
+		size_t numRequested = 0;
+		for (const auto& blockNeeded : blocksNeeded)
+		{
+			if (numRequested == 16 * peers.size())
+			{
+				break;
+			}
+
+			if (fixedRequests.find(blockNeeded.first) == fixedRequests.end())
+			{
+				const PeerPtr& pPeer = peers[(numRequested / 16) % peers.size()];
+				network.Send(pPeer, blockNeeded.first);
+				fixedRequests[blockNeeded.first] = std::make_pair(pPeer, network.GetNow());
+				++numRequested;
+			}
+		}
+	}
+
+	return std::chrono::duration_cast<std::chrono::milliseconds>(network.GetNow() - start);
+}
+
+
+// Run with "[.benchmark]" to compare simulated sync times on a mix of fast, slow, and unresponsive peers.
+TEST_CASE("BlockDownloadScheduler - Simulated Sync", "[.benchmark]")
+{
+	const uint64_t numBlocks = 2000;
+	const size_t blockBytes = 100 * 1024;
+
+	const std::vector<SimulatedNetwork::PeerProfile> profiles = {
+		{ std::chrono::milliseconds(50), 4.0 * 1024 * 1024, false },
+		{ std::chrono::milliseconds(80), 2.0 * 1024 * 1024, false },
+		{ std::chrono::milliseconds(150), 1.0 * 1024 * 1024, false },
+		{ std::chrono::milliseconds(600), 150.0 * 1024, false },
+		{ std::chrono::milliseconds(900), 100.0 * 1024, false },
+		{ std::chrono::milliseconds(100), 1.0 * 1024 * 1024, true }
+	};
+
+	SimulatedNetwork fixedNetwork(profiles, blockBytes);
+	const auto fixedTime = SimulateSync(fixedNetwork, numBlocks, blockBytes, false);
+
+	SimulatedNetwork adaptiveNetwork(profiles, blockBytes);
+	const auto adaptiveTime = SimulateSync(adaptiveNetwork, numBlocks, blockBytes, true);
+
+	REQUIRE(adaptiveTime < fixedTime);
+
+	WARN(numBlocks << " blocks: fixed " << fixedTime.count() << "ms, adaptive " << adaptiveTime.count() << "ms");
+}
\ No newline at end of file
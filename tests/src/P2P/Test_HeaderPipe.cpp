@@ -0,0 +1,280 @@
+#include <catch.hpp>
+
+#include <P2P/Pipeline/HeaderPipe.h>
+#include <TestHelper.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+//
+// Only implements what the HeaderPipe uses: verifying cycles, adding headers, and looking them up.
+//
+class FakeBlockChainServer : public IBlockChainServer
+{
+public:
+	FakeBlockChainServer(const BlockHeaderPtr& pGenesis)
+		: m_pTip(pGenesis), m_unverifiedAdds(0)
+	{
+		m_headers[pGenesis->GetHash()] = pGenesis;
+	}
+
+	void SetCycleInvalid(const BlockHeaderPtr& pHeader)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_invalidCycles.insert(pHeader->GetHash());
+	}
+
+	std::vector<uint64_t> GetAddedHeights() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_addedHeights;
+	}
+
+	size_t GetUnverifiedAdds() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_unverifiedAdds;
+	}
+
+	EBlockChainStatus AddBlockHeaders(const std::vector<BlockHeaderPtr>& blockHeaders) final
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_unverifiedAdds++;
+		return Add(blockHeaders);
+	}
+
+	EBlockChainStatus AddVerifiedBlockHeaders(const VerifiedHeaders& verifiedHeaders) final
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return Add(verifiedHeaders.GetHeaders());
+	}
+
+	VerifiedHeadersPtr VerifyHeaderCycles(const std::vector<BlockHeaderPtr>& blockHeaders) const final
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (const BlockHeaderPtr& pHeader : blockHeaders)
+		{
+			if (m_invalidCycles.count(pHeader->GetHash()) > 0)
+			{
+				return nullptr;
+			}
+		}
+
+		return MarkCyclesVerified(blockHeaders);
+	}
+
+	BlockHeaderPtr GetBlockHeaderByHash(const Hash& blockHeaderHash) const final
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		auto iter = m_headers.find(blockHeaderHash);
+		return iter != m_headers.end() ? iter->second : nullptr;
+	}
+
+	BlockHeaderPtr GetTipBlockHeader(const EChainType) const final
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_pTip;
+	}
+
+	void ResyncChain() final { }
+	void UpdateSyncStatus(SyncStatus&) const final { }
+	uint64_t GetHeight(const EChainType) const final { return 0; }
+	uint64_t GetTotalDifficulty(const EChainType) const final { return 0; }
+	EBlockChainStatus AddBlock(const FullBlock&, const std::string&) final { return EBlockChainStatus::UNKNOWN_ERROR; }
+	bool VerifyBlockSelfConsistent(const FullBlock&) const final { return false; }
+	EBlockChainStatus AddCompactBlock(const CompactBlock&, const std::string&) final { return EBlockChainStatus::UNKNOWN_ERROR; }
+	fs::path SnapshotTxHashSet(BlockHeaderPtr) final { return fs::path(); }
+	EBlockChainStatus ProcessTransactionHashSet(const Hash&, const fs::path&, SyncStatus&) final { return EBlockChainStatus::UNKNOWN_ERROR; }
+	EBlockChainStatus AddTransaction(TransactionPtr, const EPoolType) final { return EBlockChainStatus::UNKNOWN_ERROR; }
+	TransactionPtr GetTransactionByKernelHash(const Hash&) const final { return nullptr; }
+	EBlockChainStatus AddBlockHeader(BlockHeaderPtr) final { return EBlockChainStatus::UNKNOWN_ERROR; }
+	BlockHeaderPtr GetBlockHeaderByHeight(const uint64_t, const EChainType) const final { return nullptr; }
+	BlockHeaderPtr GetBlockHeaderByCommitment(const Commitment&) const final { return nullptr; }
+	std::vector<BlockHeaderPtr> GetBlockHeadersByHash(const std::vector<Hash>&) const final { return {}; }
+	std::unique_ptr<CompactBlock> GetCompactBlockByHash(const Hash&) const final { return nullptr; }
+	std::unique_ptr<FullBlock> GetBlockByHeight(const uint64_t) const final { return nullptr; }
+	std::unique_ptr<FullBlock> GetBlockByHash(const Hash&) const final { return nullptr; }
+	std::unique_ptr<FullBlock> GetBlockByCommitment(const Commitment&) const final { return nullptr; }
+	bool HasBlock(const uint64_t, const Hash&) const final { return false; }
+	std::vector<BlockWithOutputs> GetOutputsByHeight(const uint64_t, const uint64_t) const final { return {}; }
+	std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t) const final { return {}; }
+	bool ProcessNextOrphanBlock() final { return false; }
+	bool WaitForOrphanBlock(const std::chrono::milliseconds&) final { return false; }
+	PruningStats GetPruningStats() const final { return PruningStats(); }
+	OrphanPoolStats GetOrphanPoolStats() const final { return OrphanPoolStats(); }
+
+private:
+	EBlockChainStatus Add(const std::vector<BlockHeaderPtr>& blockHeaders)
+	{
+		if (m_headers.find(blockHeaders.front()->GetPreviousHash()) == m_headers.end())
+		{
+			return EBlockChainStatus::ORPHANED;
+		}
+
+		m_addedHeights.push_back(blockHeaders.front()->GetHeight());
+		for (const BlockHeaderPtr& pHeader : blockHeaders)
+		{
+			m_headers[pHeader->GetHash()] = pHeader;
+		}
+
+		m_pTip = blockHeaders.back();
+		return EBlockChainStatus::SUCCESS;
+	}
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<Hash, BlockHeaderPtr> m_headers;
+	std::unordered_set<Hash> m_invalidCycles;
+	std::vector<uint64_t> m_addedHeights;
+	BlockHeaderPtr m_pTip;
+	size_t m_unverifiedAdds;
+};
+
+// The block hash only covers the proof of work, so each header gets its own proof nonces.
+static BlockHeaderPtr CreateHeader(const BlockHeaderPtr& pPrevious)
+{
+	static std::atomic<uint64_t> nextProofNonce = 1;
+
+	std::vector<uint64_t> proofNonces(42, 0);
+	proofNonces[0] = nextProofNonce++;
+
+	return std::make_shared<BlockHeader>(
+		(uint16_t)2,
+		pPrevious->GetHeight() + 1,
+		pPrevious->GetTimestamp() + 60,
+		Hash(pPrevious->GetHash()),
+		Hash(),
+		Hash(),
+		Hash(),
+		Hash(),
+		BlindingFactor(Hash()),
+		0,
+		0,
+		pPrevious->GetTotalDifficulty() + 1,
+		1,
+		0,
+		ProofOfWork(29, std::move(proofNonces))
+	);
+}
+
+static std::vector<BlockHeaderPtr> CreateChain(const BlockHeaderPtr& pPrevious, const size_t length)
+{
+	std::vector<BlockHeaderPtr> headers;
+	for (size_t i = 0; i < length; i++)
+	{
+		headers.push_back(CreateHeader(headers.empty() ? pPrevious : headers.back()));
+	}
+
+	return headers;
+}
+
+template<typename Predicate>
+static bool WaitFor(const Predicate& predicate)
+{
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!predicate())
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+		{
+			return false;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	return true;
+}
+
+TEST_CASE("HeaderPipe - Batches are added in order")
+{
+	ConfigPtr pConfig = TestHelper::GetTestConfig();
+	BlockHeaderPtr pGenesis = pConfig->GetEnvironment().GetGenesisHeader();
+	auto pServer = std::make_shared<FakeBlockChainServer>(pGenesis);
+	auto pPipe = HeaderPipe::Create(*pConfig, pServer);
+	PeerPtr pPeer = std::make_shared<Peer>(IPAddress::CreateV4({ 10, 0, 0, 1 }));
+
+	std::vector<BlockHeaderPtr> headers = CreateChain(pGenesis, 6);
+	const std::vector<BlockHeaderPtr> batch1(headers.begin(), headers.begin() + 2);
+	const std::vector<BlockHeaderPtr> batch2(headers.begin() + 2, headers.begin() + 4);
+	const std::vector<BlockHeaderPtr> batch3(headers.begin() + 4, headers.end());
+
+	// Later batches wait in the reorder buffer until the headers before them are added.
+	REQUIRE(pPipe->AddHeadersToProcess(pPeer, batch3));
+	REQUIRE(pPipe->AddHeadersToProcess(pPeer, batch2));
+	REQUIRE(pPipe->GetDownloadTip() == nullptr);
+	std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	REQUIRE(pServer->GetAddedHeights().empty());
+
+	REQUIRE(pPipe->AddHeadersToProcess(pPeer, batch1));
+	REQUIRE(WaitFor([&pServer, &headers] { return pServer->GetBlockHeaderByHash(headers.back()->GetHash()) != nullptr; }));
+
+	REQUIRE(pServer->GetAddedHeights() == std::vector<uint64_t>({ 1, 3, 5 }));
+	REQUIRE(pServer->GetUnverifiedAdds() == 0);
+	REQUIRE(!pPeer->IsBanned());
+}
+
+TEST_CASE("HeaderPipe - Invalid batches")
+{
+	ConfigPtr pConfig = TestHelper::GetTestConfig();
+	BlockHeaderPtr pGenesis = pConfig->GetEnvironment().GetGenesisHeader();
+	auto pServer = std::make_shared<FakeBlockChainServer>(pGenesis);
+	auto pPipe = HeaderPipe::Create(*pConfig, pServer);
+
+	SECTION("Not contiguous")
+	{
+		PeerPtr pPeer = std::make_shared<Peer>(IPAddress::CreateV4({ 10, 0, 0, 1 }));
+		std::vector<BlockHeaderPtr> headers = CreateChain(pGenesis, 3);
+		REQUIRE_FALSE(pPipe->AddHeadersToProcess(pPeer, { headers[0], headers[2] }));
+	}
+
+	SECTION("Invalid cycle")
+	{
+		PeerPtr pGoodPeer = std::make_shared<Peer>(IPAddress::CreateV4({ 10, 0, 0, 1 }));
+		PeerPtr pBadPeer = std::make_shared<Peer>(IPAddress::CreateV4({ 10, 0, 0, 2 }));
+
+		std::vector<BlockHeaderPtr> badHeaders = CreateChain(pGenesis, 2);
+		pServer->SetCycleInvalid(badHeaders[1]);
+		REQUIRE(pPipe->AddHeadersToProcess(pBadPeer, badHeaders));
+		REQUIRE(WaitFor([&pBadPeer] { return pBadPeer->IsBanned(); }));
+
+		// The bad batch is dropped, so a good batch after the same header is accepted.
+		std::vector<BlockHeaderPtr> goodHeaders = CreateChain(pGenesis, 2);
+		REQUIRE(pPipe->AddHeadersToProcess(pGoodPeer, goodHeaders));
+		REQUIRE(WaitFor([&pServer, &goodHeaders] { return pServer->GetBlockHeaderByHash(goodHeaders.back()->GetHash()) != nullptr; }));
+
+		REQUIRE(pServer->GetBlockHeaderByHash(badHeaders.back()->GetHash()) == nullptr);
+		REQUIRE(!pGoodPeer->IsBanned());
+	}
+}
+
+TEST_CASE("HeaderPipe - Stale batches are evicted")
+{
+	ConfigPtr pConfig = TestHelper::GetTestConfig();
+	BlockHeaderPtr pGenesis = pConfig->GetEnvironment().GetGenesisHeader();
+	auto pServer = std::make_shared<FakeBlockChainServer>(pGenesis);
+	auto pPipe = HeaderPipe::Create(*pConfig, pServer, std::chrono::milliseconds(500));
+	PeerPtr pPeer = std::make_shared<Peer>(IPAddress::CreateV4({ 10, 0, 0, 1 }));
+
+	// None of these batches connect to a known header, so they can only leave the queue by being evicted.
+	std::vector<BlockHeaderPtr> unknown = CreateChain(pGenesis, 1);
+	size_t queued = 0;
+	while (!pPipe->IsFull())
+	{
+		const std::vector<BlockHeaderPtr> headers = CreateChain(unknown.back(), 2);
+		unknown.push_back(headers.back());
+		REQUIRE(pPipe->AddHeadersToProcess(pPeer, headers));
+		REQUIRE(++queued <= 1000);
+	}
+
+	// While full, new batches are dropped without banning.
+	std::vector<BlockHeaderPtr> headers = CreateChain(pGenesis, 2);
+	REQUIRE(pPipe->AddHeadersToProcess(pPeer, headers));
+	std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	REQUIRE(pServer->GetBlockHeaderByHash(headers.back()->GetHash()) == nullptr);
+
+	REQUIRE(WaitFor([&pPipe] { return !pPipe->IsFull(); }));
+	REQUIRE(pPipe->AddHeadersToProcess(pPeer, headers));
+	REQUIRE(WaitFor([&pServer, &headers] { return pServer->GetBlockHeaderByHash(headers.back()->GetHash()) != nullptr; }));
+	REQUIRE(!pPeer->IsBanned());
+}
\ No newline at end of file
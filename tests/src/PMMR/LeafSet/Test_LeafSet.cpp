@@ -1,8 +1,48 @@
 #include <catch.hpp>
 
+#include <Core/File/FileRemover.h>
 #include <PMMR/Common/LeafSet.h>
 
-TEST_CASE("LeafSet")
+TEST_CASE("LeafSet::Rank")
 {
-    // TODO: Implement
+	const fs::path leafSetDir = fs::temp_directory_path() / "LeafSetRank";
+	FileRemover remover(leafSetDir);
+	FileUtil::CreateDirectories(leafSetDir);
+
+	auto pLeafSet = LeafSet::Load(leafSetDir / "pmmr_leafset.bin");
+
+	// Every 3rd leaf is unspent, and most leaves between 1000 and 5000 are spent.
+	std::vector<uint64_t> unspent;
+	for (uint64_t leafIndex = 0; leafIndex < 6000; leafIndex += 3)
+	{
+		if (leafIndex < 1000 || leafIndex >= 5000 || leafIndex == 3000)
+		{
+			pLeafSet->Add(leafIndex);
+			unspent.push_back(leafIndex);
+		}
+	}
+
+	pLeafSet->Commit();
+
+	for (size_t i = 0; i < unspent.size(); i++)
+	{
+		REQUIRE(pLeafSet->Rank(unspent[i]) == i);
+		REQUIRE(pLeafSet->Rank(unspent[i] + 1) == i + 1);
+		REQUIRE(pLeafSet->Select(i) == unspent[i]);
+	}
+
+	REQUIRE(pLeafSet->Select(unspent.size()) == UINT64_MAX);
+
+	REQUIRE(pLeafSet->GetUnspentLeaves(998, 6000, 3) == std::vector<uint64_t>({ 999, 3000, 5001 }));
+	REQUIRE(pLeafSet->GetUnspentLeaves(5997, 6000, 10) == std::vector<uint64_t>({ 5997 }));
+	REQUIRE(pLeafSet->GetUnspentLeaves(5998, 6000, 10).empty());
+
+	// Uncommitted changes are reflected.
+	pLeafSet->Remove(3000);
+	pLeafSet->Add(4000);
+	REQUIRE(pLeafSet->Rank(5001) == pLeafSet->Rank(1000) + 1);
+	REQUIRE(pLeafSet->GetUnspentLeaves(1000, 6000, 2) == std::vector<uint64_t>({ 4000, 5001 }));
+
+	pLeafSet->Rollback();
+	REQUIRE(pLeafSet->GetUnspentLeaves(1000, 6000, 2) == std::vector<uint64_t>({ 3000, 5001 }));
 }
\ No newline at end of file
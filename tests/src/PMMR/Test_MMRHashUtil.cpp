@@ -0,0 +1,93 @@
+#include <catch.hpp>
+
+#include <Core/File/FileRemover.h>
+#include <PMMR/Common/MMRHashUtil.h>
+#include <PMMR/Common/MMRUtil.h>
+
+TEST_CASE("MMRHashUtil::Root - PeakCache")
+{
+	const fs::path path = fs::temp_directory_path() / "peak_cache.bin";
+	FileUtil::RemoveFile(path);
+	FileRemover remover(path);
+
+	std::shared_ptr<HashFile> pHashFile = HashFile::Load(path);
+	PeakCache peakCache;
+
+	std::vector<uint64_t> sizes;
+	for (unsigned char i = 0; i < 100; i++)
+	{
+		MMRHashUtil::AddHashes(pHashFile, { i, 1, 2, 3 }, nullptr, peakCache);
+		sizes.push_back(pHashFile->GetSize());
+
+		REQUIRE(peakCache.GetSize() == pHashFile->GetSize());
+		REQUIRE(peakCache.GetPeaks().size() == MMRUtil::GetPeakIndices(pHashFile->GetSize()).size());
+	}
+
+	// Roots at the tip and at earlier sizes must match the roots calculated from the hash file.
+	for (const uint64_t size : sizes)
+	{
+		REQUIRE(MMRHashUtil::Root(pHashFile, size, nullptr, peakCache) == MMRHashUtil::Root(pHashFile, size, nullptr));
+	}
+
+	// After a rewind, the reloaded peaks produce the same hashes as the file-based path.
+	pHashFile->Rewind(sizes[49]);
+	MMRHashUtil::LoadPeaks(pHashFile, pHashFile->GetSize(), nullptr, peakCache);
+
+	const fs::path expectedPath = fs::temp_directory_path() / "peak_cache_expected.bin";
+	FileUtil::RemoveFile(expectedPath);
+	FileRemover expectedRemover(expectedPath);
+
+	PeakCache emptyCache;
+	std::shared_ptr<HashFile> pExpected = HashFile::Load(expectedPath);
+	for (unsigned char i = 0; i < 50; i++)
+	{
+		MMRHashUtil::AddHashes(pExpected, { i, 1, 2, 3 }, nullptr);
+	}
+
+	for (unsigned char i = 50; i < 60; i++)
+	{
+		MMRHashUtil::AddHashes(pHashFile, { (unsigned char)(i + 100), 1, 2, 3 }, nullptr, peakCache);
+		MMRHashUtil::AddHashes(pExpected, { (unsigned char)(i + 100), 1, 2, 3 }, nullptr);
+		REQUIRE(MMRHashUtil::Root(pHashFile, pHashFile->GetSize(), nullptr, peakCache) == MMRHashUtil::Root(pExpected, pExpected->GetSize(), nullptr, emptyCache));
+	}
+}
+
+TEST_CASE("MMRHashUtil::AddHashes - Batch")
+{
+	const fs::path sequentialPath = fs::temp_directory_path() / "batch_sequential.bin";
+	const fs::path batchPath = fs::temp_directory_path() / "batch_parallel.bin";
+	FileUtil::RemoveFile(sequentialPath);
+	FileUtil::RemoveFile(batchPath);
+	FileRemover sequentialRemover(sequentialPath);
+	FileRemover batchRemover(batchPath);
+
+	std::shared_ptr<HashFile> pSequential = HashFile::Load(sequentialPath);
+	std::shared_ptr<HashFile> pBatch = HashFile::Load(batchPath);
+	PeakCache peakCache;
+
+	// Batches of varying sizes, starting at varying MMR sizes, must produce exactly the same hash file.
+	uint32_t leafIndex = 0;
+	for (const size_t batchSize : { 1, 2, 3, 7, 64, 1000, 5, 4096 })
+	{
+		std::vector<std::vector<unsigned char>> leaves;
+		for (size_t i = 0; i < batchSize; i++)
+		{
+			Serializer serializer;
+			serializer.Append<uint32_t>(leafIndex++);
+			const std::vector<unsigned char> leaf = serializer.GetBytes();
+			MMRHashUtil::AddHashes(pSequential, leaf, nullptr);
+			leaves.push_back(leaf);
+		}
+
+		MMRHashUtil::AddHashes(pBatch, leaves, nullptr, peakCache);
+
+		REQUIRE(pBatch->GetSize() == pSequential->GetSize());
+		std::vector<unsigned char> sequentialHashes;
+		std::vector<unsigned char> batchHashes;
+		pSequential->GetDataRange(0, pSequential->GetSize(), sequentialHashes);
+		pBatch->GetDataRange(0, pBatch->GetSize(), batchHashes);
+		REQUIRE(batchHashes == sequentialHashes);
+
+		REQUIRE(MMRHashUtil::Root(pBatch, pBatch->GetSize(), nullptr, peakCache) == MMRHashUtil::Root(pSequential, pSequential->GetSize(), nullptr));
+	}
+}
\ No newline at end of file
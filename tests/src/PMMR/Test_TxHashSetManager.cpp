@@ -0,0 +1,55 @@
+#include <catch.hpp>
+
+#include <TestHelper.h>
+
+#include <PMMR/TxHashSetManager.h>
+#include <Core/Exceptions/TxHashSetException.h>
+
+//
+// A TxHashSet that isn't backed by the MMR files, so it can't be snapshotted.
+//
+class FakeTxHashSet : public ITxHashSet
+{
+public:
+	std::unique_ptr<BlockSums> ValidateTxHashSet(const BlockHeader&, const IBlockChainServer&, SyncStatus&) final { return nullptr; }
+	void SaveOutputPositions(const Chain::CPtr&, std::shared_ptr<IBlockDB>) const final { }
+	bool IsValid(std::shared_ptr<const IBlockDB>, const Transaction&) const final { return false; }
+	bool ApplyBlock(std::shared_ptr<IBlockDB>, const FullBlock&) final { return false; }
+	bool ValidateRoots(const BlockHeader&) const final { return false; }
+	TxHashSetRoots GetRoots(const std::shared_ptr<const IBlockDB>&, const TransactionBody&) final { throw std::runtime_error("Not implemented"); }
+	std::vector<Hash> GetLastKernelHashes(const uint64_t) const final { return {}; }
+	std::vector<Hash> GetLastOutputHashes(const uint64_t) const final { return {}; }
+	std::vector<Hash> GetLastRangeProofHashes(const uint64_t) const final { return {}; }
+	OutputRange GetOutputsByLeafIndex(std::shared_ptr<const IBlockDB>, const uint64_t, const uint64_t) const final { throw std::runtime_error("Not implemented"); }
+	std::vector<OutputDTO> GetOutputsByMMRIndex(std::shared_ptr<const IBlockDB>, const uint64_t, const uint64_t) const final { return {}; }
+	BlockHeaderPtr GetFlushedBlockHeader() const noexcept final { return nullptr; }
+	void Rewind(std::shared_ptr<IBlockDB>, const BlockHeader&) final { }
+	void Journal(CommitJournal&) const final { }
+	void Commit() final { }
+	void Rollback() noexcept final { }
+	void Compact() final { }
+};
+
+TEST_CASE("TxHashSetManager::SaveSnapshot - Unsupported TxHashSet")
+{
+	ConfigPtr pConfig = TestHelper::GetTestConfig();
+	BlockHeaderPtr pHeader = pConfig->GetEnvironment().GetGenesisHeader();
+	const fs::path zipPath = fs::temp_directory_path() / "Snapshots" / StringUtil::Format("TxHashSet.{}.zip", pHeader->ShortHash());
+
+	TxHashSetManager manager(*pConfig);
+	REQUIRE_THROWS_AS(manager.SaveSnapshot(nullptr, pHeader), TxHashSetException);
+
+	// The error says why the snapshot failed, and no partial zip is left behind.
+	manager.SetTxHashSet(std::make_shared<FakeTxHashSet>());
+	try
+	{
+		manager.SaveSnapshot(nullptr, pHeader);
+		FAIL("Expected a TxHashSetException");
+	}
+	catch (const TxHashSetException& e)
+	{
+		REQUIRE(std::string(e.what()).find("not file-backed") != std::string::npos);
+	}
+
+	REQUIRE_FALSE(FileUtil::Exists(zipPath));
+}
\ No newline at end of file